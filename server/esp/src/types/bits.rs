@@ -1,7 +1,7 @@
 use crate::*;
 
 // N is the number of bytes, not bits.
-#[derive(Clone, Copy, Debug)]
+#[derive(Clone, Copy, Debug, PartialEq, Eq)]
 pub struct Bits<const N: usize> {
     buffer: [u8; N],
 }
@@ -1,8 +1,21 @@
 use crate::*;
 
-#[derive(Copy, Clone, Default, Debug)]
+#[derive(Copy, Clone, Default, Debug, PartialEq)]
 pub struct FiniteF32(f32);
 
+impl FiniteF32 {
+    /// returns `None` if the value is NaN or infinite
+    #[inline]
+    pub fn new(x: f32) -> Option<Self> {
+        x.is_finite().then_some(Self(x))
+    }
+
+    #[inline]
+    pub const fn get(self) -> f32 {
+        self.0
+    }
+}
+
 impl Encodable for FiniteF32 {
     fn encode(&self, buf: &mut ByteBuffer) {
         buf.write_f32(self.0);
@@ -55,7 +68,7 @@ impl Display for FiniteF32 {
     }
 }
 
-#[derive(Copy, Clone, Default, Debug)]
+#[derive(Copy, Clone, Default, Debug, PartialEq)]
 pub struct FiniteF64(f64);
 
 impl Encodable for FiniteF64 {
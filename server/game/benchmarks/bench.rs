@@ -1,8 +1,18 @@
 #![allow(clippy::wildcard_imports, clippy::cast_possible_truncation)]
 use criterion::{black_box, criterion_group, criterion_main, Criterion};
 use esp::{ByteBuffer, ByteReader};
-use globed_game_server::{data::*, make_uninit, managers::LevelManager, new_uninit};
+use globed_game_server::{
+    client::{compression, SessionChannel, SessionCipher},
+    data::*,
+    make_uninit,
+    managers::LevelManager,
+    new_uninit,
+};
 use globed_shared::{
+    crypto_box::{
+        aead::{AeadCore, AeadInPlace, OsRng},
+        ChaChaBox, SecretKey,
+    },
     generate_alphanum_string,
     rand::{self, Rng, RngCore},
 };
@@ -249,6 +259,77 @@ fn strings(c: &mut Criterion) {
     });
 }
 
-// criterion_group!(benches, buffers, structs, managers, read_value_array, strings);
-criterion_group!(benches, strings);
+fn crypto(c: &mut Criterion) {
+    let server_key = SecretKey::generate(&mut OsRng);
+    let client_key = SecretKey::generate(&mut OsRng);
+    let server_box = ChaChaBox::new(&client_key.public_key(), &server_key);
+    let client_box = ChaChaBox::new(&server_key.public_key(), &client_key);
+
+    let mut seed = [0u8; SessionCipher::SEED_SIZE];
+    rand::thread_rng().fill_bytes(&mut seed);
+    let mut server_session = SessionCipher::new_server(&seed);
+    let mut client_session = SessionCipher::new_client(&seed);
+
+    // roughly player data, a room list and a voice frame
+    for size in [64usize, 512, 4096] {
+        let mut data = vec![0u8; SessionCipher::PREFIX_SIZE + size];
+        rand::thread_rng().fill_bytes(&mut data);
+
+        c.bench_function(&format!("chacha-box-{size}"), |b| {
+            b.iter(black_box(|| {
+                let nonce = ChaChaBox::generate_nonce(&mut OsRng);
+                let tag = server_box.encrypt_in_place_detached(&nonce, b"", &mut data[..size]).unwrap();
+                client_box.decrypt_in_place_detached(&nonce, b"", &mut data[..size], &tag).unwrap();
+            }));
+        });
+
+        c.bench_function(&format!("session-cipher-{size}"), |b| {
+            b.iter(black_box(|| {
+                server_session.encrypt(SessionChannel::Udp, &mut data).unwrap();
+                client_session.decrypt(SessionChannel::Udp, &mut data).unwrap();
+            }));
+        });
+    }
+}
+
+fn list_compression(c: &mut Criterion) {
+    // roughly what a busy server sends, usernames and icons repeat a lot but are not identical
+    let players = (0..2000)
+        .map(|i| PlayerPreviewAccountData {
+            account_id: rand::thread_rng().gen_range(1..30_000_000),
+            user_id: rand::thread_rng().gen_range(1..250_000_000),
+            name: InlineString::new(&generate_alphanum_string(rand::thread_rng().gen_range(3..16))),
+            icons: PlayerIconDataSimple {
+                cube: rand::thread_rng().gen_range(1..150),
+                color1: rand::thread_rng().gen_range(0..20),
+                color2: rand::thread_rng().gen_range(0..20),
+                glow_color: if i % 3 == 0 { 12 } else { 3 },
+            },
+            special_user_data: SpecialUserData { roles: None },
+        })
+        .collect::<Vec<_>>();
+
+    let mut raw = ByteBuffer::new();
+    raw.write_value(&GlobalPlayerListPacket { players });
+    let raw = raw.as_bytes();
+
+    let mut compressed = Vec::new();
+    compression::compress_into(raw, &mut compressed);
+    println!("global player list: {} bytes, compressed {} bytes", raw.len(), compressed.len());
+
+    c.bench_function("list-compress", |b| {
+        let mut out = Vec::with_capacity(raw.len());
+        b.iter(black_box(|| {
+            out.clear();
+            compression::compress_into(raw, &mut out);
+        }));
+    });
+
+    c.bench_function("list-decompress", |b| {
+        b.iter(black_box(|| compression::decompress(&compressed).unwrap()));
+    });
+}
+
+// criterion_group!(benches, buffers, structs, managers, read_value_array, strings, crypto, list_compression);
+criterion_group!(benches, strings, crypto, list_compression);
 criterion_main!(benches);
@@ -0,0 +1,56 @@
+use globed_shared::lz4_flex::block;
+
+/// unencrypted TCP packets at least this big are compressed, anything smaller rarely shrinks enough to be worth it
+pub const COMPRESSION_THRESHOLD: usize = 1024;
+/// the client refuses to decompress anything bigger than this
+pub const MAX_DECOMPRESSED_SIZE: usize = 2 << 20;
+
+const SIZE_PREFIX: usize = std::mem::size_of::<u32>();
+
+/// Compresses `data` and appends it to `out`.
+/// Returns `false` and leaves `out` untouched if the data wouldn't get any smaller, in which case it should be sent as is.
+///
+/// Format - uncompressed size (u32, big endian) -> LZ4 block
+pub fn compress_into(data: &[u8], out: &mut Vec<u8>) -> bool {
+    if data.len() > MAX_DECOMPRESSED_SIZE {
+        return false;
+    }
+
+    let start = out.len();
+    let block_start = start + SIZE_PREFIX;
+
+    out.extend_from_slice(&(data.len() as u32).to_be_bytes());
+    out.resize(block_start + block::get_maximum_output_size(data.len()), 0);
+
+    match block::compress_into(data, &mut out[block_start..]) {
+        Ok(written) if SIZE_PREFIX + written < data.len() => {
+            out.truncate(block_start + written);
+            true
+        }
+        _ => {
+            out.truncate(start);
+            false
+        }
+    }
+}
+
+/// Inverse of `compress_into`, the server never receives compressed packets so this is only useful for tests and benchmarks.
+pub fn decompress(data: &[u8]) -> Option<Vec<u8>> {
+    if data.len() < SIZE_PREFIX {
+        return None;
+    }
+
+    let mut size = [0u8; SIZE_PREFIX];
+    size.copy_from_slice(&data[..SIZE_PREFIX]);
+    let size = u32::from_be_bytes(size) as usize;
+
+    if size > MAX_DECOMPRESSED_SIZE {
+        return None;
+    }
+
+    let mut out = vec![0u8; size];
+    match block::decompress_into(&data[SIZE_PREFIX..], &mut out) {
+        Ok(written) if written == size => Some(out),
+        _ => None,
+    }
+}
@@ -0,0 +1,98 @@
+use globed_shared::IntMap;
+
+use crate::{
+    data::*,
+    managers::LevelManagerPlayer,
+    util::SnapshotHistory,
+};
+
+/// Per-client state used for sending delta-encoded `LevelDataDeltaPacket`s.
+///
+/// Every sent packet is remembered along with the snapshots of other players it contained.
+/// Once the client acknowledges a packet, those snapshots become the baselines for the next deltas.
+/// If a baseline is missing on either side, a keyframe is sent instead.
+#[derive(Default)]
+pub struct DeltaSyncState {
+    last_sent_seq: u32,
+    /// (account id, snapshot sequence number) of every player written into each recently sent packet
+    sent: SnapshotHistory<Vec<(i32, u32)>, DELTA_HISTORY_SIZE>,
+    /// for every player, the newest snapshot that this client has confirmed receiving
+    acked: IntMap<i32, u32>,
+    /// set when a delta from this client could not be applied, cleared once the client is told about it
+    pub upstream_needs_keyframe: bool,
+    /// reused between packets, so that building a response doesn't allocate every tick
+    pub scratch: Vec<AssociatedPlayerDataDelta>,
+}
+
+impl DeltaSyncState {
+    /// process the acknowledgements from a `PlayerDataDeltaPacket`
+    pub fn process_acks(&mut self, ack: u32, ack_bits: u32) {
+        // oldest first, so that snapshots from newer packets override older ones
+        for n in (0..32u32).rev() {
+            if ack_bits & (1 << n) != 0 {
+                self.ack_packet(ack.wrapping_sub(1 + n));
+            }
+        }
+
+        self.ack_packet(ack);
+    }
+
+    fn ack_packet(&mut self, seq: u32) {
+        if seq == 0 {
+            return;
+        }
+
+        // taking the entry also makes sure that a packet is only ever processed once
+        if let Some(entries) = self.sent.take(seq) {
+            for (account_id, snapshot) in entries {
+                self.acked.insert(account_id, snapshot);
+            }
+        }
+    }
+
+    /// forget all acknowledged baselines, every player gets sent as a keyframe next time
+    pub fn reset(&mut self) {
+        self.sent.clear();
+        self.acked.clear();
+    }
+
+    /// encode the player's current data relative to the newest snapshot of them that the client has acknowledged
+    pub fn encode_player(&self, player: &LevelManagerPlayer) -> AssociatedPlayerDataDelta {
+        let seq = player.history.latest();
+
+        // players that don't use delta encoding have no history, and are always sent as keyframes with seq 0
+        let baseline = if seq == 0 {
+            None
+        } else {
+            self.acked
+                .get(&player.account_id)
+                .filter(|&&b| b <= seq && seq - b <= u32::from(u8::MAX))
+                .and_then(|&b| player.history.get(b).map(|data| (b, data)))
+        };
+
+        match baseline {
+            Some((b, data)) => AssociatedPlayerDataDelta {
+                account_id: player.account_id,
+                seq,
+                baseline_offset: (seq - b) as u8,
+                delta: PlayerDataDelta::diff(&player.data, Some(data)),
+            },
+            None => AssociatedPlayerDataDelta {
+                account_id: player.account_id,
+                seq,
+                baseline_offset: 0,
+                delta: PlayerDataDelta::diff(&player.data, None),
+            },
+        }
+    }
+
+    /// allocate a sequence number for a new packet and remember which snapshots it contains
+    pub fn record_sent(&mut self, players: &[AssociatedPlayerDataDelta]) -> u32 {
+        self.last_sent_seq = self.last_sent_seq.wrapping_add(1).max(1);
+
+        let snapshots = players.iter().filter(|p| p.seq != 0).map(|p| (p.account_id, p.seq)).collect();
+        self.sent.push(self.last_sent_seq, snapshots);
+
+        self.last_sent_seq
+    }
+}
@@ -12,6 +12,7 @@ pub enum PacketHandlingError {
     MalformedMessage,                      // packet is missing a header
     MalformedLoginAttempt,                 // LoginPacket with cleartext credentials
     MalformedCiphertext,                   // missing nonce/mac in the encrypted ciphertext
+    ReplayedPacket,                        // encrypted packet with a sequence number that was already received
     MalformedPacketStructure(DecodeError), // failed to decode the packet
     NoHandler(u16),                        // no handler found for this packet ID
     WebRequestError(reqwest::Error),       // error making a web request to the central server
@@ -76,6 +77,7 @@ impl Display for PacketHandlingError {
             Self::EncryptionError => f.write_str("Encryption failed"),
             Self::DecryptionError => f.write_str("Decryption failed"),
             Self::MalformedCiphertext => f.write_str("malformed ciphertext in an encrypted packet"),
+            Self::ReplayedPacket => f.write_str("encrypted packet was replayed or is too old"),
             Self::MalformedMessage => f.write_str("malformed message structure"),
             Self::MalformedLoginAttempt => f.write_str("malformed login attempt"),
             Self::MalformedPacketStructure(err) => f.write_fmt(format_args!("could not decode a packet: {err}")),
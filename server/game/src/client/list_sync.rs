@@ -0,0 +1,104 @@
+use std::hash::{Hash, Hasher};
+
+use rustc_hash::{FxHashMap, FxHasher};
+
+use crate::data::*;
+
+/// Per-client state used for sending incremental lists (`RoomPlayerListDeltaPacket` and `LevelListDeltaPacket`).
+///
+/// Remembers a hash of every entry in the last list sent to the client, so that the next response only carries
+/// the entries that were added or changed since, and the keys of the ones that are gone.
+/// The client sends back the version it has, and if that isn't the last one sent (or the list now belongs to a different room),
+/// the whole list is sent again.
+pub struct ListSyncState<K> {
+    version: u32,
+    scope: u32,
+    /// key -> hash of the encoded entry, as of `version`
+    entries: FxHashMap<K, u64>,
+    /// swapped with `entries` on every diff, so that the maps keep their capacity
+    next: FxHashMap<K, u64>,
+    scratch: Vec<u8>,
+}
+
+/// Result of `ListSyncState::diff`
+pub struct ListDiff<K> {
+    /// version the changes apply on top of, 0 if the client has to throw away its list first
+    pub base_version: u32,
+    pub version: u32,
+    /// indices of the items that are new or have changed
+    pub changed: Vec<usize>,
+    pub removed: Vec<K>,
+}
+
+impl<K: Copy + Eq + Hash> Default for ListSyncState<K> {
+    fn default() -> Self {
+        Self {
+            version: 0,
+            scope: 0,
+            entries: FxHashMap::default(),
+            next: FxHashMap::default(),
+            scratch: Vec::new(),
+        }
+    }
+}
+
+impl<K: Copy + Eq + Hash> ListSyncState<K> {
+    /// Compare `items` with the list that was last sent and remember them as the new version.
+    /// `scope` identifies what the list belongs to (i.e. the room id), changing it always forces a full list.
+    pub fn diff<T: Encodable + StaticSize>(
+        &mut self,
+        client_version: u32,
+        scope: u32,
+        items: &[T],
+        key: impl Fn(&T) -> K,
+    ) -> ListDiff<K> {
+        let base_version = if client_version != 0 && client_version == self.version && scope == self.scope {
+            client_version
+        } else {
+            self.entries.clear();
+            0
+        };
+
+        if self.scratch.len() < T::ENCODED_SIZE {
+            self.scratch.resize(T::ENCODED_SIZE, 0);
+        }
+
+        self.next.clear();
+
+        let mut changed = Vec::new();
+
+        for (idx, item) in items.iter().enumerate() {
+            let key = key(item);
+            let hash = self.hash_item(item);
+
+            if self.entries.get(&key) != Some(&hash) {
+                changed.push(idx);
+            }
+
+            self.next.insert(key, hash);
+        }
+
+        let removed = self.entries.keys().filter(|key| !self.next.contains_key(key)).copied().collect();
+
+        std::mem::swap(&mut self.entries, &mut self.next);
+        self.scope = scope;
+        // 0 means "no list", so skip it when wrapping around
+        self.version = self.version.checked_add(1).unwrap_or(1);
+
+        ListDiff {
+            base_version,
+            version: self.version,
+            changed,
+            removed,
+        }
+    }
+
+    fn hash_item<T: Encodable + StaticSize>(&mut self, item: &T) -> u64 {
+        let mut buf = FastByteBuffer::new(&mut self.scratch[..T::ENCODED_SIZE]);
+        buf.write_value(item);
+
+        let mut hasher = FxHasher::default();
+        buf.as_bytes().hash(&mut hasher);
+        hasher.finish()
+    }
+}
@@ -1,13 +1,22 @@
+pub mod compression;
+pub mod delta;
 pub mod error;
+pub mod list_sync;
 pub mod macros;
+pub mod session;
 pub mod socket;
 pub mod state;
+pub mod subscriptions;
 pub mod thread;
 pub mod unauthorized;
 
+pub use delta::DeltaSyncState;
 pub use error::{PacketHandlingError, Result};
+pub use list_sync::{ListDiff, ListSyncState};
 pub use macros::*;
-pub use socket::ClientSocket;
+pub use session::{SessionChannel, SessionCipher};
+pub use socket::{ClientSocket, SEALED_SEED_SIZE};
 pub use state::{AtomicClientThreadState, ClientThreadState};
+pub use subscriptions::PlayerCountSubscriptions;
 pub use thread::{ClientThread, ServerThreadMessage};
 pub use unauthorized::{UnauthorizedThread, UnauthorizedThreadOutcome};
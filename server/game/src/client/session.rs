@@ -0,0 +1,183 @@
+use globed_shared::{
+    crypto_secretbox::{aead::AeadInPlace, KeyInit, XChaCha20Poly1305},
+    hmac::{Hmac, Mac},
+    sha2::Sha256,
+};
+
+use super::error::{PacketHandlingError, Result};
+
+// must match the labels used by the client
+const CLIENT_KEY_LABEL: &[u8] = b"globed session c2s";
+const SERVER_KEY_LABEL: &[u8] = b"globed session s2c";
+
+const NONCE_SIZE: usize = 24;
+
+#[derive(Clone, Copy)]
+#[repr(u8)]
+pub enum SessionChannel {
+    Tcp = 0,
+    Udp = 1,
+}
+
+/// Symmetric cipher used for all encrypted packets once the handshake is done (since `SESSION_CIPHER_PROTOCOL`).
+///
+/// The server generates a random seed and sends it to the client sealed with the `ChaChaBox`, then both sides derive
+/// one key per direction with HMAC-SHA256. Since every key only ever has one sender, the nonce is just the channel and a counter,
+/// and only the 4-byte counter goes on the wire instead of a 24-byte random nonce.
+///
+/// Format - seq (u32, big endian) -> mac -> data
+pub struct SessionCipher {
+    tx: XChaCha20Poly1305,
+    rx: XChaCha20Poly1305,
+    tx_seq: [u32; 2],
+    rx_window: [ReplayWindow; 2],
+}
+
+impl SessionCipher {
+    pub const SEED_SIZE: usize = 32;
+    pub const SEQ_SIZE: usize = 4;
+    pub const MAC_SIZE: usize = 16;
+    pub const PREFIX_SIZE: usize = Self::SEQ_SIZE + Self::MAC_SIZE;
+
+    pub fn new_server(seed: &[u8; Self::SEED_SIZE]) -> Self {
+        Self::new(seed, SERVER_KEY_LABEL, CLIENT_KEY_LABEL)
+    }
+
+    /// the client's end of the session, only useful for tests and benchmarks
+    pub fn new_client(seed: &[u8; Self::SEED_SIZE]) -> Self {
+        Self::new(seed, CLIENT_KEY_LABEL, SERVER_KEY_LABEL)
+    }
+
+    fn new(seed: &[u8; Self::SEED_SIZE], tx_label: &[u8], rx_label: &[u8]) -> Self {
+        Self {
+            tx: XChaCha20Poly1305::new(&derive_key(seed, tx_label).into()),
+            rx: XChaCha20Poly1305::new(&derive_key(seed, rx_label).into()),
+            tx_seq: [0; 2],
+            rx_window: [ReplayWindow::new(true), ReplayWindow::new(false)],
+        }
+    }
+
+    /// Encrypts `message[PREFIX_SIZE..]` in place and writes the sequence number and the mac in front of it.
+    pub fn encrypt(&mut self, channel: SessionChannel, message: &mut [u8]) -> Result<()> {
+        if message.len() < Self::PREFIX_SIZE {
+            return Err(PacketHandlingError::EncryptionError);
+        }
+
+        let seq = &mut self.tx_seq[channel as usize];
+
+        // a nonce must never repeat, the client reconnects and gets a new session long before this happens
+        *seq = seq.checked_add(1).ok_or(PacketHandlingError::EncryptionError)?;
+        let seq = *seq;
+
+        let (prefix, data) = message.split_at_mut(Self::PREFIX_SIZE);
+
+        let tag = self
+            .tx
+            .encrypt_in_place_detached(&make_nonce(channel, seq).into(), b"", data)
+            .map_err(|_| PacketHandlingError::EncryptionError)?;
+
+        prefix[..Self::SEQ_SIZE].copy_from_slice(&seq.to_be_bytes());
+        prefix[Self::SEQ_SIZE..].copy_from_slice(&tag);
+
+        Ok(())
+    }
+
+    /// Decrypts the message in place and returns the plaintext. Fails if the message was forged, or was already received.
+    pub fn decrypt<'a>(&mut self, channel: SessionChannel, message: &'a mut [u8]) -> Result<&'a [u8]> {
+        if message.len() < Self::PREFIX_SIZE {
+            return Err(PacketHandlingError::MalformedCiphertext);
+        }
+
+        let (prefix, data) = message.split_at_mut(Self::PREFIX_SIZE);
+
+        let mut seq = [0u8; Self::SEQ_SIZE];
+        seq.copy_from_slice(&prefix[..Self::SEQ_SIZE]);
+        let seq = u32::from_be_bytes(seq);
+
+        let window = &mut self.rx_window[channel as usize];
+        if !window.check(seq) {
+            return Err(PacketHandlingError::ReplayedPacket);
+        }
+
+        let mut tag = [0u8; Self::MAC_SIZE];
+        tag.copy_from_slice(&prefix[Self::SEQ_SIZE..]);
+
+        self.rx
+            .decrypt_in_place_detached(&make_nonce(channel, seq).into(), b"", data, &tag.into())
+            .map_err(|_| PacketHandlingError::DecryptionError)?;
+
+        // only move the window once we know the packet is genuine, otherwise anyone could push it forward
+        window.accept(seq);
+
+        Ok(data)
+    }
+}
+
+fn derive_key(seed: &[u8], label: &[u8]) -> [u8; 32] {
+    // hmac accepts keys of any length, so this can't fail
+    let mut mac = Hmac::<Sha256>::new_from_slice(seed).unwrap();
+    mac.update(label);
+
+    let mut key = [0u8; 32];
+    key.copy_from_slice(&mac.finalize().into_bytes());
+    key
+}
+
+fn make_nonce(channel: SessionChannel, seq: u32) -> [u8; NONCE_SIZE] {
+    let mut nonce = [0u8; NONCE_SIZE];
+    nonce[0] = channel as u8;
+    nonce[1..5].copy_from_slice(&seq.to_be_bytes());
+    nonce
+}
+
+/// Tracks received sequence numbers. TCP is ordered, so an ordered window rejects anything not newer than the last accepted packet,
+/// while UDP packets may arrive out of order by up to `ReplayWindow::SIZE` packets.
+pub struct ReplayWindow {
+    ordered: bool,
+    highest: u32,
+    /// bit N is set if `highest - N` was received
+    seen: u64,
+}
+
+impl ReplayWindow {
+    pub const SIZE: u32 = 64;
+
+    pub const fn new(ordered: bool) -> Self {
+        Self {
+            ordered,
+            highest: 0,
+            seen: 0,
+        }
+    }
+
+    /// whether a packet with this sequence number could be accepted
+    pub fn check(&self, seq: u32) -> bool {
+        // sequence numbers start at 1
+        if seq == 0 {
+            return false;
+        }
+
+        if seq > self.highest {
+            return true;
+        }
+
+        if self.ordered {
+            return false;
+        }
+
+        let age = self.highest - seq;
+        age < Self::SIZE && self.seen & (1u64 << age) == 0
+    }
+
+    /// mark the sequence number as received, must only be called once the packet is authenticated
+    pub fn accept(&mut self, seq: u32) {
+        if seq > self.highest {
+            let shift = seq - self.highest;
+            self.seen = if shift >= Self::SIZE { 0 } else { self.seen << shift };
+            self.seen |= 1;
+            self.highest = seq;
+        } else {
+            self.seen |= 1u64 << (self.highest - seq);
+        }
+    }
+}
@@ -16,12 +16,15 @@ use globed_shared::{
         aead::{AeadCore, AeadInPlace, OsRng},
         ChaChaBox,
     },
+    rand::RngCore,
     trace,
 };
 
 use super::{
+    compression::{self, COMPRESSION_THRESHOLD},
     error::{PacketHandlingError, Result},
     macros::*,
+    session::{SessionChannel, SessionCipher},
 };
 use crate::{data::*, server::GameServer};
 
@@ -31,12 +34,18 @@ pub struct ClientSocket {
     pub tcp_peer: SocketAddrV4,
     pub udp_peer: Option<SocketAddrV4>,
     crypto_box: OnceLock<ChaChaBox>,
+    /// replaces `crypto_box` after the handshake, if the client supports it
+    session: Option<SessionCipher>,
+    /// whether big packets can be sent compressed, see `send_packet_compressed`
+    compression: bool,
     game_server: &'static GameServer,
 }
 
 // do not touch those, encryption related
 const NONCE_SIZE: usize = 24;
 const MAC_SIZE: usize = 16;
+/// size of the session seed in the handshake response, encrypted with the `ChaChaBox`
+pub const SEALED_SEED_SIZE: usize = NONCE_SIZE + MAC_SIZE + SessionCipher::SEED_SIZE;
 
 const MAX_PACKET_SIZE: usize = 65536;
 pub const INLINE_BUFFER_SIZE: usize = 164;
@@ -48,6 +57,8 @@ impl ClientSocket {
             tcp_peer,
             udp_peer: None,
             crypto_box: OnceLock::new(),
+            session: None,
+            compression: false,
             game_server,
         }
     }
@@ -101,11 +112,49 @@ impl ClientSocket {
         Ok(())
     }
 
+    /// Generates a new session seed, switches to `SessionCipher` and returns the seed encrypted with the crypto box,
+    /// so that it can be sent to the client in the handshake response.
+    pub fn init_session(&mut self) -> Result<[u8; SEALED_SEED_SIZE]> {
+        let cbox = self.crypto_box.get().ok_or(PacketHandlingError::WrongCryptoBoxState)?;
+
+        if self.session.is_some() {
+            return Err(PacketHandlingError::WrongCryptoBoxState);
+        }
+
+        let mut seed = [0u8; SessionCipher::SEED_SIZE];
+        OsRng.fill_bytes(&mut seed);
+
+        let mut sealed = [0u8; SEALED_SEED_SIZE];
+        let (prefix, data) = sealed.split_at_mut(NONCE_SIZE + MAC_SIZE);
+        data.copy_from_slice(&seed);
+
+        let nonce = ChaChaBox::generate_nonce(&mut OsRng);
+        let tag = cbox
+            .encrypt_in_place_detached(&nonce, b"", data)
+            .map_err(|_| PacketHandlingError::EncryptionError)?;
+
+        prefix[..NONCE_SIZE].copy_from_slice(&nonce);
+        prefix[NONCE_SIZE..].copy_from_slice(&tag);
+
+        self.session = Some(SessionCipher::new_server(&seed));
+
+        Ok(sealed)
+    }
+
+    pub fn enable_compression(&mut self) {
+        self.compression = true;
+    }
+
     pub fn set_udp_peer(&mut self, udp_peer: SocketAddrV4) {
         self.udp_peer.replace(udp_peer);
     }
 
-    pub fn decrypt<'a>(&self, message: &'a mut [u8]) -> Result<ByteReader<'a>> {
+    pub fn decrypt<'a>(&mut self, message: &'a mut [u8], channel: SessionChannel) -> Result<ByteReader<'a>> {
+        if let Some(session) = self.session.as_mut() {
+            let plaintext = session.decrypt(channel, &mut message[PacketHeader::SIZE..])?;
+            return Ok(ByteReader::from_bytes(plaintext));
+        }
+
         if message.len() < PacketHeader::SIZE + NONCE_SIZE + MAC_SIZE {
             return Err(PacketHandlingError::MalformedCiphertext);
         }
@@ -167,6 +216,47 @@ impl ClientSocket {
         self.send_packet_alloca(packet, packet.encoded_size()).await
     }
 
+    /// version of `send_packet_dynamic` for big list packets, which are mostly repeated names and icons.
+    /// if the client supports it and the packet is big enough, the packet body is compressed and `PacketHeader::FLAG_COMPRESSED` is set.
+    /// only unencrypted TCP packets are ever compressed, anything else is passed to `send_packet_dynamic`.
+    pub async fn send_packet_compressed<P: Packet + Encodable + DynamicSize>(&mut self, packet: &P) -> Result<()> {
+        let packet_size = packet.encoded_size();
+
+        if !self.compression || P::ENCRYPTED || !P::SHOULD_USE_TCP || packet_size < COMPRESSION_THRESHOLD {
+            return self.send_packet_dynamic(packet).await;
+        }
+
+        // these packets can be hundreds of kilobytes, too big for alloca
+        let mut raw = vec![0u8; packet_size];
+        let mut buf = FastByteBuffer::new(&mut raw);
+        buf.write_value(packet);
+        let raw_len = buf.len();
+
+        let header_end = size_of_types!(u32) + PacketHeader::SIZE;
+        let mut data = Vec::with_capacity(header_end + raw_len);
+        data.resize(header_end, 0);
+
+        let compressed = compression::compress_into(&raw[..raw_len], &mut data);
+        if !compressed {
+            data.extend_from_slice(&raw[..raw_len]);
+        }
+
+        if cfg!(debug_assertions) {
+            self.print_packet::<P>(true, Some(if compressed { "compressed" } else { "incompressible" }));
+        }
+
+        // length prefix, then the header with the flags byte in place of `encrypted`
+        let packet_len = (data.len() - size_of_types!(u32)) as u32;
+        data[..size_of_types!(u32)].copy_from_slice(&packet_len.to_be_bytes());
+        data[size_of_types!(u32)..size_of_types!(u32, u16)].copy_from_slice(&P::PACKET_ID.to_be_bytes());
+        data[header_end - 1] = if compressed { PacketHeader::FLAG_COMPRESSED } else { 0 };
+
+        self.send_buffer_tcp(&data).await?;
+        self.socket.flush().await?;
+
+        Ok(())
+    }
+
     /// use alloca to encode the packet on the stack, and try a non-blocking send, on failure clones to a Vec and a blocking send.
     /// be very careful if using this directly, miscalculating the size may cause a runtime panic.
     #[inline]
@@ -193,9 +283,9 @@ impl ClientSocket {
             // gs_inline_encode! doesn't work here because the borrow checker is silly :(
             let header_start = if P::SHOULD_USE_TCP { size_of_types!(u32) } else { 0usize };
 
-            let nonce_start = header_start + PacketHeader::SIZE;
-            let mac_start = nonce_start + NONCE_SIZE;
-            let raw_data_start = mac_start + MAC_SIZE;
+            let prefix_start = header_start + PacketHeader::SIZE;
+            let prefix_size = if self.session.is_some() { SessionCipher::PREFIX_SIZE } else { NONCE_SIZE + MAC_SIZE };
+            let raw_data_start = prefix_start + prefix_size;
             let total_size = raw_data_start + packet_size;
 
             gs_alloca_check_size!(total_size);
@@ -218,20 +308,30 @@ impl ClientSocket {
                 // if the written size isn't equal to `packet_size`, we use buffer length instead
                 let raw_data_end = raw_data_start + buf.len();
 
-                // this unwrap is safe, as an encrypted packet can only be sent downstream after the handshake is established.
-                let cbox = self.crypto_box.get().unwrap();
+                if let Some(session) = self.session.as_mut() {
+                    let channel = if P::SHOULD_USE_TCP { SessionChannel::Tcp } else { SessionChannel::Udp };
 
-                // encrypt in place
-                let nonce = ChaChaBox::generate_nonce(&mut OsRng);
-                let tag = cbox
-                    .encrypt_in_place_detached(&nonce, b"", &mut data[raw_data_start..raw_data_end])
-                    .map_err(|_| PacketHandlingError::EncryptionError)?;
+                    // encrypt in place, this also writes the sequence number and the mac tag
+                    session.encrypt(channel, &mut data[prefix_start..raw_data_end])?;
+                } else {
+                    let nonce_start = prefix_start;
+                    let mac_start = nonce_start + NONCE_SIZE;
+
+                    // this unwrap is safe, as an encrypted packet can only be sent downstream after the handshake is established.
+                    let cbox = self.crypto_box.get().unwrap();
 
-                // prepend the nonces
-                data[nonce_start..mac_start].copy_from_slice(nonce.as_slice());
+                    // encrypt in place
+                    let nonce = ChaChaBox::generate_nonce(&mut OsRng);
+                    let tag = cbox
+                        .encrypt_in_place_detached(&nonce, b"", &mut data[raw_data_start..raw_data_end])
+                        .map_err(|_| PacketHandlingError::EncryptionError)?;
 
-                // prepend the mac tag
-                data[mac_start..raw_data_start].copy_from_slice(&tag);
+                    // prepend the nonces
+                    data[nonce_start..mac_start].copy_from_slice(nonce.as_slice());
+
+                    // prepend the mac tag
+                    data[mac_start..raw_data_start].copy_from_slice(&tag);
+                }
 
                 if P::SHOULD_USE_TCP {
                     // write total packet length
@@ -0,0 +1,43 @@
+use rustc_hash::FxHashMap;
+
+use crate::data::*;
+
+/// Per-client set of levels whose player counts are pushed to the client (`SubscribePlayerCountsPacket`).
+///
+/// Every subscribed level remembers the count that was last sent, so that a push only contains the levels whose count changed.
+/// Newly subscribed levels have no count yet, and are always included in the next push.
+#[derive(Default)]
+pub struct PlayerCountSubscriptions {
+    levels: FxHashMap<LevelId, Option<u16>>,
+}
+
+impl PlayerCountSubscriptions {
+    /// replace the subscribed levels, keeping the last sent counts of the ones that stay subscribed
+    pub fn set(&mut self, level_ids: &[LevelId]) {
+        self.levels.retain(|level_id, _| level_ids.contains(level_id));
+
+        for &level_id in level_ids {
+            self.levels.entry(level_id).or_insert(None);
+        }
+    }
+
+    pub fn is_empty(&self) -> bool {
+        self.levels.is_empty()
+    }
+
+    /// compare the current counts with the ones last sent, return the ones that differ and remember them as sent
+    pub fn collect_changes(&mut self, current: impl Fn(LevelId) -> u16) -> Vec<(LevelId, u16)> {
+        let mut changed = Vec::new();
+
+        for (&level_id, sent) in &mut self.levels {
+            let count = current(level_id);
+
+            if *sent != Some(count) {
+                *sent = Some(count);
+                changed.push((level_id, count));
+            }
+        }
+
+        changed
+    }
+}
@@ -31,6 +31,8 @@ pub mod handlers;
 
 pub const INLINE_BUFFER_SIZE: usize = 164;
 pub const THREAD_MICRO_TIMEOUT: Duration = Duration::from_secs(30);
+/// how often subscribed player counts are checked for changes
+pub const PLAYER_COUNT_PUSH_INTERVAL: Duration = Duration::from_secs(2);
 
 #[derive(Clone)]
 pub enum ServerThreadMessage {
@@ -76,6 +78,10 @@ pub struct ClientThread {
     rate_limiter: LockfreeMutCell<SimpleRateLimiter>,
     voice_rate_limiter: LockfreeMutCell<SimpleRateLimiter>,
     chat_rate_limiter: Option<LockfreeMutCell<SimpleRateLimiter>>,
+    delta_sync: LockfreeMutCell<DeltaSyncState>,
+    room_list_sync: LockfreeMutCell<ListSyncState<i32>>,
+    level_list_sync: LockfreeMutCell<ListSyncState<LevelId>>,
+    count_subscriptions: LockfreeMutCell<PlayerCountSubscriptions>,
 
     pub destruction_notify: Arc<Notify>,
 }
@@ -138,6 +144,10 @@ impl ClientThread {
             rate_limiter: LockfreeMutCell::new(rate_limiter),
             voice_rate_limiter: LockfreeMutCell::new(voice_rate_limiter),
             chat_rate_limiter: chat_rate_limiter.map(LockfreeMutCell::new),
+            delta_sync: LockfreeMutCell::new(DeltaSyncState::default()),
+            room_list_sync: LockfreeMutCell::new(ListSyncState::default()),
+            level_list_sync: LockfreeMutCell::new(ListSyncState::default()),
+            count_subscriptions: LockfreeMutCell::new(PlayerCountSubscriptions::default()),
 
             destruction_notify: thread.destruction_notify,
         }
@@ -169,6 +179,7 @@ impl ClientThread {
 
     pub async fn run(&self) -> ClientThreadOutcome {
         let mut last_received_packet = Instant::now();
+        let mut next_count_push = Instant::now() + PLAYER_COUNT_PUSH_INTERVAL;
 
         loop {
             let state = self.connection_state.load();
@@ -185,6 +196,8 @@ impl ClientThread {
                 break self.terminate();
             }
 
+            let has_count_subscriptions = !unsafe { self.count_subscriptions.get() }.is_empty();
+
             tokio::select! {
                 message = self.poll_for_messages() => {
                     if let Some(message) = message {
@@ -226,6 +239,15 @@ impl ClientThread {
                     }
                 },
 
+                () = tokio::time::sleep_until(next_count_push), if has_count_subscriptions => {
+                    next_count_push = Instant::now() + PLAYER_COUNT_PUSH_INTERVAL;
+
+                    match self.push_player_counts().await {
+                        Ok(()) => {}
+                        Err(e) => self.print_error(&e),
+                    }
+                }
+
                 () = tokio::time::sleep(THREAD_MICRO_TIMEOUT) => {
                     continue;
                 }
@@ -360,14 +382,16 @@ impl ClientThread {
     async fn recv_and_handle(&self, message_size: usize) -> Result<()> {
         // safety: only we can receive data from our client.
         let socket = unsafe { self.socket.get_mut() };
-        socket.recv_and_handle(message_size, async |buf| self.handle_packet(buf).await).await
+        socket
+            .recv_and_handle(message_size, async |buf| self.handle_packet(buf, SessionChannel::Tcp).await)
+            .await
     }
 
     /// handle a message sent from the `GameServer`
     async fn handle_message(&self, message: ServerThreadMessage) -> Result<()> {
         match message {
-            ServerThreadMessage::Packet(mut packet) => self.handle_packet(&mut packet).await?,
-            ServerThreadMessage::SmallPacket((mut packet, len)) => self.handle_packet(&mut packet[..len]).await?,
+            ServerThreadMessage::Packet(mut packet) => self.handle_packet(&mut packet, SessionChannel::Udp).await?,
+            ServerThreadMessage::SmallPacket((mut packet, len)) => self.handle_packet(&mut packet[..len], SessionChannel::Udp).await?,
             ServerThreadMessage::BroadcastText(text_packet) => self.send_packet_static(&text_packet).await?,
             ServerThreadMessage::BroadcastVoice(voice_packet) => self.send_packet_dynamic(&*voice_packet).await?,
             ServerThreadMessage::BroadcastNotice(packet) => {
@@ -394,8 +418,8 @@ impl ClientThread {
         Ok(())
     }
 
-    /// handle an incoming packet
-    async fn handle_packet(&self, message: &mut [u8]) -> Result<()> {
+    /// handle an incoming packet, `channel` is the socket it was received on
+    async fn handle_packet(&self, message: &mut [u8], channel: SessionChannel) -> Result<()> {
         #[cfg(debug_assertions)]
         if message.len() < PacketHeader::SIZE {
             return Err(PacketHandlingError::MalformedMessage);
@@ -411,7 +435,9 @@ impl ClientThread {
         let header = data.read_packet_header()?;
 
         // by far the most common packet, so we try it early
-        if header.packet_id == PlayerDataPacket::PACKET_ID {
+        if header.packet_id == PlayerDataDeltaPacket::PACKET_ID {
+            return self.handle_player_data_delta(&mut data).await;
+        } else if header.packet_id == PlayerDataPacket::PACKET_ID {
             return self.handle_player_data(&mut data).await;
         }
 
@@ -426,7 +452,7 @@ impl ClientThread {
 
         // decrypt the packet in-place if encrypted
         if header.encrypted {
-            data = unsafe { self.socket.get_mut() }.decrypt(message)?;
+            data = unsafe { self.socket.get_mut() }.decrypt(message, channel)?;
         }
 
         match header.packet_id {
@@ -443,12 +469,15 @@ impl ClientThread {
             RequestLevelListPacket::PACKET_ID => self.handle_request_level_list(&mut data).await,
             RequestPlayerCountPacket::PACKET_ID => self.handle_request_player_count(&mut data).await,
             UpdatePlayerStatusPacket::PACKET_ID => self.handle_set_player_status(&mut data).await,
+            RequestLevelListDeltaPacket::PACKET_ID => self.handle_request_level_list_delta(&mut data).await,
+            SubscribePlayerCountsPacket::PACKET_ID => self.handle_subscribe_player_counts(&mut data).await,
 
             /* game related */
             RequestPlayerProfilesPacket::PACKET_ID => self.handle_request_profiles(&mut data).await,
             LevelJoinPacket::PACKET_ID => self.handle_level_join(&mut data).await,
             LevelLeavePacket::PACKET_ID => self.handle_level_leave(&mut data).await,
             PlayerDataPacket::PACKET_ID => self.handle_player_data(&mut data).await,
+            PlayerDataDeltaPacket::PACKET_ID => self.handle_player_data_delta(&mut data).await,
             VoicePacket::PACKET_ID => self.handle_voice(&mut data).await,
             ChatMessagePacket::PACKET_ID => self.handle_chat_message(&mut data).await,
 
@@ -462,6 +491,7 @@ impl ClientThread {
             RequestRoomListPacket::PACKET_ID => self.handle_request_room_list(&mut data).await,
             CloseRoomPacket::PACKET_ID => self.handle_close_room(&mut data).await,
             KickRoomPlayerPacket::PACKET_ID => self.handle_kick_room_player(&mut data).await,
+            RequestRoomPlayerListDeltaPacket::PACKET_ID => self.handle_request_room_players_delta(&mut data).await,
 
             /* admin related */
             AdminAuthPacket::PACKET_ID => self.handle_admin_auth(&mut data).await,
@@ -486,6 +516,11 @@ impl ClientThread {
         unsafe { self.socket.get_mut() }.send_packet_dynamic(packet).await
     }
 
+    #[inline]
+    async fn send_packet_compressed<P: Packet + Encodable + DynamicSize>(&self, packet: &P) -> Result<()> {
+        unsafe { self.socket.get_mut() }.send_packet_compressed(packet).await
+    }
+
     #[inline]
     #[allow(unused)]
     async fn send_packet_alloca<P: Packet + Encodable>(&self, packet: &P, packet_size: usize) -> Result<()> {
@@ -1,4 +1,7 @@
-use std::sync::atomic::Ordering;
+use std::{
+    sync::atomic::Ordering,
+    time::{SystemTime, UNIX_EPOCH},
+};
 
 use super::*;
 
@@ -11,11 +14,22 @@ impl ClientThread {
         .await
     });
 
-    gs_handler!(self, handle_keepalive, KeepalivePacket, _packet, {
+    gs_handler!(self, handle_keepalive, KeepalivePacket, packet, {
         let _ = gs_needauth!(self);
 
-        self.send_packet_static(&KeepaliveResponsePacket {
-            player_count: self.game_server.state.get_player_count(),
+        let player_count = self.game_server.state.get_player_count();
+
+        if self.protocol_version.load(Ordering::Relaxed) < CLOCK_SYNC_PROTOCOL {
+            return self.send_packet_static(&KeepaliveResponsePacket { player_count }).await;
+        }
+
+        // echo the client's time back, so that it can tell the round trip time apart from the clock offset
+        let server_time = SystemTime::now().duration_since(UNIX_EPOCH)?.as_micros() as u64;
+
+        self.send_packet_alloca_with::<KeepaliveResponsePacket, _>(size_of_types!(u32, u64, u64), |buf| {
+            buf.write_u32(player_count);
+            buf.write_u64(packet.client_time);
+            buf.write_u64(server_time);
         })
         .await
     });
@@ -1,6 +1,7 @@
 use std::sync::{atomic::Ordering, Arc};
 
 use super::*;
+use crate::managers::LevelManager;
 
 /// max voice packet size in bytes
 pub const MAX_VOICE_PACKET_SIZE: usize = 4096;
@@ -15,6 +16,10 @@ impl ClientThread {
 
         self.on_unlisted_level.store(unlisted, Ordering::SeqCst);
 
+        // baselines from the previous level are meaningless now.
+        // safety: only this thread ever accesses its delta state.
+        unsafe { self.delta_sync.get_mut() }.reset();
+
         let old_level = self.level_id.swap(level_id, Ordering::Relaxed);
         let room_id = self.room_id.load(Ordering::Relaxed);
 
@@ -34,6 +39,8 @@ impl ClientThread {
     gs_handler!(self, handle_level_leave, LevelLeavePacket, _packet, {
         let account_id = gs_needauth!(self);
 
+        unsafe { self.delta_sync.get_mut() }.reset();
+
         let level_id = self.level_id.swap(0, Ordering::Relaxed);
         if level_id != 0 {
             let room_id = self.room_id.load(Ordering::Relaxed);
@@ -59,18 +66,7 @@ impl ClientThread {
         let (written_players, metadatas) = self.game_server.state.room_manager.with_any(room_id, |pm| {
             pm.manager.set_player_data(account_id, &packet.data);
 
-            let mut metavec = Vec::new();
-            if let Some(meta) = packet.meta {
-                pm.manager.set_player_meta(account_id, &meta);
-
-                metavec = Vec::with_capacity(pm.manager.get_player_count_on_level(level_id).unwrap_or(0));
-                pm.manager.for_each_player_on_level(level_id, |player| {
-                    metavec.push(AssociatedPlayerMetadata {
-                        account_id: player.account_id,
-                        data: player.meta.clone(),
-                    });
-                });
-            }
+            let metavec = Self::update_level_metadata(&mut pm.manager, level_id, account_id, packet.meta);
 
             // this unwrap should be safe and > 0 given that self.level_id != 0, but we leave a default just in case
             let player_count = pm.manager.get_player_count_on_level(level_id).unwrap_or(1) - 1;
@@ -139,6 +135,117 @@ impl ClientThread {
         Ok(())
     });
 
+    gs_handler!(self, handle_player_data_delta, PlayerDataDeltaPacket, packet, {
+        let account_id = gs_needauth!(self);
+
+        let level_id = self.level_id.load(Ordering::Relaxed);
+        if level_id == 0 {
+            return Err(PacketHandlingError::UnexpectedPlayerData);
+        }
+
+        let room_id = self.room_id.load(Ordering::Relaxed);
+
+        // safety: only this thread ever accesses its delta state
+        let delta_sync = unsafe { self.delta_sync.get_mut() };
+
+        if packet.needs_keyframe {
+            // the client lost a baseline, so whatever it acknowledged before can't be relied on
+            delta_sync.reset();
+        } else {
+            delta_sync.process_acks(packet.ack, packet.ack_bits);
+        }
+
+        let mut players = std::mem::take(&mut delta_sync.scratch);
+        players.clear();
+
+        let (ack, origin, metadatas) = self.game_server.state.room_manager.with_any(room_id, |pm| {
+            if !pm.manager.apply_player_delta(account_id, packet.seq, packet.baseline_offset, packet.data) {
+                delta_sync.upstream_needs_keyframe = true;
+            }
+
+            let (ack, origin) = pm
+                .manager
+                .get_player_data(account_id)
+                .map_or((0, Point::default()), |p| (p.history.latest(), p.data.player1.position));
+            let metavec = Self::update_level_metadata(&mut pm.manager, level_id, account_id, packet.meta);
+
+            pm.manager.for_each_player_on_level(level_id, |player| {
+                if player.account_id != account_id {
+                    players.push(delta_sync.encode_player(player));
+                }
+            });
+
+            (ack, origin, metavec)
+        });
+
+        // no one else on the level, no need to send a response packet
+        if !players.is_empty() {
+            // the origin is only written for quantized packets, but always reserving space for it is harmless
+            const HEADER_SIZE: usize = size_of_types!(u32, u32, bool, Point, VarLength);
+
+            // positions are quantized relative to the receiver, as the players closest to them matter the most
+            let quantizer = (self.protocol_version.load(Ordering::Relaxed) >= QUANTIZED_TRANSFORM_PROTOCOL)
+                .then(|| TransformQuantizer::new(origin));
+
+            let fragmentation_limit = self.fragmentation_limit.load(Ordering::Relaxed) as usize;
+            let per_fragment = (fragmentation_limit.saturating_sub(HEADER_SIZE) / AssociatedPlayerDataDelta::ENCODED_SIZE).max(1);
+            let needs_keyframe = std::mem::take(&mut delta_sync.upstream_needs_keyframe);
+
+            for chunk in players.chunks(per_fragment) {
+                let seq = delta_sync.record_sent(chunk);
+                let calc_size = HEADER_SIZE + AssociatedPlayerDataDelta::ENCODED_SIZE * chunk.len();
+
+                self.send_packet_alloca_with::<LevelDataDeltaPacket, _>(calc_size, |buf| {
+                    buf.write_u32(seq);
+                    buf.write_u32(ack);
+                    buf.write_bool(needs_keyframe);
+
+                    if let Some(q) = &quantizer {
+                        buf.write_value(&q.origin);
+                    }
+
+                    buf.write_length(chunk.len());
+                    for player in chunk {
+                        player.encode_with(buf, quantizer.as_ref());
+                    }
+                })
+                .await?;
+            }
+        }
+
+        delta_sync.scratch = players;
+
+        if !metadatas.is_empty() {
+            self.send_packet_dynamic(&LevelPlayerMetadataPacket { players: metadatas }).await?;
+        }
+
+        Ok(())
+    });
+
+    /// if the client sent its metadata, store it and collect the metadata of everyone on the level
+    fn update_level_metadata(
+        manager: &mut LevelManager,
+        level_id: LevelId,
+        account_id: i32,
+        meta: Option<PlayerMetadata>,
+    ) -> Vec<AssociatedPlayerMetadata> {
+        let Some(meta) = meta else {
+            return Vec::new();
+        };
+
+        manager.set_player_meta(account_id, &meta);
+
+        let mut metavec = Vec::with_capacity(manager.get_player_count_on_level(level_id).unwrap_or(0));
+        manager.for_each_player_on_level(level_id, |player| {
+            metavec.push(AssociatedPlayerMetadata {
+                account_id: player.account_id,
+                data: player.meta.clone(),
+            });
+        });
+
+        metavec
+    }
+
     gs_handler!(self, handle_request_profiles, RequestPlayerProfilesPacket, packet, {
         let _ = gs_needauth!(self);
 
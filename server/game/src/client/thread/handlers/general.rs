@@ -11,7 +11,7 @@ impl ClientThread {
     gs_handler!(self, handle_request_global_list, RequestGlobalPlayerListPacket, _packet, {
         let _ = gs_needauth!(self);
 
-        self.send_packet_dynamic(&GlobalPlayerListPacket {
+        self.send_packet_compressed(&GlobalPlayerListPacket {
             players: self.game_server.get_player_previews_in_room(0),
         })
         .await
@@ -21,23 +21,27 @@ impl ClientThread {
         let _ = gs_needauth!(self);
 
         let room_id = self.room_id.load(Ordering::Relaxed);
+        let levels = self._collect_level_list(room_id);
 
-        let levels = self.game_server.state.room_manager.with_any(room_id, |pm| {
-            let mut vec = Vec::with_capacity(pm.manager.get_level_count());
+        self.send_packet_compressed(&LevelListPacket { levels }).await
+    });
 
-            pm.manager.for_each_level(|level_id, level| {
-                if !level.unlisted && !is_editorcollab_level(level_id) {
-                    vec.push(GlobedLevel {
-                        level_id,
-                        player_count: level.players.len() as u16,
-                    });
-                }
-            });
+    gs_handler!(self, handle_request_level_list_delta, RequestLevelListDeltaPacket, packet, {
+        let _ = gs_needauth!(self);
 
-            vec
-        });
+        let room_id = self.room_id.load(Ordering::Relaxed);
+        let levels = self._collect_level_list(room_id);
 
-        self.send_packet_dynamic(&LevelListPacket { levels }).await
+        let list_sync = unsafe { self.level_list_sync.get_mut() };
+        let diff = list_sync.diff(packet.version, room_id, &levels, |level| level.level_id);
+
+        self.send_packet_compressed(&LevelListDeltaPacket {
+            base_version: diff.base_version,
+            version: diff.version,
+            upserted: diff.changed.iter().map(|&idx| levels[idx]).collect(),
+            removed: diff.removed,
+        })
+        .await
     });
 
     gs_handler!(self, handle_request_player_count, RequestPlayerCountPacket, packet, {
@@ -58,6 +62,15 @@ impl ClientThread {
         self.send_packet_dynamic(&LevelPlayerCountPacket { levels }).await
     });
 
+    gs_handler!(self, handle_subscribe_player_counts, SubscribePlayerCountsPacket, packet, {
+        let _ = gs_needauth!(self);
+
+        unsafe { self.count_subscriptions.get_mut() }.set(&packet.level_ids);
+
+        // newly subscribed levels get their counts right away
+        self.push_player_counts().await
+    });
+
     gs_handler!(self, handle_set_player_status, UpdatePlayerStatusPacket, packet, {
         let _ = gs_needauth!(self);
 
@@ -73,4 +86,37 @@ impl ClientThread {
 
         Ok(())
     });
+
+    fn _collect_level_list(&self, room_id: u32) -> Vec<GlobedLevel> {
+        self.game_server.state.room_manager.with_any(room_id, |pm| {
+            let mut vec = Vec::with_capacity(pm.manager.get_level_count());
+
+            pm.manager.for_each_level(|level_id, level| {
+                if !level.unlisted && !is_editorcollab_level(level_id) {
+                    vec.push(GlobedLevel {
+                        level_id,
+                        player_count: level.players.len() as u16,
+                    });
+                }
+            });
+
+            vec
+        })
+    }
+
+    /// send the counts of subscribed levels that changed since they were last sent, if any
+    pub(crate) async fn push_player_counts(&self) -> crate::client::Result<()> {
+        let room_id = self.room_id.load(Ordering::Relaxed);
+
+        let levels = self.game_server.state.room_manager.with_any(room_id, |pm| {
+            unsafe { self.count_subscriptions.get_mut() }
+                .collect_changes(|level_id| pm.manager.get_player_count_on_level(level_id).unwrap_or(0) as u16)
+        });
+
+        if levels.is_empty() {
+            return Ok(());
+        }
+
+        self.send_packet_dynamic(&LevelPlayerCountPacket { levels }).await
+    }
 }
@@ -157,6 +157,30 @@ impl ClientThread {
         self._respond_with_room_list(room_id, false).await
     });
 
+    gs_handler!(self, handle_request_room_players_delta, RequestRoomPlayerListDeltaPacket, packet, {
+        let _ = gs_needauth!(self);
+
+        let room_id = self.room_id.load(Ordering::Relaxed);
+        let room_info = self.game_server.state.room_manager.with_any(room_id, |room| room.get_room_info(room_id));
+
+        let can_moderate = self.user_role.lock().can_moderate();
+        let players = self
+            .game_server
+            .get_room_player_previews(room_id, self.account_id.load(Ordering::Relaxed), can_moderate);
+
+        let list_sync = unsafe { self.room_list_sync.get_mut() };
+        let diff = list_sync.diff(packet.version, room_id, &players, |player| player.account_id);
+
+        self.send_packet_compressed(&RoomPlayerListDeltaPacket {
+            room_info,
+            base_version: diff.base_version,
+            version: diff.version,
+            upserted: diff.changed.iter().map(|&idx| players[idx].clone()).collect(),
+            removed: diff.removed,
+        })
+        .await
+    });
+
     gs_handler!(self, handle_update_room_settings, UpdateRoomSettingsPacket, packet, {
         let account_id = gs_needauth!(self);
 
@@ -247,7 +271,7 @@ impl ClientThread {
                 .collect(),
         };
 
-        self.send_packet_dynamic(&pkt).await
+        self.send_packet_compressed(&pkt).await
     });
 
     gs_handler!(self, handle_close_room, CloseRoomPacket, _packet, {
@@ -346,9 +370,9 @@ impl ClientThread {
             .get_room_player_previews(room_id, self.account_id.load(Ordering::Relaxed), can_moderate);
 
         if just_joined {
-            self.send_packet_dynamic(&RoomJoinedPacket { room_info, players }).await
+            self.send_packet_compressed(&RoomJoinedPacket { room_info, players }).await
         } else {
-            self.send_packet_dynamic(&RoomPlayerListPacket { room_info, players }).await
+            self.send_packet_compressed(&RoomPlayerListPacket { room_info, players }).await
         }
     }
 }
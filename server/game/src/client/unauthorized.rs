@@ -273,7 +273,7 @@ impl UnauthorizedThread {
 
         // decrypt the packet in-place if encrypted
         if header.encrypted {
-            data = self.get_socket().decrypt(message)?;
+            data = self.get_socket().decrypt(message, SessionChannel::Tcp)?;
         }
 
         match header.packet_id {
@@ -305,9 +305,24 @@ impl UnauthorizedThread {
         self.protocol_version.store(packet.protocol, Ordering::Relaxed);
 
         socket.init_crypto_box(&packet.key)?;
+
+        if packet.protocol >= COMPRESSION_PROTOCOL {
+            socket.enable_compression();
+        }
+
+        let key: CryptoPublicKey = self.game_server.public_key.clone().into();
+
+        if packet.protocol < SESSION_CIPHER_PROTOCOL {
+            return socket.send_packet_static(&CryptoHandshakeResponsePacket { key }).await;
+        }
+
+        // the response itself is not encrypted, so it must be sent before anything else uses the session
+        let sealed_seed = socket.init_session()?;
+
         socket
-            .send_packet_static(&CryptoHandshakeResponsePacket {
-                key: self.game_server.public_key.clone().into(),
+            .send_packet_alloca_with::<CryptoHandshakeResponsePacket, _>(CryptoPublicKey::ENCODED_SIZE + SEALED_SEED_SIZE, |buf| {
+                buf.write_value(&key);
+                buf.write_bytes(&sealed_seed);
             })
             .await
     });
@@ -7,3 +7,19 @@ pub const ROOM_ID_LENGTH: usize = 6;
 
 // this should be the PlayerData size plus some headroom
 pub const SMALL_PACKET_LIMIT: usize = 96;
+
+/// amount of recent player data snapshots kept on both sides for delta encoding (32).
+/// must not exceed 255, as baselines are referenced by a `u8` offset from the current sequence number.
+pub const DELTA_HISTORY_SIZE: usize = 32;
+
+/// first protocol version where positions and rotations in `LevelDataDeltaPacket` are quantized, see `TransformQuantizer`
+pub const QUANTIZED_TRANSFORM_PROTOCOL: u16 = 13;
+
+/// first protocol version where keepalives carry timestamps, so that clients can synchronize their clock with the server
+pub const CLOCK_SYNC_PROTOCOL: u16 = 14;
+
+/// first protocol version where encrypted packets use `SessionCipher` instead of the `ChaChaBox` from the handshake
+pub const SESSION_CIPHER_PROTOCOL: u16 = 15;
+
+/// first protocol version where big TCP packets (player, level and room lists) may be sent compressed, see `PacketHeader::FLAG_COMPRESSED`
+pub const COMPRESSION_PROTOCOL: u16 = 16;
@@ -13,9 +13,22 @@ pub struct CryptoHandshakeStartPacket {
     pub key: CryptoPublicKey,
 }
 
-#[derive(Packet, Decodable)]
+#[derive(Packet)]
 #[packet(id = 10002)]
-pub struct KeepalivePacket;
+pub struct KeepalivePacket {
+    /// time on the client's clock when it sent the packet, in microseconds. Only sent since `CLOCK_SYNC_PROTOCOL`, 0 otherwise
+    pub client_time: u64,
+}
+
+decode_impl!(KeepalivePacket, buf, {
+    let client_time = if buf.len() - buf.get_rpos() >= size_of_types!(u64) {
+        buf.read_u64()?
+    } else {
+        0
+    };
+
+    Ok(Self { client_time })
+});
 
 pub const MAX_TOKEN_SIZE: usize = 164;
 
@@ -24,6 +24,21 @@ pub struct PlayerDataPacket {
     pub meta: Option<PlayerMetadata>,
 }
 
+/// Delta-encoded alternative to `PlayerDataPacket`, used by clients on protocol v12 and newer.
+/// `ack` and `ack_bits` acknowledge received `LevelDataDeltaPacket`s: `ack` is the newest received sequence number,
+/// and bit `n` of `ack_bits` is set if `ack - 1 - n` was received too.
+#[derive(Packet, Decodable)]
+#[packet(id = 12005)]
+pub struct PlayerDataDeltaPacket {
+    pub seq: u32,
+    pub baseline_offset: u8,
+    pub ack: u32,
+    pub ack_bits: u32,
+    pub needs_keyframe: bool,
+    pub data: PlayerDataDelta,
+    pub meta: Option<PlayerMetadata>,
+}
+
 #[derive(Packet, Decodable)]
 #[packet(id = 12010, encrypted = true)]
 pub struct VoicePacket {
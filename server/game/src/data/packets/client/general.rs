@@ -25,3 +25,15 @@ pub struct RequestPlayerCountPacket {
 pub struct UpdatePlayerStatusPacket {
     pub flags: UserPrivacyFlags,
 }
+
+#[derive(Packet, Decodable)]
+#[packet(id = 11005)]
+pub struct RequestLevelListDeltaPacket {
+    pub version: u32,
+}
+
+#[derive(Packet, Decodable)]
+#[packet(id = 11006)]
+pub struct SubscribePlayerCountsPacket {
+    pub level_ids: FastVec<LevelId, 256>,
+}
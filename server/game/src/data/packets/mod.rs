@@ -32,4 +32,9 @@ impl PacketHeader {
     }
 
     pub const SIZE: usize = Self::ENCODED_SIZE;
+
+    /// on the wire `encrypted` is the lowest bit of a flags byte, packets sent by the client never have any other flag set
+    pub const FLAG_ENCRYPTED: u8 = 1 << 0;
+    /// the packet body is compressed with `client::compression` (since `COMPRESSION_PROTOCOL`)
+    pub const FLAG_COMPRESSED: u8 = 1 << 1;
 }
@@ -12,6 +12,17 @@ pub struct LevelDataPacket {
     pub players: Vec<AssociatedPlayerData>,
 }
 
+/// Response to `PlayerDataDeltaPacket`. `ack` is the newest snapshot of the receiving client that the server has applied,
+/// `needs_keyframe` is set if the server could not apply a delta because its baseline was unknown.
+#[derive(Packet, Encodable)]
+#[packet(id = 22003, tcp = false)]
+pub struct LevelDataDeltaPacket {
+    pub seq: u32,
+    pub ack: u32,
+    pub needs_keyframe: bool,
+    pub players: Vec<AssociatedPlayerDataDelta>,
+}
+
 #[derive(Packet, Encodable, DynamicSize)]
 #[packet(id = 22002, tcp = true)]
 pub struct LevelPlayerMetadataPacket {
@@ -27,3 +27,12 @@ pub struct LevelPlayerCountPacket {
 pub struct RolesUpdatedPacket {
     pub special_user_data: SpecialUserData,
 }
+
+#[derive(Packet, Encodable, DynamicSize)]
+#[packet(id = 21004, tcp = true)]
+pub struct LevelListDeltaPacket {
+    pub base_version: u32,
+    pub version: u32,
+    pub upserted: Vec<GlobedLevel>,
+    pub removed: Vec<LevelId>,
+}
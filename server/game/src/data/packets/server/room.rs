@@ -53,3 +53,13 @@ pub struct RoomListPacket {
 pub struct RoomCreateFailedPacket<'a> {
     pub reason: &'a str,
 }
+
+#[derive(Packet, Encodable, DynamicSize)]
+#[packet(id = 23008, tcp = true)]
+pub struct RoomPlayerListDeltaPacket {
+    pub room_info: RoomInfo,
+    pub base_version: u32,
+    pub version: u32,
+    pub upserted: Vec<PlayerRoomPreviewAccountData>,
+    pub removed: Vec<i32>,
+}
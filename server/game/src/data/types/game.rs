@@ -2,7 +2,7 @@ use crate::data::*;
 
 /* PlayerIconType */
 
-#[derive(Default, Debug, Copy, Clone, Encodable, Decodable, StaticSize, DynamicSize)]
+#[derive(Default, Debug, Copy, Clone, PartialEq, Encodable, Decodable, StaticSize, DynamicSize)]
 #[dynamic_size(as_static = true)]
 #[repr(u8)]
 pub enum PlayerIconType {
@@ -20,7 +20,7 @@ pub enum PlayerIconType {
 }
 
 /* SpiderTeleportData (spider teleport data) */
-#[derive(Clone, Debug, Default, Encodable, Decodable, StaticSize, DynamicSize)]
+#[derive(Clone, Debug, Default, PartialEq, Encodable, Decodable, StaticSize, DynamicSize)]
 #[dynamic_size(as_static = true)]
 pub struct SpiderTeleportData {
     pub from: Point,
@@ -30,7 +30,7 @@ pub struct SpiderTeleportData {
 /* SpecificIconData (specific player data) */
 // 16 bytes best-case, 32 bytes worst-case (when on the same frame as spider TP).
 
-#[derive(Clone, Debug, Default, Encodable, Decodable, StaticSize, DynamicSize)]
+#[derive(Clone, Debug, Default, PartialEq, Encodable, Decodable, StaticSize, DynamicSize)]
 pub struct SpecificIconData {
     pub position: Point,
     pub rotation: FiniteF32,
@@ -51,7 +51,7 @@ pub struct PlayerMetadata {
 /* PlayerData (data in a level) */
 // 45 bytes best-case, 77 bytes worst-case (with 2 spider teleports).
 
-#[derive(Clone, Debug, Default, Encodable, Decodable, StaticSize, DynamicSize)]
+#[derive(Clone, Debug, Default, PartialEq, Encodable, Decodable, StaticSize, DynamicSize)]
 pub struct PlayerData {
     pub timestamp: FiniteF32,
 
@@ -64,3 +64,335 @@ pub struct PlayerData {
 
     pub flags: Bits<1>, // also a bit-field
 }
+
+/* PlayerDataDelta (PlayerData encoded relative to an earlier snapshot) */
+// 6 bytes best-case (only the timestamp changed), slightly less than a full PlayerData worst-case.
+// The timestamp is always written, every other field is written only if its bit in `mask` is set.
+// Spider teleports are events rather than state, so they are never inherited from the baseline.
+
+#[derive(Clone, Debug, Default)]
+pub struct PlayerDataDelta {
+    pub mask: u16,
+    pub data: PlayerData,
+}
+
+impl PlayerDataDelta {
+    // per-icon bits, shifted by `PLAYER1_SHIFT` or `PLAYER2_SHIFT`
+    pub const ICON_POSITION: u16 = 1 << 0;
+    pub const ICON_ROTATION: u16 = 1 << 1;
+    pub const ICON_TYPE: u16 = 1 << 2;
+    pub const ICON_FLAGS: u16 = 1 << 3;
+    pub const ICON_SPIDER_TP: u16 = 1 << 4;
+    pub const PLAYER1_SHIFT: u16 = 0;
+    pub const PLAYER2_SHIFT: u16 = 5;
+
+    pub const LAST_DEATH_TIMESTAMP: u16 = 1 << 10;
+    pub const CURRENT_PERCENTAGE: u16 = 1 << 11;
+    pub const FLAGS: u16 = 1 << 12;
+    /// set if the delta was made without a baseline and contains every field
+    pub const KEYFRAME: u16 = 1 << 15;
+
+    /// Create a delta that turns `baseline` into `current`. If `baseline` is `None`, the delta is a full keyframe.
+    pub fn diff(current: &PlayerData, baseline: Option<&PlayerData>) -> Self {
+        let mut mask = Self::icon_mask(&current.player1, baseline.map(|b| &b.player1)) << Self::PLAYER1_SHIFT;
+        mask |= Self::icon_mask(&current.player2, baseline.map(|b| &b.player2)) << Self::PLAYER2_SHIFT;
+
+        if baseline.map_or(true, |b| b.last_death_timestamp != current.last_death_timestamp) {
+            mask |= Self::LAST_DEATH_TIMESTAMP;
+        }
+
+        if baseline.map_or(true, |b| b.current_percentage != current.current_percentage) {
+            mask |= Self::CURRENT_PERCENTAGE;
+        }
+
+        if baseline.map_or(true, |b| b.flags != current.flags) {
+            mask |= Self::FLAGS;
+        }
+
+        if baseline.is_none() {
+            mask |= Self::KEYFRAME;
+        }
+
+        Self {
+            mask,
+            data: current.clone(),
+        }
+    }
+
+    fn icon_mask(current: &SpecificIconData, baseline: Option<&SpecificIconData>) -> u16 {
+        let mut mask = 0u16;
+
+        if baseline.map_or(true, |b| b.position != current.position) {
+            mask |= Self::ICON_POSITION;
+        }
+
+        if baseline.map_or(true, |b| b.rotation != current.rotation) {
+            mask |= Self::ICON_ROTATION;
+        }
+
+        if baseline.map_or(true, |b| b.icon_type != current.icon_type) {
+            mask |= Self::ICON_TYPE;
+        }
+
+        if baseline.map_or(true, |b| b.flags != current.flags) {
+            mask |= Self::ICON_FLAGS;
+        }
+
+        if current.spider_teleport_data.is_some() {
+            mask |= Self::ICON_SPIDER_TP;
+        }
+
+        mask
+    }
+
+    #[inline]
+    pub const fn is_keyframe(&self) -> bool {
+        self.mask & Self::KEYFRAME != 0
+    }
+
+    /// Reconstruct the full `PlayerData` by applying this delta on top of `baseline`. Keyframes ignore the baseline.
+    pub fn apply(self, baseline: Option<&PlayerData>) -> PlayerData {
+        let mut out = if self.is_keyframe() {
+            PlayerData::default()
+        } else {
+            baseline.cloned().unwrap_or_default()
+        };
+
+        out.timestamp = self.data.timestamp;
+
+        let PlayerData { player1, player2, .. } = self.data;
+        Self::apply_icon(&mut out.player1, player1, self.mask >> Self::PLAYER1_SHIFT);
+        Self::apply_icon(&mut out.player2, player2, self.mask >> Self::PLAYER2_SHIFT);
+
+        if self.mask & Self::LAST_DEATH_TIMESTAMP != 0 {
+            out.last_death_timestamp = self.data.last_death_timestamp;
+        }
+
+        if self.mask & Self::CURRENT_PERCENTAGE != 0 {
+            out.current_percentage = self.data.current_percentage;
+        }
+
+        if self.mask & Self::FLAGS != 0 {
+            out.flags = self.data.flags;
+        }
+
+        out
+    }
+
+    fn apply_icon(out: &mut SpecificIconData, icon: SpecificIconData, mask: u16) {
+        if mask & Self::ICON_POSITION != 0 {
+            out.position = icon.position;
+        }
+
+        if mask & Self::ICON_ROTATION != 0 {
+            out.rotation = icon.rotation;
+        }
+
+        if mask & Self::ICON_TYPE != 0 {
+            out.icon_type = icon.icon_type;
+        }
+
+        if mask & Self::ICON_FLAGS != 0 {
+            out.flags = icon.flags;
+        }
+
+        out.spider_teleport_data = icon.spider_teleport_data;
+    }
+}
+
+impl PlayerDataDelta {
+    /// Write the delta. If `quantizer` is set (protocol v13 and newer), positions and rotations are quantized with it,
+    /// and an icon's rotation is always written together with its position.
+    pub fn encode_with<B: ByteBufferExtWrite>(&self, buf: &mut B, quantizer: Option<&TransformQuantizer>) {
+        let mut mask = self.mask;
+        if quantizer.is_some() {
+            for shift in [Self::PLAYER1_SHIFT, Self::PLAYER2_SHIFT] {
+                if mask & (Self::ICON_POSITION << shift) != 0 {
+                    mask |= Self::ICON_ROTATION << shift;
+                }
+            }
+        }
+
+        buf.write_value(&self.data.timestamp);
+        buf.write_value(&mask);
+
+        for (icon, shift) in [(&self.data.player1, Self::PLAYER1_SHIFT), (&self.data.player2, Self::PLAYER2_SHIFT)] {
+            let mask = mask >> shift;
+
+            match quantizer {
+                Some(q) if mask & Self::ICON_POSITION != 0 => buf.write_value(&q.pack(&icon.position, icon.rotation)),
+                Some(_) if mask & Self::ICON_ROTATION != 0 => buf.write_value(&TransformQuantizer::quantize_rotation(icon.rotation)),
+                Some(_) => {}
+                None => {
+                    if mask & Self::ICON_POSITION != 0 {
+                        buf.write_value(&icon.position);
+                    }
+
+                    if mask & Self::ICON_ROTATION != 0 {
+                        buf.write_value(&icon.rotation);
+                    }
+                }
+            }
+
+            if mask & Self::ICON_TYPE != 0 {
+                buf.write_value(&icon.icon_type);
+            }
+
+            if mask & Self::ICON_FLAGS != 0 {
+                buf.write_value(&icon.flags);
+            }
+
+            if mask & Self::ICON_SPIDER_TP != 0 {
+                if let Some(tp) = &icon.spider_teleport_data {
+                    buf.write_value(tp);
+                }
+            }
+        }
+
+        if mask & Self::LAST_DEATH_TIMESTAMP != 0 {
+            buf.write_value(&self.data.last_death_timestamp);
+        }
+
+        if mask & Self::CURRENT_PERCENTAGE != 0 {
+            buf.write_value(&self.data.current_percentage);
+        }
+
+        if mask & Self::FLAGS != 0 {
+            buf.write_value(&self.data.flags);
+        }
+    }
+
+    /// Read a delta written by `encode_with` with the same `quantizer`.
+    pub fn decode_with<B: ByteBufferExtRead>(buf: &mut B, quantizer: Option<&TransformQuantizer>) -> DecodeResult<Self> {
+        let mut data = PlayerData {
+            timestamp: buf.read_value()?,
+            ..Default::default()
+        };
+
+        let mask: u16 = buf.read_value()?;
+
+        for (icon, shift) in [(&mut data.player1, Self::PLAYER1_SHIFT), (&mut data.player2, Self::PLAYER2_SHIFT)] {
+            let mask = mask >> shift;
+
+            match quantizer {
+                Some(q) if mask & Self::ICON_POSITION != 0 => {
+                    (icon.position, icon.rotation) = q.unpack(buf.read_value()?);
+                }
+                Some(_) if mask & Self::ICON_ROTATION != 0 => {
+                    icon.rotation = TransformQuantizer::dequantize_rotation(buf.read_value()?);
+                }
+                Some(_) => {}
+                None => {
+                    if mask & Self::ICON_POSITION != 0 {
+                        icon.position = buf.read_value()?;
+                    }
+
+                    if mask & Self::ICON_ROTATION != 0 {
+                        icon.rotation = buf.read_value()?;
+                    }
+                }
+            }
+
+            if mask & Self::ICON_TYPE != 0 {
+                icon.icon_type = buf.read_value()?;
+            }
+
+            if mask & Self::ICON_FLAGS != 0 {
+                icon.flags = buf.read_value()?;
+            }
+
+            if mask & Self::ICON_SPIDER_TP != 0 {
+                icon.spider_teleport_data = Some(buf.read_value()?);
+            }
+        }
+
+        if mask & Self::LAST_DEATH_TIMESTAMP != 0 {
+            data.last_death_timestamp = buf.read_value()?;
+        }
+
+        if mask & Self::CURRENT_PERCENTAGE != 0 {
+            data.current_percentage = buf.read_value()?;
+        }
+
+        if mask & Self::FLAGS != 0 {
+            data.flags = buf.read_value()?;
+        }
+
+        Ok(Self { mask, data })
+    }
+}
+
+encode_impl!(PlayerDataDelta, buf, self, {
+    self.encode_with(buf, None);
+});
+
+decode_impl!(PlayerDataDelta, buf, { Self::decode_with(buf, None) });
+
+// the mask replaces the presence bytes of the two optional spider teleports, so this is an upper bound
+static_size_calc_impl!(PlayerDataDelta, size_of_types!(u16, PlayerData));
+dynamic_size_calc_impl!(PlayerDataDelta, self, Self::ENCODED_SIZE);
+
+/* TransformQuantizer (compact positions and rotations, protocol v13 and newer) */
+// A position and a rotation get packed into a single 64-bit word (12 bytes as floats), from the most significant bit:
+// 24 bits of x and 24 bits of y, stored as signed fixed-point offsets from `origin` in 1/16 of a unit,
+// then 16 bits of rotation, wrapped into [-180, 180) degrees.
+// Offsets that don't fit (over ~524k units away from the origin) are clamped.
+
+#[derive(Clone, Copy, Debug, Default)]
+pub struct TransformQuantizer {
+    pub origin: Point,
+}
+
+impl TransformQuantizer {
+    pub const POSITION_BITS: u32 = 24;
+    pub const POSITION_SCALE: f32 = 16.0;
+    pub const ROTATION_BITS: u32 = 16;
+
+    const POSITION_MIN: i32 = -(1 << (Self::POSITION_BITS - 1));
+    const POSITION_MAX: i32 = (1 << (Self::POSITION_BITS - 1)) - 1;
+    const POSITION_MASK: u64 = (1 << Self::POSITION_BITS) - 1;
+
+    pub const fn new(origin: Point) -> Self {
+        Self { origin }
+    }
+
+    pub fn pack(&self, position: &Point, rotation: FiniteF32) -> u64 {
+        let x = Self::quantize_axis(position.x.get(), self.origin.x.get());
+        let y = Self::quantize_axis(position.y.get(), self.origin.y.get());
+        let rot = u64::from(Self::quantize_rotation(rotation));
+
+        (x << (Self::POSITION_BITS + Self::ROTATION_BITS)) | (y << Self::ROTATION_BITS) | rot
+    }
+
+    pub fn unpack(&self, word: u64) -> (Point, FiniteF32) {
+        let x = Self::dequantize_axis(word >> (Self::POSITION_BITS + Self::ROTATION_BITS), self.origin.x.get());
+        let y = Self::dequantize_axis(word >> Self::ROTATION_BITS, self.origin.y.get());
+        let rot = Self::dequantize_rotation(word as u16);
+
+        (Point { x, y }, rot)
+    }
+
+    pub fn quantize_rotation(rotation: FiniteF32) -> u16 {
+        let wrapped = (rotation.get() + 180.0).rem_euclid(360.0) - 180.0;
+        // a full turn spans the entire range, so +180 wraps around to -180 as it should
+        (wrapped / 360.0 * 65536.0).round() as i32 as u16
+    }
+
+    pub fn dequantize_rotation(bits: u16) -> FiniteF32 {
+        FiniteF32::new(f32::from(bits as i16) * 360.0 / 65536.0).unwrap_or_default()
+    }
+
+    fn quantize_axis(value: f32, origin: f32) -> u64 {
+        // float to int casts saturate, so huge offsets can't wrap around
+        let q = (((value - origin) * Self::POSITION_SCALE).round() as i32).clamp(Self::POSITION_MIN, Self::POSITION_MAX);
+        u64::from(q as u32) & Self::POSITION_MASK
+    }
+
+    fn dequantize_axis(bits: u64, origin: f32) -> FiniteF32 {
+        // sign-extend the offset
+        let shift = 32 - Self::POSITION_BITS;
+        let q = (((bits & Self::POSITION_MASK) as u32) << shift) as i32 >> shift;
+
+        FiniteF32::new(origin + q as f32 / Self::POSITION_SCALE).unwrap_or_default()
+    }
+}
@@ -171,6 +171,39 @@ pub struct AssociatedPlayerData {
     pub data: PlayerData,
 }
 
+/* AssociatedPlayerDataDelta */
+// `seq` is the sequence number of the snapshot from the player that owns it, or 0 if that player does not use delta encoding.
+// `baseline_offset` is how many sequence numbers back the baseline is (`seq - baseline_offset`), it is ignored for keyframes.
+
+#[derive(Clone, Default, Encodable, Decodable, StaticSize, DynamicSize)]
+#[dynamic_size(as_static = true)]
+pub struct AssociatedPlayerDataDelta {
+    pub account_id: i32,
+    pub seq: u32,
+    pub baseline_offset: u8,
+    pub delta: PlayerDataDelta,
+}
+
+impl AssociatedPlayerDataDelta {
+    /// see `PlayerDataDelta::encode_with`
+    pub fn encode_with<B: ByteBufferExtWrite>(&self, buf: &mut B, quantizer: Option<&TransformQuantizer>) {
+        buf.write_value(&self.account_id);
+        buf.write_value(&self.seq);
+        buf.write_value(&self.baseline_offset);
+        self.delta.encode_with(buf, quantizer);
+    }
+
+    /// see `PlayerDataDelta::decode_with`
+    pub fn decode_with<B: ByteBufferExtRead>(buf: &mut B, quantizer: Option<&TransformQuantizer>) -> DecodeResult<Self> {
+        Ok(Self {
+            account_id: buf.read_value()?,
+            seq: buf.read_value()?,
+            baseline_offset: buf.read_value()?,
+            delta: PlayerDataDelta::decode_with(buf, quantizer)?,
+        })
+    }
+}
+
 /* AssociatedPlayerMetadata */
 
 #[derive(Clone, Default, Encodable, Decodable, StaticSize, DynamicSize)]
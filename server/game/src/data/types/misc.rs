@@ -1,6 +1,6 @@
 use crate::data::*;
 
-#[derive(Encodable, StaticSize, DynamicSize)]
+#[derive(Clone, Copy, Encodable, StaticSize, DynamicSize)]
 #[dynamic_size(as_static = true)]
 pub struct GlobedLevel {
     pub level_id: LevelId,
@@ -1,8 +1,12 @@
 use globed_shared::IntMap;
 
-use crate::data::{
-    types::PlayerData, AssociatedPlayerData, AssociatedPlayerMetadata, BorrowedAssociatedPlayerData, BorrowedAssociatedPlayerMetadata, LevelId,
-    PlayerMetadata,
+use crate::{
+    data::{
+        types::{PlayerData, PlayerDataDelta},
+        AssociatedPlayerData, AssociatedPlayerMetadata, BorrowedAssociatedPlayerData, BorrowedAssociatedPlayerMetadata, LevelId, PlayerMetadata,
+        DELTA_HISTORY_SIZE,
+    },
+    util::SnapshotHistory,
 };
 
 #[derive(Default)]
@@ -10,6 +14,8 @@ pub struct LevelManagerPlayer {
     pub account_id: i32,
     pub data: PlayerData,
     pub meta: PlayerMetadata,
+    /// recent snapshots sent by a client using delta encoding, empty for clients that send full `PlayerData`
+    pub history: SnapshotHistory<PlayerData, DELTA_HISTORY_SIZE>,
 }
 
 impl LevelManagerPlayer {
@@ -86,6 +92,37 @@ impl LevelManager {
         self.get_or_create_player(account_id).data.clone_from(data);
     }
 
+    /// apply a delta-encoded update to player's data, inserting a new entry if it doesn't already exist.
+    /// returns `false` if the baseline the delta refers to is no longer stored, in which case the client must send a keyframe.
+    pub fn apply_player_delta(&mut self, account_id: i32, seq: u32, baseline_offset: u8, delta: PlayerDataDelta) -> bool {
+        let player = self.get_or_create_player(account_id);
+        let latest = player.history.latest();
+
+        if seq <= latest {
+            if latest - seq <= DELTA_HISTORY_SIZE as u32 {
+                // reordered packet, a newer state was already applied
+                return true;
+            }
+
+            // the client started counting from the beginning again (i.e. reconnected), nothing we have is valid anymore
+            player.history.clear();
+        }
+
+        let data = if delta.is_keyframe() {
+            delta.apply(None)
+        } else {
+            match player.history.get(seq.wrapping_sub(u32::from(baseline_offset))) {
+                Some(baseline) => delta.apply(Some(baseline)),
+                None => return false,
+            }
+        };
+
+        player.data.clone_from(&data);
+        player.history.push(seq, data);
+
+        true
+    }
+
     /// set player's metadata, inserting a new entry if it doesn't already exist
     pub fn set_player_meta(&mut self, account_id: i32, meta: &PlayerMetadata) {
         self.get_or_create_player(account_id).meta.clone_from(meta);
@@ -2,6 +2,6 @@ mod level;
 mod role;
 mod room;
 
-pub use level::LevelManager;
+pub use level::{LevelManager, LevelManagerPlayer};
 pub use role::{ComputedRole, GameServerRole, RoleManager};
 pub use room::RoomManager;
@@ -1,9 +1,11 @@
 pub mod channel;
 pub mod lockfreemutcell;
 pub mod rate_limiter;
+pub mod snapshot_history;
 pub mod word_filter;
 
 pub use channel::{SenderDropped, TokioChannel};
 pub use lockfreemutcell::LockfreeMutCell;
 pub use rate_limiter::SimpleRateLimiter;
+pub use snapshot_history::SnapshotHistory;
 pub use word_filter::WordFilter;
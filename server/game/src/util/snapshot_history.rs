@@ -0,0 +1,54 @@
+/// Fixed-size ring of the most recent snapshots, keyed by their sequence number.
+/// A snapshot gets overwritten once `N` newer sequence numbers have been pushed after it.
+pub struct SnapshotHistory<T, const N: usize> {
+    entries: [Option<(u32, T)>; N],
+    latest: u32,
+}
+
+impl<T, const N: usize> SnapshotHistory<T, N> {
+    pub fn new() -> Self {
+        Self {
+            entries: std::array::from_fn(|_| None),
+            latest: 0,
+        }
+    }
+
+    /// store a snapshot, replacing whichever one was in its slot
+    pub fn push(&mut self, seq: u32, value: T) {
+        self.entries[seq as usize % N] = Some((seq, value));
+        self.latest = self.latest.max(seq);
+    }
+
+    /// get the snapshot with the given sequence number, if it is still stored
+    pub fn get(&self, seq: u32) -> Option<&T> {
+        match &self.entries[seq as usize % N] {
+            Some((s, value)) if *s == seq => Some(value),
+            _ => None,
+        }
+    }
+
+    /// remove the snapshot with the given sequence number and return it, if it is still stored
+    pub fn take(&mut self, seq: u32) -> Option<T> {
+        let slot = &mut self.entries[seq as usize % N];
+        match slot {
+            Some((s, _)) if *s == seq => slot.take().map(|(_, value)| value),
+            _ => None,
+        }
+    }
+
+    /// the highest sequence number pushed so far, or 0 if nothing was pushed since creation or the last `clear`
+    pub fn latest(&self) -> u32 {
+        self.latest
+    }
+
+    pub fn clear(&mut self) {
+        self.entries.iter_mut().for_each(|e| *e = None);
+        self.latest = 0;
+    }
+}
+
+impl<T, const N: usize> Default for SnapshotHistory<T, N> {
+    fn default() -> Self {
+        Self::new()
+    }
+}
@@ -1,7 +1,12 @@
 // this doc is mostly for flamegraphs
 #![allow(clippy::wildcard_imports, clippy::cast_possible_truncation)]
 use esp::{ByteBuffer, ByteReader};
-use globed_game_server::{data::*, managers::LevelManager};
+use globed_game_server::{
+    client::{compression, session::ReplayWindow, ListSyncState, PlayerCountSubscriptions, SessionChannel, SessionCipher},
+    data::*,
+    managers::LevelManager,
+};
+use globed_shared::rand::RngCore;
 use std::hint::black_box;
 
 const ITERS: usize = 500_000;
@@ -128,3 +133,340 @@ fn test_player_manager() {
         }
     }
 }
+
+/// build a `PlayerData` by decoding it, as its float fields can only be constructed that way
+fn make_player_data(timestamp: f32, x: f32, y: f32, rotation: f32, jumped: bool) -> PlayerData {
+    let mut buffer = ByteBuffer::new();
+    buffer.write_f32(timestamp);
+
+    for _ in 0..2 {
+        buffer.write_f32(x);
+        buffer.write_f32(y);
+        buffer.write_f32(rotation);
+        buffer.write_u8(1); // icon type
+        buffer.write_u8(if jumped { 0b1000_0000 } else { 0 });
+        buffer.write_u8(0);
+        buffer.write_bool(false); // spider teleport
+    }
+
+    buffer.write_f32(0.0); // last death timestamp
+    buffer.write_f32(50.0); // percentage
+    buffer.write_u8(0);
+
+    ByteReader::from_bytes(buffer.as_bytes()).read_value().unwrap()
+}
+
+fn roundtrip_delta(delta: &PlayerDataDelta) -> PlayerDataDelta {
+    let mut buffer = ByteBuffer::new();
+    buffer.write_value(delta);
+
+    assert!(buffer.len() <= PlayerDataDelta::ENCODED_SIZE);
+
+    ByteReader::from_bytes(buffer.as_bytes()).read_value().unwrap()
+}
+
+#[test]
+fn test_player_data_delta() {
+    let first = make_player_data(1.0, 10.0, 20.0, 0.0, false);
+    let second = make_player_data(1.1, 15.0, 20.0, 0.0, true);
+
+    // keyframe reconstructs everything without a baseline
+    let keyframe = roundtrip_delta(&PlayerDataDelta::diff(&first, None));
+    assert!(keyframe.is_keyframe());
+    assert!(keyframe.apply(Some(&second)) == first);
+
+    // delta only carries what changed
+    let delta = PlayerDataDelta::diff(&second, Some(&first));
+    assert!(!delta.is_keyframe());
+    assert_eq!(
+        delta.mask,
+        (PlayerDataDelta::ICON_POSITION | PlayerDataDelta::ICON_FLAGS) << PlayerDataDelta::PLAYER1_SHIFT
+            | (PlayerDataDelta::ICON_POSITION | PlayerDataDelta::ICON_FLAGS) << PlayerDataDelta::PLAYER2_SHIFT
+    );
+
+    let mut buffer = ByteBuffer::new();
+    buffer.write_value(&delta);
+    assert!(buffer.len() < size_of_types!(PlayerData));
+
+    assert!(roundtrip_delta(&delta).apply(Some(&first)) == second);
+
+    // unchanged data only costs the timestamp and the mask
+    let mut buffer = ByteBuffer::new();
+    buffer.write_value(&PlayerDataDelta::diff(&second, Some(&second)));
+    assert_eq!(buffer.len(), size_of_types!(f32, u16));
+}
+
+#[test]
+fn test_player_delta_baselines() {
+    let mut manager = LevelManager::new();
+    let first = make_player_data(1.0, 10.0, 20.0, 0.0, false);
+    let second = make_player_data(1.1, 15.0, 20.0, 0.0, false);
+
+    // a delta against a baseline the server never saw must be rejected
+    assert!(!manager.apply_player_delta(1, 2, 1, PlayerDataDelta::diff(&second, Some(&first))));
+
+    assert!(manager.apply_player_delta(1, 1, 0, PlayerDataDelta::diff(&first, None)));
+    assert!(manager.apply_player_delta(1, 2, 1, PlayerDataDelta::diff(&second, Some(&first))));
+    assert!(manager.get_player_data(1).unwrap().data == second);
+
+    // a reordered older packet is ignored
+    assert!(manager.apply_player_delta(1, 1, 0, PlayerDataDelta::diff(&first, None)));
+    assert!(manager.get_player_data(1).unwrap().data == second);
+
+    // once the baseline falls out of the history, the delta is rejected again
+    for seq in 3..(3 + DELTA_HISTORY_SIZE as u32) {
+        assert!(manager.apply_player_delta(1, seq, 1, PlayerDataDelta::diff(&second, Some(&second))));
+    }
+
+    assert!(!manager.apply_player_delta(1, 100, 98, PlayerDataDelta::diff(&second, Some(&first))));
+}
+
+#[test]
+fn test_quantized_transform() {
+    let finite = |x: f32| FiniteF32::new(x).unwrap();
+    let point = |x: f32, y: f32| Point { x: finite(x), y: finite(y) };
+
+    let quantizer = TransformQuantizer::new(point(15_000.0, 300.0));
+
+    // half a quantization step, plus the float precision lost when adding the origin back
+    let max_pos_error = 0.5 / TransformQuantizer::POSITION_SCALE + 0.01;
+    let max_rot_error = 0.5 * 360.0 / 65536.0 + 0.0001;
+
+    for &(x, y) in &[(15_000.0, 300.0), (0.0, 0.0), (-45.3, 105.25), (15_000.031, 299.97), (120_000.7, -3_000.1), (250_000.0, 30_000.0)] {
+        for &rotation in &[0.0f32, 0.01, 45.5, -90.0, 179.99, 180.0, -180.0, 359.0, 725.3, -1_000.0] {
+            let (pos, rot) = quantizer.unpack(quantizer.pack(&point(x, y), finite(rotation)));
+
+            assert!((pos.x.get() - x).abs() <= max_pos_error, "x: {x} -> {}", pos.x.get());
+            assert!((pos.y.get() - y).abs() <= max_pos_error, "y: {y} -> {}", pos.y.get());
+
+            // rotations come back wrapped into [-180, 180)
+            let rot_error = (rot.get() - rotation).rem_euclid(360.0);
+            assert!(rot_error.min(360.0 - rot_error) <= max_rot_error, "rotation: {rotation} -> {}", rot.get());
+            assert!((-180.0..180.0).contains(&rot.get()));
+        }
+    }
+
+    // offsets out of range get clamped instead of wrapping around
+    let (far, _) = quantizer.unpack(quantizer.pack(&point(5_000_000.0, -5_000_000.0), finite(0.0)));
+    assert!(far.x.get() > 500_000.0);
+    assert!(far.y.get() < -500_000.0);
+}
+
+#[test]
+fn test_quantized_player_data_delta() {
+    let data = make_player_data(1.0, 1234.567, 345.5, 92.25, false);
+    let quantizer = TransformQuantizer::new(data.player1.position);
+    let delta = PlayerDataDelta::diff(&data, None);
+
+    let mut quantized = ByteBuffer::new();
+    delta.encode_with(&mut quantized, Some(&quantizer));
+
+    let mut plain = ByteBuffer::new();
+    plain.write_value(&delta);
+
+    // 4 bytes saved per icon
+    assert_eq!(quantized.len() + 8, plain.len());
+
+    let decoded = PlayerDataDelta::decode_with(&mut ByteReader::from_bytes(quantized.as_bytes()), Some(&quantizer)).unwrap();
+    assert_eq!(decoded.mask, delta.mask);
+
+    let out = decoded.apply(None);
+    assert!((out.player2.position.x.get() - 1234.567).abs() <= 0.5 / TransformQuantizer::POSITION_SCALE);
+    assert!((out.player2.rotation.get() - 92.25).abs() <= 0.01);
+    assert!(out.current_percentage == data.current_percentage);
+
+    // a changed position always carries the rotation along
+    let moved = make_player_data(1.1, 1240.0, 345.5, 92.25, false);
+    let delta = PlayerDataDelta::diff(&moved, Some(&data));
+    assert_eq!(delta.mask & PlayerDataDelta::ICON_ROTATION, 0);
+
+    let mut buffer = ByteBuffer::new();
+    delta.encode_with(&mut buffer, Some(&quantizer));
+    let decoded = PlayerDataDelta::decode_with(&mut ByteReader::from_bytes(buffer.as_bytes()), Some(&quantizer)).unwrap();
+    assert_ne!(decoded.mask & PlayerDataDelta::ICON_ROTATION, 0);
+}
+
+#[test]
+fn test_keepalive_client_time() {
+    // clients older than `CLOCK_SYNC_PROTOCOL` send an empty keepalive
+    let mut reader = ByteReader::from_bytes(&[]);
+    assert_eq!(KeepalivePacket::decode_from_reader(&mut reader).unwrap().client_time, 0);
+
+    let mut buf = ByteBuffer::new();
+    buf.write_u64(123_456_789);
+
+    let mut reader = ByteReader::from_bytes(buf.as_bytes());
+    assert_eq!(KeepalivePacket::decode_from_reader(&mut reader).unwrap().client_time, 123_456_789);
+}
+
+#[test]
+fn test_session_cipher() {
+    let seed = [7u8; SessionCipher::SEED_SIZE];
+    let mut server = SessionCipher::new_server(&seed);
+    let mut client = SessionCipher::new_client(&seed);
+
+    fn encrypt(cipher: &mut SessionCipher, channel: SessionChannel, text: &[u8]) -> Vec<u8> {
+        let mut message = vec![0u8; SessionCipher::PREFIX_SIZE];
+        message.extend_from_slice(text);
+        cipher.encrypt(channel, &mut message).unwrap();
+        message
+    }
+
+    let first = encrypt(&mut server, SessionChannel::Udp, b"hello");
+    let second = encrypt(&mut server, SessionChannel::Udp, b"world");
+    let tcp = encrypt(&mut server, SessionChannel::Tcp, b"hello");
+
+    // sequence numbers are per channel and start at 1
+    assert_eq!(&first[..4], &1u32.to_be_bytes());
+    assert_eq!(&second[..4], &2u32.to_be_bytes());
+    assert_eq!(&tcp[..4], &1u32.to_be_bytes());
+    assert_ne!(first[SessionCipher::PREFIX_SIZE..], tcp[SessionCipher::PREFIX_SIZE..]);
+
+    // udp may be reordered, but never replayed
+    assert_eq!(client.decrypt(SessionChannel::Udp, &mut second.clone()).unwrap(), b"world");
+    assert_eq!(client.decrypt(SessionChannel::Udp, &mut first.clone()).unwrap(), b"hello");
+    assert!(client.decrypt(SessionChannel::Udp, &mut first.clone()).is_err());
+
+    // a packet from the other channel or the other direction doesn't authenticate
+    assert!(client.decrypt(SessionChannel::Tcp, &mut first.clone()).is_err());
+    assert!(server.decrypt(SessionChannel::Tcp, &mut tcp.clone()).is_err());
+
+    let mut tampered = tcp.clone();
+    *tampered.last_mut().unwrap() ^= 1;
+    assert!(client.decrypt(SessionChannel::Tcp, &mut tampered).is_err());
+
+    // a forged packet must not move the window, so the real one still gets through
+    assert_eq!(client.decrypt(SessionChannel::Tcp, &mut tcp.clone()).unwrap(), b"hello");
+
+    let reply = encrypt(&mut client, SessionChannel::Tcp, b"hi");
+    assert_eq!(server.decrypt(SessionChannel::Tcp, &mut reply.clone()).unwrap(), b"hi");
+}
+
+#[test]
+fn test_replay_window() {
+    let mut window = ReplayWindow::new(false);
+    for seq in [1, 3, 2, 70] {
+        assert!(window.check(seq));
+        window.accept(seq);
+    }
+
+    assert!(!window.check(0));
+    assert!(!window.check(2));
+    // 65 packets behind falls out of the window
+    assert!(!window.check(5));
+    assert!(window.check(7));
+    assert!(window.check(69));
+
+    // tcp only accepts packets newer than the last one
+    let mut ordered = ReplayWindow::new(true);
+    ordered.accept(1);
+    ordered.accept(5);
+    assert!(!ordered.check(4));
+    assert!(!ordered.check(5));
+    assert!(ordered.check(6));
+}
+
+#[test]
+fn test_list_compression() {
+    // a global player list, names and icons repeat a lot but are not identical
+    let players = (0..500)
+        .map(|i| PlayerPreviewAccountData {
+            account_id: 1_000_000 + i * 37,
+            user_id: 2_000_000 + i * 53,
+            name: InlineString::new(&format!("Player{}", i % 97)),
+            icons: PlayerIconDataSimple {
+                cube: (i % 40) as i16,
+                color1: (i % 12) as u8,
+                color2: 3,
+                glow_color: 3,
+            },
+            special_user_data: SpecialUserData { roles: None },
+        })
+        .collect::<Vec<_>>();
+
+    let packet = GlobalPlayerListPacket { players };
+
+    let mut raw = ByteBuffer::new();
+    raw.write_value(&packet);
+    let raw = raw.as_bytes();
+
+    let mut out = vec![0xaa; 3];
+    assert!(compression::compress_into(raw, &mut out));
+    assert_eq!(&out[..3], &[0xaa; 3]);
+    assert!(out.len() < raw.len() / 2);
+
+    assert_eq!(compression::decompress(&out[3..]).unwrap(), raw);
+
+    // random data can't be compressed, and must be left for the caller to send as is
+    let mut noise = vec![0u8; 4096];
+    globed_shared::rand::thread_rng().fill_bytes(&mut noise);
+    let mut out = Vec::new();
+    assert!(!compression::compress_into(&noise, &mut out));
+    assert!(out.is_empty());
+
+    assert!(compression::decompress(&[0, 0]).is_none());
+}
+
+#[test]
+fn test_list_sync() {
+    let level = |level_id: LevelId, player_count: u16| GlobedLevel { level_id, player_count };
+    let key = |level: &GlobedLevel| level.level_id;
+
+    let mut state = ListSyncState::<LevelId>::default();
+
+    // first request gets everything
+    let levels = vec![level(1, 5), level(2, 3), level(3, 1)];
+    let diff = state.diff(0, 0, &levels, key);
+    assert_eq!(diff.base_version, 0);
+    assert_eq!(diff.changed, vec![0, 1, 2]);
+    assert!(diff.removed.is_empty());
+
+    // one changed, one gone, one new
+    let levels = vec![level(1, 5), level(2, 4), level(4, 1)];
+    let diff2 = state.diff(diff.version, 0, &levels, key);
+    assert_eq!(diff2.base_version, diff.version);
+    assert_ne!(diff2.version, diff.version);
+    assert_eq!(diff2.changed, vec![1, 2]);
+    assert_eq!(diff2.removed, vec![3]);
+
+    // nothing changed
+    let diff3 = state.diff(diff2.version, 0, &levels, key);
+    assert_eq!(diff3.base_version, diff2.version);
+    assert!(diff3.changed.is_empty() && diff3.removed.is_empty());
+
+    // an outdated version or a different room means the client gets the whole list again
+    let diff4 = state.diff(diff2.version, 0, &levels, key);
+    assert_eq!(diff4.base_version, 0);
+    assert_eq!(diff4.changed, vec![0, 1, 2]);
+    assert!(diff4.removed.is_empty());
+
+    let diff5 = state.diff(diff4.version, 123_456, &levels, key);
+    assert_eq!(diff5.base_version, 0);
+    assert_eq!(diff5.changed.len(), 3);
+}
+
+#[test]
+fn test_player_count_subscriptions() {
+    let mut subs = PlayerCountSubscriptions::default();
+    assert!(subs.is_empty());
+
+    let sorted = |mut levels: Vec<(LevelId, u16)>| {
+        levels.sort_unstable();
+        levels
+    };
+
+    // every newly subscribed level is sent once, even if nobody is on it
+    subs.set(&[1, 2, 3]);
+    assert_eq!(sorted(subs.collect_changes(|id| if id == 2 { 4 } else { 0 })), vec![(1, 0), (2, 4), (3, 0)]);
+    assert!(subs.collect_changes(|id| if id == 2 { 4 } else { 0 }).is_empty());
+
+    // only changes after that
+    assert_eq!(subs.collect_changes(|id| if id == 3 { 1 } else if id == 2 { 4 } else { 0 }), vec![(3, 1)]);
+
+    // levels that stay subscribed keep their last sent count
+    subs.set(&[3, 5]);
+    assert_eq!(subs.collect_changes(|id| if id == 3 { 1 } else { 0 }), vec![(5, 0)]);
+
+    subs.set(&[]);
+    assert!(subs.is_empty());
+}
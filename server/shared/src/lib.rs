@@ -22,6 +22,7 @@ pub use crypto_box;
 pub use crypto_secretbox;
 pub use esp;
 pub use hmac;
+pub use lz4_flex;
 pub use parking_lot;
 pub use rand;
 pub use reqwest;
@@ -38,7 +39,7 @@ pub mod logger;
 pub mod token_issuer;
 pub mod webhook;
 
-pub const SUPPORTED_PROTOCOLS: &[u16] = &[11];
+pub const SUPPORTED_PROTOCOLS: &[u16] = &[11, 12, 13, 14, 15, 16, 17, 18];
 pub const MAX_SUPPORTED_PROTOCOL: u16 = *SUPPORTED_PROTOCOLS.last().unwrap();
 pub const MIN_SUPPORTED_PROTOCOL: u16 = *SUPPORTED_PROTOCOLS.first().unwrap();
 // used for communicating to the user the minimum required mod version for this protocol
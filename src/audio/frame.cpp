@@ -66,8 +66,9 @@ template<> void ByteBuffer::customEncode(const EncodedAudioFrame& frame) {
     }
 }
 
-template<> ByteBuffer::DecodeResult<EncodedAudioFrame> ByteBuffer::customDecode() {
-    EncodedAudioFrame eframe;
+template<> ByteBuffer::DecodeResult<> ByteBuffer::customDecodeInto(EncodedAudioFrame& eframe) {
+    // free the frames left over from the previous use of this instance
+    eframe.clear();
 
     for (size_t i = 0; i < EncodedAudioFrame::VOICE_MAX_FRAMES_IN_AUDIO_FRAME; i++) {
         auto result = this->readValue<std::optional<EncodedOpusData>>();
@@ -80,6 +81,13 @@ template<> ByteBuffer::DecodeResult<EncodedAudioFrame> ByteBuffer::customDecode(
         if (frame) eframe.frames.push_back(frame.value());
     }
 
+    return Ok();
+}
+
+template<> ByteBuffer::DecodeResult<EncodedAudioFrame> ByteBuffer::customDecode() {
+    EncodedAudioFrame eframe;
+    GLOBED_UNWRAP(this->customDecodeInto(eframe));
+
     return Ok(std::move(eframe));
 }
 
@@ -49,5 +49,11 @@ protected:
     size_t _capacity;
 };
 
+// decoded in place, so that a pooled VoiceBroadcastPacket frees its previous frames
+template <>
+struct CustomDecodeInto<EncodedAudioFrame> {
+    static constexpr bool ENABLED = true;
+};
+
 
 #endif // GLOBED_VOICE_SUPPORT
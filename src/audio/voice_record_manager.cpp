@@ -52,6 +52,7 @@ void VoiceRecordingManager::threadFunc(decltype(thread)::StopToken&) {
 
                 // `frame` does not live long enough and will be destructed at the end of this callback.
                 // so we can't pass it directly in a `VoicePacket` and we use a `RawPacket` instead.
+                // its buffer gets encrypted directly into the socket's send buffer, so this is the only copy made.
 
                 ByteBuffer buf;
                 buf.writeValue(frame);
@@ -19,6 +19,7 @@
 // # define GLOBED_DEBUG_INTERPOLATION // dump all interpolation stuff
 // # define GLOBED_DEBUG_PACKETS // log all incoming and outgoing packets & bandwidth
 // # define GLOBED_DEBUG_PACKETS_PRINT // also print each packet
+// # define GLOBED_DEBUG_NET_LATENCY // measure how long outgoing packets wait in the queue before being sent
 
 #endif // GLOBED_DEBUG
 
@@ -0,0 +1,131 @@
+#include "session_box.hpp"
+
+#include <cstring> // std::memcpy, std::memmove
+#include <sodium.h>
+
+#include <util/crypto.hpp>
+#include <defs/assert.hpp>
+#include <defs/minimal_geode.hpp>
+
+using namespace util::data;
+
+// must match the labels used by the server
+constexpr static std::string_view CLIENT_KEY_LABEL = "globed session c2s";
+constexpr static std::string_view SERVER_KEY_LABEL = "globed session s2c";
+
+constexpr static size_t NONCE_LEN = crypto_secretbox_xchacha20poly1305_NONCEBYTES;
+
+static_assert(SessionBox::KEY_LEN == crypto_secretbox_xchacha20poly1305_KEYBYTES);
+static_assert(SessionBox::MAC_LEN == crypto_secretbox_xchacha20poly1305_MACBYTES);
+static_assert(SessionBox::SEED_LEN == crypto_auth_hmacsha256_KEYBYTES);
+
+static void deriveKey(byte* out, const byte* seed, std::string_view label) {
+    CRYPTO_ERR_CHECK(
+        crypto_auth_hmacsha256(out, reinterpret_cast<const byte*>(label.data()), label.size(), seed),
+        "crypto_auth_hmacsha256 failed"
+    )
+}
+
+SessionBox::SessionBox(const byte* seed, bool server) {
+    memBasePtr = reinterpret_cast<byte*>(sodium_malloc(KEY_LEN * 2));
+
+    CRYPTO_REQUIRE(memBasePtr != nullptr, "sodium_malloc returned nullptr")
+
+    txKey = memBasePtr; // base + 0
+    rxKey = txKey + KEY_LEN; // base + 32
+
+    deriveKey(txKey, seed, server ? SERVER_KEY_LABEL : CLIENT_KEY_LABEL);
+    deriveKey(rxKey, seed, server ? CLIENT_KEY_LABEL : SERVER_KEY_LABEL);
+}
+
+SessionBox::~SessionBox() {
+    if (memBasePtr) {
+        sodium_free(memBasePtr);
+    }
+}
+
+Result<size_t> SessionBox::encryptInto(Channel channel, const byte* src, byte* dest, size_t size) {
+    auto& seq = txSeq[static_cast<size_t>(channel)];
+
+    // a nonce must never repeat, reconnecting creates a new session long before this happens
+    CRYPTO_REQUIRE_SAFE(seq != UINT32_MAX, "session sequence numbers exhausted")
+    seq++;
+
+    byte nonce[NONCE_LEN];
+    this->makeNonce(nonce, channel, seq);
+
+    byte* mac = dest + SEQ_LEN;
+    byte* ciphertext = mac + MAC_LEN;
+
+    CRYPTO_ERR_CHECK_SAFE(crypto_secretbox_xchacha20poly1305_detached(ciphertext, mac, src, size, nonce, txKey), "crypto_secretbox_xchacha20poly1305_detached failed")
+
+    uint32_t wireSeq = maybeByteswap(seq);
+    std::memcpy(dest, &wireSeq, SEQ_LEN);
+
+    return Ok(size + PREFIX_LEN);
+}
+
+Result<size_t> SessionBox::encryptInPlace(Channel channel, byte* data, size_t size) {
+    // secretbox can encrypt in place as long as the plaintext and the ciphertext start at the same address
+    std::memmove(data + PREFIX_LEN, data, size);
+    return this->encryptInto(channel, data + PREFIX_LEN, data, size);
+}
+
+Result<size_t> SessionBox::decryptInPlace(Channel channel, byte* data, size_t size) {
+    CRYPTO_REQUIRE_SAFE(size >= PREFIX_LEN, "message is too short")
+
+    uint32_t seq;
+    std::memcpy(&seq, data, SEQ_LEN);
+    seq = maybeByteswap(seq);
+
+    auto& window = rxWindow[static_cast<size_t>(channel)];
+    CRYPTO_REQUIRE_SAFE(window.check(seq), "replayed or outdated packet")
+
+    byte nonce[NONCE_LEN];
+    this->makeNonce(nonce, channel, seq);
+
+    size_t plaintextLength = size - PREFIX_LEN;
+    const byte* mac = data + SEQ_LEN;
+    byte* text = data + PREFIX_LEN;
+
+    CRYPTO_ERR_CHECK_SAFE(crypto_secretbox_xchacha20poly1305_open_detached(text, text, mac, plaintextLength, nonce, rxKey), "crypto_secretbox_xchacha20poly1305_open_detached failed")
+
+    // only move the window once we know the packet is genuine, otherwise anyone could push it forward
+    window.accept(seq);
+
+    std::memmove(data, text, plaintextLength);
+
+    return Ok(plaintextLength);
+}
+
+void SessionBox::makeNonce(byte* nonce, Channel channel, uint32_t seq) {
+    std::memset(nonce, 0, NONCE_LEN);
+
+    nonce[0] = static_cast<byte>(channel);
+
+    uint32_t beSeq = maybeByteswap(seq);
+    std::memcpy(nonce + 1, &beSeq, sizeof(beSeq));
+}
+
+bool SessionBox::ReplayWindow::check(uint32_t seq) const {
+    // sequence numbers start at 1
+    if (seq == 0) return false;
+    if (seq > highest) return true;
+    if (ordered) return false;
+
+    uint32_t age = highest - seq;
+    if (age >= SIZE) return false;
+
+    return (seen & (1ULL << age)) == 0;
+}
+
+void SessionBox::ReplayWindow::accept(uint32_t seq) {
+    if (seq > highest) {
+        uint32_t shift = seq - highest;
+        seen = shift >= SIZE ? 0 : (seen << shift);
+        seen |= 1;
+        highest = seq;
+    } else {
+        seen |= 1ULL << (highest - seq);
+    }
+}
@@ -0,0 +1,84 @@
+#pragma once
+#include "box.hpp"
+
+/*
+* SessionBox - symmetric cipher used for all encrypted packets once the handshake is done
+*
+* Algorithm - XChaCha20Poly1305 (secretbox)
+* Tag implementation - prefix, but with a 4-byte sequence number instead of a 24-byte random nonce
+*
+* The server generates a random seed and sends it sealed with the `CryptoBox` in the handshake response,
+* and both sides derive one key per direction from it with HMAC-SHA256. Since every key is only ever used by one sender,
+* the nonce can be a plain counter: the channel (TCP or UDP) and the sequence number, which is the only part sent on the wire.
+*
+* Received sequence numbers go through a replay window. TCP is ordered, so anything not newer than the last accepted packet is rejected,
+* while UDP packets may arrive out of order by up to `ReplayWindow::SIZE` packets.
+*/
+
+class SessionBox {
+    using byte = util::data::byte;
+
+public:
+    enum class Channel : uint8_t {
+        Tcp = 0,
+        Udp = 1,
+    };
+
+    constexpr static size_t KEY_LEN = 32;
+    constexpr static size_t SEED_LEN = 32;
+    constexpr static size_t MAC_LEN = 16;
+    constexpr static size_t SEQ_LEN = sizeof(uint32_t);
+
+    constexpr static size_t PREFIX_LEN = SEQ_LEN + MAC_LEN;
+    // size of the seed in `CryptoHandshakeResponsePacket`, after being encrypted by `CryptoBox`
+    constexpr static size_t SEALED_SEED_LEN = SEED_LEN + CryptoBox::PREFIX_LEN;
+
+    // Derive the client's session keys from the seed received in the handshake.
+    // `server` swaps the directions, which is only useful for testing.
+    SessionBox(const byte* seed, bool server = false);
+    SessionBox(const SessionBox&) = delete;
+    SessionBox& operator=(const SessionBox&) = delete;
+    ~SessionBox();
+
+    // Encrypt `size` bytes from `src` into `dest`, which must be at least `size + PREFIX_LEN` bytes big.
+    // `src` must either not overlap with `dest` at all, or be exactly `dest + PREFIX_LEN`.
+    // Returns the length of the encrypted data.
+    Result<size_t> encryptInto(Channel channel, const byte* src, byte* dest, size_t size);
+
+    // Encrypt `size` bytes from `data` into itself. The buffer must be at least `size + PREFIX_LEN` bytes big.
+    // Returns the length of the encrypted data.
+    Result<size_t> encryptInPlace(Channel channel, byte* data, size_t size);
+
+    // Decrypt `size` bytes from `data` into itself. Fails if the message was forged, or if it was already received.
+    // Returns the length of the plaintext data.
+    Result<size_t> decryptInPlace(Channel channel, byte* data, size_t size);
+
+    class ReplayWindow {
+    public:
+        constexpr static uint32_t SIZE = 64;
+
+        ReplayWindow(bool ordered) : ordered(ordered) {}
+
+        // Whether a packet with this sequence number could be accepted. Does not modify the window.
+        bool check(uint32_t seq) const;
+        // Mark the sequence number as received, must only be called once the packet is authenticated.
+        void accept(uint32_t seq);
+
+    private:
+        bool ordered;
+        uint32_t highest = 0;
+        uint64_t seen = 0; // bit N is set if `highest - N` was received
+    };
+
+private:
+    byte* memBasePtr = nullptr;
+    byte* txKey;
+    byte* rxKey;
+
+    // only touched while encoding, and all packets are encoded under the socket's send lock
+    uint32_t txSeq[2] = {0, 0};
+    // only touched while decrypting, which is done by the crypto worker thread
+    ReplayWindow rxWindow[2] = {ReplayWindow(true), ReplayWindow(false)};
+
+    static void makeNonce(byte* nonce, Channel channel, uint32_t seq);
+};
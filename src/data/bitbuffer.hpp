@@ -46,6 +46,14 @@ public:
         }
     }
 
+    // Write the lowest `Bits` bits of `value`, most significant first
+    template <size_t Bits> requires (Bits > 0 && Bits <= BitCount)
+    void writeUnsigned(uint64_t value) {
+        for (size_t i = Bits; i > 0; i--) {
+            writeBit((value >> (i - 1)) & 1);
+        }
+    }
+
     bool readBit() {
         GLOBED_REQUIRE(position != BitCount, "BitBuffer tried to read too many bits");
         size_t actualPosition = BitCount - ++position;
@@ -62,6 +70,17 @@ public:
         (readBitInto(args), ...);
     }
 
+    // Read `Bits` bits written with `writeUnsigned`
+    template <size_t Bits> requires (Bits > 0 && Bits <= BitCount)
+    uint64_t readUnsigned() {
+        uint64_t value = 0;
+        for (size_t i = 0; i < Bits; i++) {
+            value = (value << 1) | static_cast<uint64_t>(readBit());
+        }
+
+        return value;
+    }
+
     UnderlyingType contents() const {
         return static_cast<UnderlyingType>(bitset.to_ullong());
     }
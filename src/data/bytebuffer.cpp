@@ -32,24 +32,74 @@ ByteBuffer::ByteBuffer(const byte* data, size_t length)
 ByteBuffer::ByteBuffer(bytevector&& data)
     : _data(std::move(data)) {}
 
+ByteBuffer::ByteBuffer(byte* data, size_t length, borrow_t)
+    : _borrowedData(data), _borrowedSize(length) {}
+
+ByteBuffer::ByteBuffer(const ByteBuffer& other)
+    : _data(other.isBorrowed() ? bytevector(other._borrowedData, other._borrowedData + other._borrowedSize) : other._data),
+      _position(other._position) {}
+
+ByteBuffer& ByteBuffer::operator=(const ByteBuffer& other) {
+    if (this == &other) return *this;
+
+    if (other.isBorrowed()) {
+        _data.assign(other._borrowedData, other._borrowedData + other._borrowedSize);
+    } else {
+        _data = other._data;
+    }
+
+    _borrowedData = nullptr;
+    _borrowedSize = 0;
+    _position = other._position;
+
+    return *this;
+}
+
+ByteBuffer::ByteBuffer(ByteBuffer&& other) noexcept
+    : _data(std::move(other._data)),
+      _borrowedData(std::exchange(other._borrowedData, nullptr)),
+      _borrowedSize(std::exchange(other._borrowedSize, 0)),
+      _position(std::exchange(other._position, 0)) {}
+
+ByteBuffer& ByteBuffer::operator=(ByteBuffer&& other) noexcept {
+    if (this == &other) return *this;
+
+    _data = std::move(other._data);
+    _borrowedData = std::exchange(other._borrowedData, nullptr);
+    _borrowedSize = std::exchange(other._borrowedSize, 0);
+    _position = std::exchange(other._position, 0);
+
+    return *this;
+}
+
+void ByteBuffer::detach() {
+    if (!this->isBorrowed()) return;
+
+    _data = bytevector(_borrowedData, _borrowedData + _borrowedSize);
+    _borrowedData = nullptr;
+    _borrowedSize = 0;
+}
+
 void ByteBuffer::rawWriteBytes(const byte* bytes, size_t length) {
-    // if we can't fit (i.e. writing at the end, just use insert)
+    std::memcpy(this->prepareWrite(length), bytes, length);
+}
+
+byte* ByteBuffer::prepareWrite(size_t length) {
+    this->detach();
+
+    // overwrite existing elements, growing the buffer if writing past the end
     if (_position + length > _data.size()) {
-        _data.insert(_data.begin() + _position, bytes, bytes + length);
-        // remove leftover elements
-        _data.reserve(_position + length);
-    } else {
-        // otherwise, overwrite existing elements
-        for (size_t i = 0; i < length; i++) {
-            _data.data()[_position + i] = bytes[i];
-        }
+        _data.resize(_position + length);
     }
 
+    byte* out = _data.data() + _position;
     _position += length;
+
+    return out;
 }
 
 DecodeResult<> ByteBuffer::boundsCheck(size_t count) {
-    if (_position + count > _data.size()) {
+    if (_position + count > this->size()) {
         return Err(DecodeError::NotEnoughData);
     }
 
@@ -59,20 +109,36 @@ DecodeResult<> ByteBuffer::boundsCheck(size_t count) {
 /* Util methods */
 
 const bytevector& ByteBuffer::data() const {
+    GLOBED_REQUIRE(!this->isBorrowed(), "ByteBuffer::data() const called on a borrowed buffer");
     return _data;
 }
 
 bytevector& ByteBuffer::data() {
+    this->detach();
     return _data;
 }
 
+byte* ByteBuffer::rawData() {
+    return this->isBorrowed() ? _borrowedData : _data.data();
+}
+
+const byte* ByteBuffer::rawData() const {
+    return this->isBorrowed() ? _borrowedData : _data.data();
+}
+
+bool ByteBuffer::isBorrowed() const {
+    return _borrowedData != nullptr;
+}
+
 void ByteBuffer::clear() {
     _data.clear();
+    _borrowedData = nullptr;
+    _borrowedSize = 0;
     _position = 0;
 }
 
 size_t ByteBuffer::size() const {
-    return _data.size();
+    return this->isBorrowed() ? _borrowedSize : _data.size();
 }
 
 size_t ByteBuffer::getPosition() const {
@@ -84,9 +150,21 @@ void ByteBuffer::setPosition(size_t pos) {
 }
 
 void ByteBuffer::resize(size_t newSize) {
+    // shrinking a borrowed buffer can be done without copying
+    if (this->isBorrowed() && newSize <= _borrowedSize) {
+        _borrowedSize = newSize;
+        return;
+    }
+
+    this->detach();
     _data.resize(newSize);
 }
 
+void ByteBuffer::reserve(size_t capacity) {
+    this->detach();
+    _data.reserve(capacity);
+}
+
 void ByteBuffer::grow(size_t bytes) {
     this->resize(this->size() + bytes);
 }
@@ -104,7 +182,7 @@ DecodeResult<> ByteBuffer::skip(size_t bytes) {
 
 DecodeResult<> ByteBuffer::readBytesInto(byte* buf, size_t bytes) {
     GLOBED_UNWRAP(this->boundsCheck(bytes));
-    std::memcpy(buf, _data.data() + _position, bytes);
+    std::memcpy(buf, this->rawData() + _position, bytes);
     _position += bytes;
 
     return Ok();
@@ -128,7 +206,7 @@ template<> DecodeResult<std::string> ByteBuffer::customDecode() {
 
     GLOBED_UNWRAP(this->boundsCheck(length));
 
-    std::string str(reinterpret_cast<const char*>(_data.data() + _position), length);
+    std::string str(reinterpret_cast<const char*>(this->rawData() + _position), length);
     _position += length;
 
     return Ok(std::move(str));
@@ -212,6 +290,7 @@ template<> DecodeResult<ccColor4B> ByteBuffer::customDecode() {
 
 MAKE_ARRAY_FUNCS(10)
 MAKE_ARRAY_FUNCS(32)
+MAKE_ARRAY_FUNCS(72) // SessionBox::SEALED_SEED_LEN
 
 /* Boring ass methods */
 
@@ -11,9 +11,17 @@
 #include "types/basic/either.hpp"
 #include "bitbuffer.hpp"
 #include "bitfield.hpp"
+#include "encoded_size.hpp"
 #include <util/data.hpp>
 #include <util/misc.hpp>
 
+// Specialize with `ENABLED = true` for a type that implements `ByteBuffer::customDecodeInto`,
+// so that `readValueInto` can decode it into an existing instance and keep the capacity of its containers.
+template <typename T>
+struct CustomDecodeInto {
+    static constexpr bool ENABLED = false;
+};
+
 class ByteBuffer {
     using length_t = uint16_t;
 
@@ -44,11 +52,22 @@ public:
     // Take ownership of the given `bytevector` and construct a `ByteBuffer` from the data
     ByteBuffer(util::data::bytevector&& data);
 
-    ByteBuffer(const ByteBuffer& other) = default;
-    ByteBuffer& operator=(const ByteBuffer& other) = default;
+    // Tag type for constructing a borrowed `ByteBuffer`
+    struct borrow_t {};
+    static constexpr borrow_t borrow{};
+
+    // Construct a `ByteBuffer` that borrows the given memory instead of copying it, the memory must outlive the buffer.
+    // Reads (and in-place modifications through `rawData`) work directly on the borrowed memory,
+    // while any write or growing resize first copies the data into an owned buffer.
+    ByteBuffer(util::data::byte* data, size_t length, borrow_t);
+
+    // Copying a borrowed buffer copies the borrowed memory, so the copy is always owned and never aliases the original
+    ByteBuffer(const ByteBuffer& other);
+    ByteBuffer& operator=(const ByteBuffer& other);
 
-    ByteBuffer(ByteBuffer&& other) = default;
-    ByteBuffer& operator=(ByteBuffer&& other) = default;
+    // Moving a borrowed buffer moves the borrow, the moved-from buffer is left empty
+    ByteBuffer(ByteBuffer&& other) noexcept;
+    ByteBuffer& operator=(ByteBuffer&& other) noexcept;
 
     // Read a value from this bytebuffer
     template <typename T>
@@ -70,6 +89,23 @@ public:
         }
     }
 
+    // Read a value into an existing instance. Unlike `readValue`, vectors (also when nested in structs) are decoded in place
+    // and keep their capacity, so decoding into a reused object stops allocating once it has grown large enough.
+    // On failure, `out` is left in a valid but unspecified state.
+    template <typename T>
+    DecodeResult<> readValueInto(T& out) {
+        if constexpr (boost::describe::has_describe_members<T>::value && !IsSerializableBitfield<T> && !EncodedSize<T>::FLAT) {
+            return this->reflectionDecodeInto<T>(out);
+        } else if constexpr (asp::is_std_vector<T>::value) {
+            return this->pcDecodeVectorInto<typename T::value_type>(out);
+        } else if constexpr (CustomDecodeInto<T>::ENABLED) {
+            return this->customDecodeInto<T>(out);
+        } else {
+            GLOBED_UNWRAP_INTO(this->readValue<T>(), out);
+            return Ok();
+        }
+    }
+
     // Write a value to this bytebuffer
     template <typename T>
     void writeValue(const T& value) {
@@ -91,18 +127,29 @@ public:
     template <typename T>
     DecodeResult<T> customDecode();
 
+    // Read a commonly encodable type into an existing instance, see `CustomDecodeInto`.
+    template <typename T>
+    DecodeResult<> customDecodeInto(T& out);
+
     // Write a commonly encodable type. Can be specialized for any type to enable encoding ability.
     template <typename T>
     void customEncode(const T& value);
 
     /* Various helper methods */
 
-    // Get the underlying data buffer of this `ByteBuffer`
+    // Get the underlying data buffer of this `ByteBuffer`. Must not be called on a borrowed buffer.
     const util::data::bytevector& data() const;
 
-    // Get the underlying data buffer of this `ByteBuffer`
+    // Get the underlying data buffer of this `ByteBuffer`. If the buffer is borrowed, the data is copied into an owned buffer first.
     util::data::bytevector& data();
 
+    // Get a pointer to the start of the data, works for both owned and borrowed buffers
+    util::data::byte* rawData();
+    const util::data::byte* rawData() const;
+
+    // Returns whether this buffer borrows its memory rather than owning it
+    bool isBorrowed() const;
+
     // Clear all the data in this buffer
     void clear();
 
@@ -118,6 +165,9 @@ public:
     // Resize the internal buffer to `newSize` bytes
     void resize(size_t newSize);
 
+    // Make sure the buffer can grow to `capacity` bytes in total without reallocating
+    void reserve(size_t capacity);
+
     // Equivalent to `resize(size() + bytes)`
     void grow(size_t bytes);
 
@@ -183,7 +233,7 @@ protected:
         GLOBED_UNWRAP(this->boundsCheck(sizeof(T)));
 
         T value;
-        std::memcpy(&value, _data.data() + _position, sizeof(T));
+        std::memcpy(&value, this->rawData() + _position, sizeof(T));
         _position += sizeof(T);
 
         return Ok(value);
@@ -200,6 +250,10 @@ protected:
     // Like `rawWrite` but accepts a raw buffer
     void rawWriteBytes(const util::data::byte* bytes, size_t length);
 
+    // Make `length` bytes at the current position writable, growing the buffer if needed.
+    // Returns a pointer to them and advances the position past them.
+    util::data::byte* prepareWrite(size_t length);
+
     // Read a primitive `T`, performing endianness conversions
     template <typename T>
     DecodeResult<T> readPrimitive() {
@@ -233,23 +287,26 @@ protected:
         GLOBED_UNWRAP_INTO(this->readPrimitive<P>(), P underlying);
 
         // validate the enum - if there's no descriptor matching the decoded value, raise an error
+        if (!isValidEnumValue<E>(underlying)) {
+            return Err(DecodeError::InvalidEnumValue);
+        }
+
+        return Ok(static_cast<E>(underlying));
+    }
 
+    template <typename E>
+    static bool isValidEnumValue(std::underlying_type_t<E> underlying) {
         bool foundMatch = false;
 
         boost::mp11::mp_for_each<boost::describe::describe_enumerators<E>>([&](auto descriptor) {
             E val = descriptor.value;
-            P valUnderlying = static_cast<P>(val);
 
-            if (valUnderlying == underlying) {
+            if (static_cast<std::underlying_type_t<E>>(val) == underlying) {
                 foundMatch = true;
             }
         });
 
-        if (!foundMatch) {
-            return Err(DecodeError::InvalidEnumValue);
-        }
-
-        return Ok(static_cast<E>(underlying));
+        return foundMatch;
     }
 
     // Write an enum
@@ -283,6 +340,21 @@ protected:
             checkMissingFields<T>();
         }
 
+        // fixed size structs of primitives get a single bounds check for the whole struct
+        if constexpr (EncodedSize<T>::FLAT) {
+            GLOBED_UNWRAP(this->boundsCheck(EncodedSize<T>::SIZE));
+
+            T value;
+            const util::data::byte* in = this->rawData() + _position;
+            if (!flatDecode(in, value)) {
+                return Err(DecodeError::InvalidEnumValue);
+            }
+
+            _position += EncodedSize<T>::SIZE;
+
+            return Ok(std::move(value));
+        }
+
         // create a default initialized instance
         T value;
 
@@ -312,6 +384,36 @@ protected:
         return Ok(std::move(value));
     }
 
+    // Read a value using boost reflection into an existing instance, field by field
+    template <
+        typename T,
+        class Md = boost::describe::describe_members<T, boost::describe::mod_public>
+    >
+    DecodeResult<> reflectionDecodeInto(T& out) {
+        static_assert(std::is_class_v<T>, "attempted to call reflectionDecodeInto on a non-class type");
+
+        checkMissingFields<T>();
+
+        bool failed = false;
+        DecodeError failError;
+
+        boost::mp11::mp_for_each<Md>([&, this](auto descriptor) -> void {
+            if (failed) return;
+
+            auto result = this->readValueInto(out.*descriptor.pointer);
+            if (result.isErr()) {
+                failed = true;
+                failError = result.unwrapErr();
+            }
+        });
+
+        if (failed) {
+            return Err(std::move(failError));
+        }
+
+        return Ok();
+    }
+
     // Write a value using boost reflection
     template <
         typename T,
@@ -331,23 +433,32 @@ protected:
             checkMissingFields<T>();
         }
 
+        if constexpr (EncodedSize<T>::FLAT) {
+            util::data::byte* out = this->prepareWrite(EncodedSize<T>::SIZE);
+            flatEncode(value, out);
+            return;
+        }
+
         boost::mp11::mp_for_each<Md>([&, this](auto descriptor) {
             this->writeValue(value.*descriptor.pointer);
         });
     }
 
+    template <typename T>
+    static constexpr size_t bitfieldBitCount() {
+        static_assert(sizeof(T) <= 64, "unable to encode a bitfield with over 64 fields");
+
+        // so evil
+        return util::data::bitsToBytes(sizeof(T)) * 8;
+    }
+
     template <
         typename T,
         class Md = boost::describe::describe_members<T, boost::describe::mod_public>
     >
-    DecodeResult<T> reflectionDecodeBitfield() {
-        static_assert(sizeof(T) <= 64, "unable to decode a bitfield with over 64 fields");
-
-        constexpr size_t bitcount = util::data::bitsToBytes(sizeof(T)) * 8;
-        GLOBED_UNWRAP_INTO(this->readBits<bitcount>(), auto bits);
-
+    static T bitfieldFromBits(BitBuffer<bitfieldBitCount<T>()> bits) {
         T value;
-        boost::mp11::mp_for_each<Md>([&, this](auto descriptor) -> void {
+        boost::mp11::mp_for_each<Md>([&](auto descriptor) -> void {
             using MPT = decltype(descriptor.pointer);
             using FT = typename asp::member_ptr_to_underlying<MPT>::type;
 
@@ -356,21 +467,17 @@ protected:
             value.*descriptor.pointer = bits.readBit();
         });
 
-        return Ok(std::move(value));
+        return value;
     }
 
     template <
         typename T,
         class Md = boost::describe::describe_members<T, boost::describe::mod_public>
     >
-    void reflectionEncodeBitfield(const T& value) {
-        static_assert(sizeof(T) <= 64, "unable to encode a bitfield with over 64 fields");
+    static BitBuffer<bitfieldBitCount<T>()> bitfieldToBits(const T& value) {
+        BitBuffer<bitfieldBitCount<T>()> bits;
 
-        // so evil
-        constexpr size_t bitcount = util::data::bitsToBytes(sizeof(T)) * 8;
-        BitBuffer<bitcount> bits;
-
-        boost::mp11::mp_for_each<Md>([&, this](auto descriptor) -> void {
+        boost::mp11::mp_for_each<Md>([&](auto descriptor) -> void {
             using MPT = decltype(descriptor.pointer);
             using FT = typename asp::member_ptr_to_underlying<MPT>::type;
 
@@ -379,7 +486,70 @@ protected:
             bits.writeBit(value.*descriptor.pointer);
         });
 
-        this->writeBits(bits);
+        return bits;
+    }
+
+    template <typename T>
+    DecodeResult<T> reflectionDecodeBitfield() {
+        GLOBED_UNWRAP_INTO(this->readBits<bitfieldBitCount<T>()>(), auto bits);
+        return Ok(bitfieldFromBits<T>(bits));
+    }
+
+    template <typename T>
+    void reflectionEncodeBitfield(const T& value) {
+        this->writeBits(bitfieldToBits<T>(value));
+    }
+
+    /* Flat types (see `EncodedSize<T>::FLAT`), the caller is responsible for bounds checking */
+
+    template <typename T>
+    static void flatEncode(const T& value, util::data::byte*& out) {
+        if constexpr (util::data::IsPrimitive<T>) {
+            T swapped = util::data::maybeByteswap(value);
+            std::memcpy(out, &swapped, sizeof(T));
+            out += sizeof(T);
+        } else if constexpr (std::is_enum_v<T>) {
+            flatEncode(static_cast<std::underlying_type_t<T>>(value), out);
+        } else if constexpr (std::is_empty_v<T>) {
+            // zst, do nothing
+        } else if constexpr (IsSerializableBitfield<T>) {
+            flatEncode(bitfieldToBits<T>(value).contents(), out);
+        } else {
+            boost::mp11::mp_for_each<boost::describe::describe_members<T, boost::describe::mod_public>>([&](auto descriptor) {
+                flatEncode(value.*descriptor.pointer, out);
+            });
+        }
+    }
+
+    // Returns false if an invalid enum value was encountered
+    template <typename T>
+    static bool flatDecode(const util::data::byte*& in, T& value) {
+        if constexpr (util::data::IsPrimitive<T>) {
+            std::memcpy(&value, in, sizeof(T));
+            value = util::data::maybeByteswap(value);
+            in += sizeof(T);
+            return true;
+        } else if constexpr (std::is_enum_v<T>) {
+            std::underlying_type_t<T> underlying;
+            flatDecode(in, underlying);
+            value = static_cast<T>(underlying);
+            return isValidEnumValue<T>(underlying);
+        } else if constexpr (std::is_empty_v<T>) {
+            return true;
+        } else if constexpr (IsSerializableBitfield<T>) {
+            BitBufferUnderlyingType<bitfieldBitCount<T>()> underlying;
+            flatDecode(in, underlying);
+            value = bitfieldFromBits<T>(BitBuffer<bitfieldBitCount<T>()>(underlying));
+            return true;
+        } else {
+            bool valid = true;
+            boost::mp11::mp_for_each<boost::describe::describe_members<T, boost::describe::mod_public>>([&](auto descriptor) {
+                // keep going even after a failure, the bytes have been bounds checked already
+                valid = flatDecode(in, value.*descriptor.pointer) && valid;
+            });
+
+            return valid;
+        }
     }
 
     /* Some templated specializations */
@@ -410,7 +580,7 @@ protected:
         } else if constexpr (util::misc::is_either<T>::value) {
             this->pcEncodeEither(value);
         } else if constexpr (std::is_same_v<T, ByteBuffer>) {
-            this->rawWriteBytes(value.data().data(), value.size());
+            this->rawWriteBytes(value.rawData(), value.size());
         } else {
             this->customEncode(value);
         }
@@ -436,6 +606,33 @@ protected:
         return Ok(out);
     }
 
+    template<typename T>
+    DecodeResult<> pcDecodeVectorInto(std::vector<T>& out) {
+        GLOBED_UNWRAP_INTO(this->readLength(), auto length);
+
+        // same limit as in `pcDecodeVector`, don't let a bogus length allocate a huge vector upfront
+        if constexpr (std::is_default_constructible_v<T>) {
+            if (sizeof(T) * length < (2 << 15)) {
+                out.resize(length);
+
+                for (auto& elem : out) {
+                    GLOBED_UNWRAP(this->readValueInto(elem));
+                }
+
+                return Ok();
+            }
+        }
+
+        out.clear();
+
+        for (size_t i = 0; i < length; i++) {
+            GLOBED_UNWRAP_INTO(this->readValue<T>(), T val);
+            out.emplace_back(std::move(val));
+        }
+
+        return Ok();
+    }
+
     template<typename T>
     void pcEncodeVector(const std::vector<T>& vec) {
         this->writeLength(vec.size());
@@ -558,7 +755,12 @@ protected:
 private:
     // Data members
     util::data::bytevector _data;
+    util::data::byte* _borrowedData = nullptr;
+    size_t _borrowedSize = 0;
     size_t _position = 0;
+
+    // Copy the borrowed memory into `_data` and stop borrowing. Does nothing if the buffer is already owned.
+    void detach();
 };
 
 // Custom error formatter
@@ -0,0 +1,215 @@
+#pragma once
+#include <defs/minimal_geode.hpp>
+
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <asp/misc/traits.hpp>
+#include <boost/describe.hpp>
+#include <boost/mp11.hpp>
+
+#include "bitbuffer.hpp"
+#include "bitfield.hpp"
+#include "types/basic/either.hpp"
+#include <util/data.hpp>
+#include <util/misc.hpp>
+
+class ByteBuffer;
+
+// Specialize for a type encoded with `ByteBuffer::customEncode`, so that its encoded size can be known ahead of time.
+// Fixed size types set `FIXED = true` and `SIZE`, others set `FIXED = false` and provide a static `of(const T&)`.
+template <typename T>
+struct CustomEncodedSize {
+    static constexpr bool KNOWN = false;
+};
+
+template <typename T>
+constexpr bool IsSerializableBitfield = [] {
+    using Bd = boost::describe::describe_bases<T, boost::describe::mod_any_access>;
+
+    if constexpr (boost::mp11::mp_empty<Bd>::value) {
+        return false;
+    } else {
+        return std::is_same_v<typename boost::mp11::mp_first<Bd>::type, BitfieldBase>;
+    }
+}();
+
+template <typename T>
+struct EncodedSize;
+
+struct EncodedSizeInfo {
+    bool known, fixed, flat;
+    size_t size;
+};
+
+// Must be a free function, as a static member function can't be evaluated inside its own class
+template <typename T>
+constexpr EncodedSizeInfo calculateEncodedSize() {
+    if constexpr (util::data::IsPrimitive<T>) {
+        return {true, true, true, sizeof(T)};
+    } else if constexpr (std::is_enum_v<T>) {
+        return {true, true, true, sizeof(std::underlying_type_t<T>)};
+    } else if constexpr (std::is_empty_v<T>) {
+        return {true, true, true, 0};
+    } else if constexpr (boost::describe::has_describe_members<T>::value) {
+        if constexpr (IsSerializableBitfield<T>) {
+            return {true, true, true, sizeof(BitBufferUnderlyingType<util::data::bitsToBytes(sizeof(T)) * 8>)};
+        } else {
+            EncodedSizeInfo info{true, true, true, 0};
+
+            boost::mp11::mp_for_each<boost::describe::describe_members<T, boost::describe::mod_public>>([&](auto descriptor) {
+                using FT = typename asp::member_ptr_to_underlying<decltype(descriptor.pointer)>::type;
+
+                info.known = info.known && EncodedSize<FT>::KNOWN;
+                info.fixed = info.fixed && EncodedSize<FT>::FIXED;
+                info.flat = info.flat && EncodedSize<FT>::FLAT;
+                info.size += EncodedSize<FT>::SIZE;
+            });
+
+            info.fixed = info.fixed && info.known;
+            info.flat = info.flat && info.fixed;
+            return info;
+        }
+    } else if constexpr (asp::is_std_vector<T>::value || asp::is_std_optional<T>::value) {
+        return {EncodedSize<typename T::value_type>::KNOWN, false, false, 0};
+    } else if constexpr (asp::is_std_pair<T>::value) {
+        using A = EncodedSize<typename T::first_type>;
+        using B = EncodedSize<typename T::second_type>;
+        return {A::KNOWN && B::KNOWN, A::FIXED && B::FIXED, false, A::SIZE + B::SIZE};
+    } else if constexpr (util::misc::is_either<T>::value) {
+        return {EncodedSize<typename T::first_type>::KNOWN && EncodedSize<typename T::second_type>::KNOWN, false, false, 0};
+    } else if constexpr (std::is_same_v<T, ByteBuffer>) {
+        return {true, false, false, 0};
+    } else if constexpr (CustomEncodedSize<T>::KNOWN) {
+        if constexpr (CustomEncodedSize<T>::FIXED) {
+            return {true, true, false, CustomEncodedSize<T>::SIZE};
+        } else {
+            return {true, false, false, 0};
+        }
+    } else {
+        return {false, false, false, 0};
+    }
+}
+
+/*
+* EncodedSize<T> - compile-time knowledge about how many bytes `ByteBuffer::writeValue<T>` produces.
+*
+* KNOWN - whether the size can be calculated at all. Custom encoded types are unknown unless `CustomEncodedSize` is specialized.
+* FIXED - whether every value encodes into exactly `SIZE` bytes.
+* FLAT - whether the type is fixed size and made only of primitives, enums, bitfields and other flat structs.
+*        Those are encoded and decoded with a single bounds check, without going through `writeValue`/`readValue` per field.
+* of(value) - the exact encoded size of `value`, or 0 if it is not known.
+*/
+template <typename T>
+struct EncodedSize {
+private:
+    // must match `ByteBuffer::length_t`
+    static constexpr size_t LENGTH_SIZE = sizeof(uint16_t);
+    static constexpr EncodedSizeInfo INFO = calculateEncodedSize<T>();
+
+public:
+    static constexpr bool KNOWN = INFO.known;
+    static constexpr bool FIXED = INFO.fixed;
+    static constexpr bool FLAT = INFO.flat;
+    // 0 unless `FIXED`
+    static constexpr size_t SIZE = INFO.fixed ? INFO.size : 0;
+
+    static size_t of(const T& value) {
+        if constexpr (!KNOWN) {
+            return 0;
+        } else if constexpr (FIXED) {
+            return SIZE;
+        } else if constexpr (boost::describe::has_describe_members<T>::value) {
+            size_t total = 0;
+
+            boost::mp11::mp_for_each<boost::describe::describe_members<T, boost::describe::mod_public>>([&](auto descriptor) {
+                using FT = typename asp::member_ptr_to_underlying<decltype(descriptor.pointer)>::type;
+                total += EncodedSize<FT>::of(value.*descriptor.pointer);
+            });
+
+            return total;
+        } else if constexpr (asp::is_std_vector<T>::value) {
+            using Elem = EncodedSize<typename T::value_type>;
+
+            if constexpr (Elem::FIXED) {
+                return LENGTH_SIZE + value.size() * Elem::SIZE;
+            } else {
+                size_t total = LENGTH_SIZE;
+                for (const auto& elem : value) {
+                    total += Elem::of(elem);
+                }
+
+                return total;
+            }
+        } else if constexpr (asp::is_std_optional<T>::value) {
+            return sizeof(bool) + (value ? EncodedSize<typename T::value_type>::of(*value) : 0);
+        } else if constexpr (asp::is_std_pair<T>::value) {
+            return EncodedSize<typename T::first_type>::of(value.first) + EncodedSize<typename T::second_type>::of(value.second);
+        } else if constexpr (util::misc::is_either<T>::value) {
+            return sizeof(bool) + (value.isFirst()
+                ? EncodedSize<typename T::first_type>::of(value.firstRef()->get())
+                : EncodedSize<typename T::second_type>::of(value.secondRef()->get()));
+        } else if constexpr (std::is_same_v<T, ByteBuffer>) {
+            return value.size();
+        } else {
+            return CustomEncodedSize<T>::of(value);
+        }
+    }
+};
+
+/* Sizes of the types that ByteBuffer encodes itself */
+
+template <>
+struct CustomEncodedSize<std::string_view> {
+    static constexpr bool KNOWN = true;
+    static constexpr bool FIXED = false;
+
+    static size_t of(std::string_view value) {
+        return sizeof(uint16_t) + value.size();
+    }
+};
+
+template <>
+struct CustomEncodedSize<std::string> {
+    static constexpr bool KNOWN = true;
+    static constexpr bool FIXED = false;
+
+    static size_t of(const std::string& value) {
+        return sizeof(uint16_t) + value.size();
+    }
+};
+
+template <size_t N>
+struct CustomEncodedSize<util::data::bytearray<N>> {
+    static constexpr bool KNOWN = true;
+    static constexpr bool FIXED = true;
+    static constexpr size_t SIZE = N;
+};
+
+template <>
+struct CustomEncodedSize<cocos2d::CCPoint> {
+    static constexpr bool KNOWN = true;
+    static constexpr bool FIXED = true;
+    static constexpr size_t SIZE = sizeof(float) * 2;
+};
+
+template <>
+struct CustomEncodedSize<cocos2d::CCSize> {
+    static constexpr bool KNOWN = true;
+    static constexpr bool FIXED = true;
+    static constexpr size_t SIZE = sizeof(float) * 2;
+};
+
+template <>
+struct CustomEncodedSize<cocos2d::ccColor3B> {
+    static constexpr bool KNOWN = true;
+    static constexpr bool FIXED = true;
+    static constexpr size_t SIZE = 3;
+};
+
+template <>
+struct CustomEncodedSize<cocos2d::ccColor4B> {
+    static constexpr bool KNOWN = true;
+    static constexpr bool FIXED = true;
+    static constexpr size_t SIZE = 4;
+};
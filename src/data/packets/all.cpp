@@ -1,6 +1,8 @@
 #include "all.hpp"
 
 #define PACKET(pt) case pt::PACKET_ID: return std::make_shared<pt>()
+// for packets received many times per second, see `PacketPool`
+#define POOLED_PACKET(pt) case pt::PACKET_ID: return PacketPool<pt>::get().acquire()
 
 std::shared_ptr<Packet> matchPacket(packetid_t packetId) {
     switch (packetId) {
@@ -28,13 +30,15 @@ std::shared_ptr<Packet> matchPacket(packetid_t packetId) {
         PACKET(LevelListPacket);
         PACKET(LevelPlayerCountPacket);
         PACKET(RolesUpdatedPacket);
+        PACKET(LevelListDeltaPacket);
 
         // game related
 
         PACKET(PlayerProfilesPacket);
-        PACKET(LevelDataPacket);
-        PACKET(LevelPlayerMetadataPacket);
-        PACKET(VoiceBroadcastPacket);
+        POOLED_PACKET(LevelDataPacket);
+        POOLED_PACKET(LevelDataDeltaPacket);
+        POOLED_PACKET(LevelPlayerMetadataPacket);
+        POOLED_PACKET(VoiceBroadcastPacket);
         PACKET(ChatMessageBroadcastPacket);
 
         // room related
@@ -47,6 +51,7 @@ std::shared_ptr<Packet> matchPacket(packetid_t packetId) {
         PACKET(RoomInvitePacket);
         PACKET(RoomListPacket);
         PACKET(RoomCreateFailedPacket);
+        PACKET(RoomPlayerListDeltaPacket);
 
         // admin related
 
@@ -59,4 +64,13 @@ std::shared_ptr<Packet> matchPacket(packetid_t packetId) {
         default:
             return std::shared_ptr<Packet>(nullptr);
     }
-}
\ No newline at end of file
+}
+
+std::vector<PacketPoolStats> getPacketPoolStats() {
+    return {
+        PacketPool<LevelDataPacket>::get().stats(),
+        PacketPool<LevelDataDeltaPacket>::get().stats(),
+        PacketPool<LevelPlayerMetadataPacket>::get().stats(),
+        PacketPool<VoiceBroadcastPacket>::get().stats(),
+    };
+}
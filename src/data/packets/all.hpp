@@ -12,10 +12,12 @@
 * 3. add the GLOBED_ENCODE or GLOBED_DECODE method
 * 4. For client packets, you may also choose to add a ::create(...) function and/or a constructor
 * 5. For server packets, in `all.cpp` add the packet to the switch as PACKET(cls).
+*    Packets received every frame should use POOLED_PACKET(cls) instead, and be added to `getPacketPoolStats`.
 */
 
 #pragma once
 #include "packet.hpp"
+#include "pool.hpp"
 
 #include "client/admin.hpp"
 #include "client/connection.hpp"
@@ -31,4 +33,7 @@
 #include "server/room.hpp"
 
 // Matches a packet by packet ID, returns nullptr if not found. Otherwise returns an Packet pointer with uninitialized data
-std::shared_ptr<Packet> matchPacket(packetid_t packetId);
\ No newline at end of file
+std::shared_ptr<Packet> matchPacket(packetid_t packetId);
+
+// Returns the allocation counters of every packet pool used by `matchPacket`
+std::vector<PacketPoolStats> getPacketPoolStats();
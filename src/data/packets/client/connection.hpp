@@ -34,9 +34,12 @@ class KeepalivePacket : public Packet {
     GLOBED_PACKET(10002, KeepalivePacket, false, false)
 
     KeepalivePacket() {}
+    KeepalivePacket(uint64_t _clientTime) : clientTime(_clientTime) {}
+
+    uint64_t clientTime; // `ClockSync::localMicros`
 };
 
-GLOBED_SERIALIZABLE_STRUCT(KeepalivePacket, ());
+GLOBED_SERIALIZABLE_STRUCT(KeepalivePacket, (clientTime));
 
 // 10003 - LoginPacket
 class LoginPacket : public Packet {
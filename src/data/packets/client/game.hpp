@@ -45,6 +45,23 @@ class PlayerDataPacket : public Packet {
 };
 GLOBED_SERIALIZABLE_STRUCT(PlayerDataPacket, (data, meta));
 
+// 12005 - PlayerDataDeltaPacket
+// `ack` is the newest received LevelDataDeltaPacket, bit `n` of `ackBits` is set if `ack - 1 - n` was received too.
+class PlayerDataDeltaPacket : public Packet {
+    GLOBED_PACKET(12005, PlayerDataDeltaPacket, false, false)
+
+    PlayerDataDeltaPacket() {}
+
+    uint32_t seq;
+    uint8_t baselineOffset;
+    uint32_t ack;
+    uint32_t ackBits;
+    bool needsKeyframe;
+    PlayerDataDelta data;
+    std::optional<PlayerMetadata> meta;
+};
+GLOBED_SERIALIZABLE_STRUCT(PlayerDataDeltaPacket, (seq, baselineOffset, ack, ackBits, needsKeyframe, data, meta));
+
 #ifdef GLOBED_VOICE_SUPPORT
 
 #include <audio/frame.hpp>
@@ -57,3 +57,27 @@ class UpdatePlayerStatusPacket : public Packet {
 };
 
 GLOBED_SERIALIZABLE_STRUCT(UpdatePlayerStatusPacket, (flags));
+
+// 11005 - RequestLevelListDeltaPacket
+class RequestLevelListDeltaPacket : public Packet {
+    GLOBED_PACKET(11005, RequestLevelListDeltaPacket, false, false)
+
+    RequestLevelListDeltaPacket() {}
+    RequestLevelListDeltaPacket(uint32_t version) : version(version) {}
+
+    uint32_t version;
+};
+
+GLOBED_SERIALIZABLE_STRUCT(RequestLevelListDeltaPacket, (version));
+
+// 11006 - SubscribePlayerCountsPacket
+class SubscribePlayerCountsPacket : public Packet {
+    GLOBED_PACKET(11006, SubscribePlayerCountsPacket, false, false)
+
+    SubscribePlayerCountsPacket() {}
+    SubscribePlayerCountsPacket(std::vector<LevelId>&& levelIds) : levelIds(std::move(levelIds)) {}
+
+    std::vector<LevelId> levelIds;
+};
+
+GLOBED_SERIALIZABLE_STRUCT(SubscribePlayerCountsPacket, (levelIds));
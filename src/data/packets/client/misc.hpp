@@ -31,6 +31,14 @@ public:
         buf.writeValue<ByteBuffer>(buffer);
     }
 
+    size_t encodedSize() const override {
+        return buffer.size();
+    }
+
+    const ByteBuffer* getEncodedPayload() const override {
+        return &buffer;
+    }
+
     ByteBuffer::DecodeResult<> decode(ByteBuffer& buf) override {
         throw std::runtime_error("RawPacket cannot be decoded");
     }
@@ -87,3 +87,14 @@ class CloseRoomPacket : public Packet {
     CloseRoomPacket() {}
 };
 GLOBED_SERIALIZABLE_STRUCT(CloseRoomPacket, ());
+
+// 13009 - RequestRoomPlayerListDeltaPacket
+class RequestRoomPlayerListDeltaPacket : public Packet {
+    GLOBED_PACKET(13009, RequestRoomPlayerListDeltaPacket, false, false)
+
+    RequestRoomPlayerListDeltaPacket() {}
+    RequestRoomPlayerListDeltaPacket(uint32_t version) : version(version) {}
+
+    uint32_t version;
+};
+GLOBED_SERIALIZABLE_STRUCT(RequestRoomPlayerListDeltaPacket, (version));
@@ -21,9 +21,11 @@ using packetid_t = uint16_t;
         using NonCvTy = typename std::remove_cv_t<InstTy>; \
         buf.writeValue<NonCvTy>(*this); \
     } \
+    size_t encodedSize() const override { \
+        return EncodedSize<std::remove_cv_t<std::remove_reference_t<decltype(*this)>>>::of(*this); \
+    } \
     ByteBuffer::DecodeResult<> decode(ByteBuffer& buf) override { \
-        GLOBED_UNWRAP_INTO(buf.readValue<std::remove_reference_t<decltype(*this)>>(), *this); \
-        return Ok(); \
+        return buf.readValueInto<std::remove_reference_t<decltype(*this)>>(*this); \
     } \
     template <typename... Args> \
     static std::shared_ptr<Packet> create(Args&&... args) { \
@@ -35,14 +37,33 @@ public:
     // Encodes the packet into a bytebuffer
     virtual void encode(ByteBuffer& buf) const = 0;
 
-    // Decodes the packet from a bytebuffer
+    // Decodes the packet from a bytebuffer, overwriting every field. Vectors are decoded in place and keep their capacity.
     virtual ByteBuffer::DecodeResult<> decode(ByteBuffer& buf) = 0;
 
+    // Returns the exact size of the encoded packet (without the header), or 0 if it can't be known ahead of time
+    virtual size_t encodedSize() const = 0;
+
+    // For packets that hold already encoded data (see `RawPacket`), returns that data,
+    // so that it can be sent without being copied into the send buffer first. Returns nullptr for regular packets.
+    virtual const ByteBuffer* getEncodedPayload() const {
+        return nullptr;
+    }
+
     virtual packetid_t getPacketId() const = 0;
     virtual bool getUseTcp() const = 0;
     virtual bool getEncrypted() const = 0;
     virtual const char* getPacketName() const = 0;
 
+    // If true, only the newest instance of this packet is delivered to listeners when several are queued up at once,
+    // the older ones are dropped. Meant for state snapshots where an outdated one is useless once a newer one arrived.
+    virtual bool getLatestWins() const {
+        return false;
+    }
+
+    // Called on a latest-wins packet when it replaces an older queued instance of the same packet,
+    // to carry over anything from the older one that must not be lost along with it.
+    virtual void mergeDropped(const Packet& older) {}
+
     template <typename T>
     requires std::is_base_of_v<Packet, T>
     bool isInstanceOf() {
@@ -62,10 +83,22 @@ public:
 };
 
 struct PacketHeader {
-    static constexpr size_t SIZE = sizeof(packetid_t) + sizeof(bool);
+    static constexpr size_t SIZE = sizeof(packetid_t) + sizeof(uint8_t);
+
+    static constexpr uint8_t FLAG_ENCRYPTED = 1 << 0;
+    // the body is compressed with `util::compress`, only ever set by the server (since protocol v16)
+    static constexpr uint8_t FLAG_COMPRESSED = 1 << 1;
 
     packetid_t id;
-    bool encrypted;
+    uint8_t flags;
+
+    bool encrypted() const {
+        return flags & FLAG_ENCRYPTED;
+    }
+
+    bool compressed() const {
+        return flags & FLAG_COMPRESSED;
+    }
 };
 
-GLOBED_SERIALIZABLE_STRUCT(PacketHeader, (id, encrypted));
+GLOBED_SERIALIZABLE_STRUCT(PacketHeader, (id, flags));
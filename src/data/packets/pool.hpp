@@ -0,0 +1,74 @@
+#pragma once
+#include "packet.hpp"
+
+#include <atomic>
+#include <asp/sync.hpp>
+
+struct PacketPoolStats {
+    const char* packetName;
+    size_t allocations; // instances that had to be allocated on the heap
+    size_t reuses;      // instances handed out again without allocating
+    size_t pooled;      // instances owned by the pool
+};
+
+/*
+* PacketPool<T> - recycles instances of a frequently received packet type.
+*
+* The pool keeps a reference to up to `CAPACITY` instances. Once every other reference to one of them is dropped
+* (i.e. the last listener is done with it), it gets handed out again by `acquire`. The instance is not destroyed or reset,
+* so its vectors keep their capacity, and decoding into it with `ByteBuffer::readValueInto` doesn't allocate.
+* If all pooled instances are in use, a new one is allocated and kept if there's room left.
+*
+* Acquired packets contain leftover data from their previous use, the caller must fully overwrite them.
+*/
+template <typename T>
+requires std::is_base_of_v<Packet, T>
+class PacketPool {
+public:
+    static constexpr size_t CAPACITY = 16;
+
+    static PacketPool& get() {
+        static PacketPool instance;
+        return instance;
+    }
+
+    std::shared_ptr<T> acquire() {
+        auto entries = this->entries.lock();
+
+        for (auto& entry : *entries) {
+            // the pool holds the only reference left, so nobody else can be using it anymore
+            if (entry.use_count() == 1) {
+                // pairs with the release decrement done when the last other reference was dropped (possibly on another thread)
+                std::atomic_thread_fence(std::memory_order_acquire);
+                reuses.fetch_add(1, std::memory_order_relaxed);
+                return entry;
+            }
+        }
+
+        allocations.fetch_add(1, std::memory_order_relaxed);
+
+        auto packet = std::make_shared<T>();
+        if (entries->size() < CAPACITY) {
+            entries->push_back(packet);
+        }
+
+        return packet;
+    }
+
+    PacketPoolStats stats() {
+        return PacketPoolStats {
+            .packetName = T::PACKET_NAME,
+            .allocations = allocations.load(std::memory_order_relaxed),
+            .reuses = reuses.load(std::memory_order_relaxed),
+            .pooled = entries.lock()->size(),
+        };
+    }
+
+private:
+    asp::Mutex<std::vector<std::shared_ptr<T>>> entries;
+    std::atomic<size_t> allocations = 0, reuses = 0;
+
+    PacketPool() {
+        entries.lock()->reserve(CAPACITY);
+    }
+};
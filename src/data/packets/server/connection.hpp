@@ -3,6 +3,7 @@
 #include <data/types/crypto.hpp>
 #include <data/types/gd.hpp>
 #include <data/types/user.hpp>
+#include <crypto/session_box.hpp>
 
 // 20000 - PingResponsePacket
 class PingResponsePacket : public Packet {
@@ -21,8 +22,10 @@ class CryptoHandshakeResponsePacket : public Packet {
     CryptoHandshakeResponsePacket() {}
 
     CryptoPublicKey data;
+    // encrypted with the `CryptoBox`, see `SessionBox`
+    util::data::bytearray<SessionBox::SEALED_SEED_LEN> sessionSeed;
 };
-GLOBED_SERIALIZABLE_STRUCT(CryptoHandshakeResponsePacket, (data));
+GLOBED_SERIALIZABLE_STRUCT(CryptoHandshakeResponsePacket, (data, sessionSeed));
 
 // 20002 - KeepaliveResponsePacket
 class KeepaliveResponsePacket : public Packet {
@@ -31,8 +34,10 @@ class KeepaliveResponsePacket : public Packet {
     KeepaliveResponsePacket() {}
 
     uint32_t playerCount;
+    uint64_t clientTime; // echoed from `KeepalivePacket`
+    uint64_t serverTime; // microseconds since the unix epoch
 };
-GLOBED_SERIALIZABLE_STRUCT(KeepaliveResponsePacket, (playerCount));
+GLOBED_SERIALIZABLE_STRUCT(KeepaliveResponsePacket, (playerCount, clientTime, serverTime));
 
 // 20003 - ServerDisconnectPacket
 class ServerDisconnectPacket : public Packet {
@@ -19,11 +19,36 @@ class LevelDataPacket : public Packet {
 
     LevelDataPacket() {}
 
+    bool getLatestWins() const override {
+        return true;
+    }
+
+    // the server splits a tick across several packets, and jumps and spider teleports only show up in a single snapshot,
+    // so keep the players and events from the dropped packet
+    void mergeDropped(const Packet& older) override {
+        AssociatedPlayerData::mergeDropped(players, static_cast<const LevelDataPacket&>(older).players);
+    }
+
     std::vector<AssociatedPlayerData> players;
 };
 
 GLOBED_SERIALIZABLE_STRUCT(LevelDataPacket, (players));
 
+// 22003 - LevelDataDeltaPacket
+// `ack` is the newest of our snapshots applied by the server, `needsKeyframe` is set if it could not apply a delta.
+class LevelDataDeltaPacket : public Packet {
+    GLOBED_PACKET(22003, LevelDataDeltaPacket, false, false)
+
+    LevelDataDeltaPacket() {}
+
+    uint32_t seq;
+    uint32_t ack;
+    bool needsKeyframe;
+    QuantizedPlayerDataDeltas players;
+};
+
+GLOBED_SERIALIZABLE_STRUCT(LevelDataDeltaPacket, (seq, ack, needsKeyframe, players));
+
 // 22002 - LevelPlayerMetadataPacket
 class LevelPlayerMetadataPacket : public Packet {
     GLOBED_PACKET(22002, LevelPlayerMetadataPacket, false, false)
@@ -46,3 +46,16 @@ class RolesUpdatedPacket : public Packet {
 };
 
 GLOBED_SERIALIZABLE_STRUCT(RolesUpdatedPacket, (specialUserData));
+
+// 21004 - LevelListDeltaPacket
+class LevelListDeltaPacket : public Packet {
+    GLOBED_PACKET(21004, LevelListDeltaPacket, false, false)
+
+    LevelListDeltaPacket() {}
+
+    uint32_t baseVersion, version;
+    std::vector<GlobedLevel> upserted;
+    std::vector<LevelId> removed;
+};
+
+GLOBED_SERIALIZABLE_STRUCT(LevelListDeltaPacket, (baseVersion, version, upserted, removed));
@@ -85,3 +85,16 @@ class RoomCreateFailedPacket : public Packet {
     std::string reason;
 };
 GLOBED_SERIALIZABLE_STRUCT(RoomCreateFailedPacket, (reason));
+
+// 23008 - RoomPlayerListDeltaPacket
+class RoomPlayerListDeltaPacket : public Packet {
+    GLOBED_PACKET(23008, RoomPlayerListDeltaPacket, false, false)
+
+    RoomPlayerListDeltaPacket() {}
+
+    RoomInfo info;
+    uint32_t baseVersion, version;
+    std::vector<PlayerRoomPreviewAccountData> upserted;
+    std::vector<int32_t> removed;
+};
+GLOBED_SERIALIZABLE_STRUCT(RoomPlayerListDeltaPacket, (info, baseVersion, version, upserted, removed));
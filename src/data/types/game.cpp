@@ -19,11 +19,31 @@ void SpecificIconData::copyFlagsFrom(const SpecificIconData& other) {
     isSideways = other.isSideways;
 }
 
-template<> void ByteBuffer::customEncode(const SpecificIconData& data) {
-    this->writeValue(data.position);
-    this->writeValue(data.rotation);
-    this->writeValue(data.iconType);
+void SpecificIconData::mergeEventsFrom(const SpecificIconData& older) {
+    didJustJump = didJustJump || older.didJustJump;
+
+    if (!spiderTeleportData && older.spiderTeleportData) {
+        spiderTeleportData = older.spiderTeleportData;
+    }
+}
+
+void AssociatedPlayerData::mergeDropped(std::vector<AssociatedPlayerData>& players, const std::vector<AssociatedPlayerData>& older) {
+    size_t newerCount = players.size();
+
+    for (const auto& olderPlayer : older) {
+        auto end = players.begin() + newerCount;
+        auto it = std::find_if(players.begin(), end, [&](const auto& p) { return p.accountId == olderPlayer.accountId; });
 
+        if (it == end) {
+            players.push_back(olderPlayer);
+        } else {
+            it->data.player1.mergeEventsFrom(olderPlayer.data.player1);
+            it->data.player2.mergeEventsFrom(olderPlayer.data.player2);
+        }
+    }
+}
+
+static BitBuffer<16> iconFlags(const SpecificIconData& data) {
     BitBuffer<16> bits;
     bits.writeBits(
         data.isVisible,
@@ -38,19 +58,11 @@ template<> void ByteBuffer::customEncode(const SpecificIconData& data) {
         data.isRotating,
         data.isSideways
     );
-    this->writeBits(bits);
 
-    this->writeValue(data.spiderTeleportData);
+    return bits;
 }
 
-template<> ByteBuffer::DecodeResult<SpecificIconData> ByteBuffer::customDecode() {
-    SpecificIconData data;
-
-    GLOBED_UNWRAP_INTO(this->readValue<CCPoint>(), data.position);
-    GLOBED_UNWRAP_INTO(this->readValue<float>(), data.rotation);
-    GLOBED_UNWRAP_INTO(this->readValue<PlayerIconType>(), data.iconType);
-
-    GLOBED_UNWRAP_INTO(this->readBits<16>(), auto bits);
+static void setIconFlags(SpecificIconData& data, BitBuffer<16> bits) {
     bits.readBitsInto(
         data.isVisible,
         data.isLookingLeft,
@@ -64,6 +76,35 @@ template<> ByteBuffer::DecodeResult<SpecificIconData> ByteBuffer::customDecode()
         data.isRotating,
         data.isSideways
     );
+}
+
+static BitBuffer<8> playerFlags(const PlayerData& data) {
+    BitBuffer<8> bits;
+    bits.writeBits(data.isDead, data.isPaused, data.isPracticing, data.isDualMode, data.isInEditor, data.isEditorBuilding, data.isLastDeathReal, data.isTimestampSynced);
+    return bits;
+}
+
+static void setPlayerFlags(PlayerData& data, BitBuffer<8> bits) {
+    bits.readBitsInto(data.isDead, data.isPaused, data.isPracticing, data.isDualMode, data.isInEditor, data.isEditorBuilding, data.isLastDeathReal, data.isTimestampSynced);
+}
+
+template<> void ByteBuffer::customEncode(const SpecificIconData& data) {
+    this->writeValue(data.position);
+    this->writeValue(data.rotation);
+    this->writeValue(data.iconType);
+    this->writeBits(iconFlags(data));
+    this->writeValue(data.spiderTeleportData);
+}
+
+template<> ByteBuffer::DecodeResult<SpecificIconData> ByteBuffer::customDecode() {
+    SpecificIconData data;
+
+    GLOBED_UNWRAP_INTO(this->readValue<CCPoint>(), data.position);
+    GLOBED_UNWRAP_INTO(this->readValue<float>(), data.rotation);
+    GLOBED_UNWRAP_INTO(this->readValue<PlayerIconType>(), data.iconType);
+
+    GLOBED_UNWRAP_INTO(this->readBits<16>(), auto bits);
+    setIconFlags(data, bits);
 
     GLOBED_UNWRAP_INTO(this->readValue<std::optional<SpiderTeleportData>>(), data.spiderTeleportData);
 
@@ -76,10 +117,7 @@ template<> void ByteBuffer::customEncode(const PlayerData& data) {
     this->writeValue(data.player2);
     this->writeValue(data.lastDeathTimestamp);
     this->writeValue(data.currentPercentage);
-
-    BitBuffer<8> bits;
-    bits.writeBits(data.isDead, data.isPaused, data.isPracticing, data.isDualMode, data.isInEditor, data.isEditorBuilding, data.isLastDeathReal);
-    this->writeBits(bits);
+    this->writeBits(playerFlags(data));
 }
 
 template<> ByteBuffer::DecodeResult<PlayerData> ByteBuffer::customDecode() {
@@ -92,7 +130,263 @@ template<> ByteBuffer::DecodeResult<PlayerData> ByteBuffer::customDecode() {
     GLOBED_UNWRAP_INTO(this->readValue<float>(), data.currentPercentage);
 
     GLOBED_UNWRAP_INTO(this->readBits<8>(), auto bits);
-    bits.readBitsInto(data.isDead, data.isPaused, data.isPracticing, data.isDualMode, data.isInEditor, data.isEditorBuilding, data.isLastDeathReal);
+    setPlayerFlags(data, bits);
 
     return Ok(data);
 }
+
+size_t CustomEncodedSize<SpecificIconData>::of(const SpecificIconData& data) {
+    return EncodedSize<CCPoint>::SIZE
+        + EncodedSize<float>::SIZE
+        + EncodedSize<PlayerIconType>::SIZE
+        + sizeof(BitBufferUnderlyingType<16>)
+        + EncodedSize<std::optional<SpiderTeleportData>>::of(data.spiderTeleportData);
+}
+
+size_t CustomEncodedSize<PlayerData>::of(const PlayerData& data) {
+    return EncodedSize<float>::SIZE * 3
+        + EncodedSize<SpecificIconData>::of(data.player1)
+        + EncodedSize<SpecificIconData>::of(data.player2)
+        + sizeof(BitBufferUnderlyingType<8>);
+}
+
+/* PlayerDataDelta */
+
+static uint16_t iconDeltaMask(const SpecificIconData& current, const SpecificIconData* baseline) {
+    uint16_t mask = 0;
+
+    if (!baseline || baseline->position.x != current.position.x || baseline->position.y != current.position.y) {
+        mask |= PlayerDataDelta::ICON_POSITION;
+    }
+
+    if (!baseline || baseline->rotation != current.rotation) {
+        mask |= PlayerDataDelta::ICON_ROTATION;
+    }
+
+    if (!baseline || baseline->iconType != current.iconType) {
+        mask |= PlayerDataDelta::ICON_TYPE;
+    }
+
+    if (!baseline || iconFlags(*baseline).contents() != iconFlags(current).contents()) {
+        mask |= PlayerDataDelta::ICON_FLAGS;
+    }
+
+    if (current.spiderTeleportData.has_value()) {
+        mask |= PlayerDataDelta::ICON_SPIDER_TP;
+    }
+
+    return mask;
+}
+
+static void applyIconDelta(SpecificIconData& out, const SpecificIconData& icon, uint16_t mask) {
+    if (mask & PlayerDataDelta::ICON_POSITION) out.position = icon.position;
+    if (mask & PlayerDataDelta::ICON_ROTATION) out.rotation = icon.rotation;
+    if (mask & PlayerDataDelta::ICON_TYPE) out.iconType = icon.iconType;
+    if (mask & PlayerDataDelta::ICON_FLAGS) setIconFlags(out, iconFlags(icon));
+
+    out.spiderTeleportData = icon.spiderTeleportData;
+}
+
+PlayerDataDelta PlayerDataDelta::diff(const PlayerData& current, const PlayerData* baseline) {
+    uint16_t mask = iconDeltaMask(current.player1, baseline ? &baseline->player1 : nullptr) << PLAYER1_SHIFT;
+    mask |= iconDeltaMask(current.player2, baseline ? &baseline->player2 : nullptr) << PLAYER2_SHIFT;
+
+    if (!baseline || baseline->lastDeathTimestamp != current.lastDeathTimestamp) {
+        mask |= LAST_DEATH_TIMESTAMP;
+    }
+
+    if (!baseline || baseline->currentPercentage != current.currentPercentage) {
+        mask |= CURRENT_PERCENTAGE;
+    }
+
+    if (!baseline || playerFlags(*baseline).contents() != playerFlags(current).contents()) {
+        mask |= FLAGS;
+    }
+
+    if (!baseline) {
+        mask |= KEYFRAME;
+    }
+
+    return PlayerDataDelta {
+        .mask = mask,
+        .data = current,
+    };
+}
+
+PlayerData PlayerDataDelta::apply(const PlayerData* baseline) const {
+    PlayerData out = (baseline && !this->isKeyframe()) ? *baseline : PlayerData{};
+    out.timestamp = data.timestamp;
+
+    applyIconDelta(out.player1, data.player1, mask >> PLAYER1_SHIFT);
+    applyIconDelta(out.player2, data.player2, mask >> PLAYER2_SHIFT);
+
+    if (mask & LAST_DEATH_TIMESTAMP) out.lastDeathTimestamp = data.lastDeathTimestamp;
+    if (mask & CURRENT_PERCENTAGE) out.currentPercentage = data.currentPercentage;
+    if (mask & FLAGS) setPlayerFlags(out, playerFlags(data));
+
+    return out;
+}
+
+void PlayerDataDelta::encode(ByteBuffer& buf, const TransformQuantizer* quantizer) const {
+    uint16_t mask = this->mask;
+    if (quantizer) {
+        for (auto shift : {PLAYER1_SHIFT, PLAYER2_SHIFT}) {
+            if (mask & (ICON_POSITION << shift)) {
+                mask |= ICON_ROTATION << shift;
+            }
+        }
+    }
+
+    buf.writeValue(data.timestamp);
+    buf.writeU16(mask);
+
+    for (auto [icon, shift] : {std::pair{&data.player1, PLAYER1_SHIFT}, std::pair{&data.player2, PLAYER2_SHIFT}}) {
+        uint16_t iconMask = mask >> shift;
+
+        if (quantizer) {
+            if (iconMask & ICON_POSITION) buf.writeBits(quantizer->pack(icon->position, icon->rotation));
+            else if (iconMask & ICON_ROTATION) buf.writeU16(TransformQuantizer::quantizeRotation(icon->rotation));
+        } else {
+            if (iconMask & ICON_POSITION) buf.writeValue(icon->position);
+            if (iconMask & ICON_ROTATION) buf.writeValue(icon->rotation);
+        }
+
+        if (iconMask & ICON_TYPE) buf.writeValue(icon->iconType);
+        if (iconMask & ICON_FLAGS) buf.writeBits(iconFlags(*icon));
+        if ((iconMask & ICON_SPIDER_TP) && icon->spiderTeleportData) buf.writeValue(icon->spiderTeleportData.value());
+    }
+
+    if (mask & LAST_DEATH_TIMESTAMP) buf.writeValue(data.lastDeathTimestamp);
+    if (mask & CURRENT_PERCENTAGE) buf.writeValue(data.currentPercentage);
+    if (mask & FLAGS) buf.writeBits(playerFlags(data));
+}
+
+ByteBuffer::DecodeResult<PlayerDataDelta> PlayerDataDelta::decode(ByteBuffer& buf, const TransformQuantizer* quantizer) {
+    PlayerDataDelta delta{};
+
+    GLOBED_UNWRAP_INTO(buf.readValue<float>(), delta.data.timestamp);
+    GLOBED_UNWRAP_INTO(buf.readU16(), delta.mask);
+
+    for (auto [icon, shift] : {std::pair{&delta.data.player1, PLAYER1_SHIFT}, std::pair{&delta.data.player2, PLAYER2_SHIFT}}) {
+        uint16_t mask = delta.mask >> shift;
+
+        if (quantizer) {
+            if (mask & ICON_POSITION) {
+                GLOBED_UNWRAP_INTO(buf.readBits<64>(), auto bits);
+                quantizer->unpack(bits, icon->position, icon->rotation);
+            } else if (mask & ICON_ROTATION) {
+                GLOBED_UNWRAP_INTO(buf.readU16(), auto rot);
+                icon->rotation = TransformQuantizer::dequantizeRotation(rot);
+            }
+        } else {
+            if (mask & ICON_POSITION) {
+                GLOBED_UNWRAP_INTO(buf.readValue<CCPoint>(), icon->position);
+            }
+
+            if (mask & ICON_ROTATION) {
+                GLOBED_UNWRAP_INTO(buf.readValue<float>(), icon->rotation);
+            }
+        }
+
+        if (mask & ICON_TYPE) {
+            GLOBED_UNWRAP_INTO(buf.readValue<PlayerIconType>(), icon->iconType);
+        }
+
+        if (mask & ICON_FLAGS) {
+            GLOBED_UNWRAP_INTO(buf.readBits<16>(), auto bits);
+            setIconFlags(*icon, bits);
+        }
+
+        if (mask & ICON_SPIDER_TP) {
+            GLOBED_UNWRAP_INTO(buf.readValue<SpiderTeleportData>(), icon->spiderTeleportData);
+        }
+    }
+
+    if (delta.mask & LAST_DEATH_TIMESTAMP) {
+        GLOBED_UNWRAP_INTO(buf.readValue<float>(), delta.data.lastDeathTimestamp);
+    }
+
+    if (delta.mask & CURRENT_PERCENTAGE) {
+        GLOBED_UNWRAP_INTO(buf.readValue<float>(), delta.data.currentPercentage);
+    }
+
+    if (delta.mask & FLAGS) {
+        GLOBED_UNWRAP_INTO(buf.readBits<8>(), auto bits);
+        setPlayerFlags(delta.data, bits);
+    }
+
+    return Ok(delta);
+}
+
+size_t CustomEncodedSize<PlayerDataDelta>::of(const PlayerDataDelta& delta) {
+    using D = PlayerDataDelta;
+
+    size_t size = EncodedSize<float>::SIZE + sizeof(uint16_t);
+
+    for (auto [icon, shift] : {std::pair{&delta.data.player1, D::PLAYER1_SHIFT}, std::pair{&delta.data.player2, D::PLAYER2_SHIFT}}) {
+        uint16_t mask = delta.mask >> shift;
+
+        if (mask & D::ICON_POSITION) size += EncodedSize<CCPoint>::SIZE;
+        if (mask & D::ICON_ROTATION) size += EncodedSize<float>::SIZE;
+        if (mask & D::ICON_TYPE) size += EncodedSize<PlayerIconType>::SIZE;
+        if (mask & D::ICON_FLAGS) size += sizeof(BitBufferUnderlyingType<16>);
+        if ((mask & D::ICON_SPIDER_TP) && icon->spiderTeleportData) size += EncodedSize<SpiderTeleportData>::SIZE;
+    }
+
+    if (delta.mask & D::LAST_DEATH_TIMESTAMP) size += EncodedSize<float>::SIZE;
+    if (delta.mask & D::CURRENT_PERCENTAGE) size += EncodedSize<float>::SIZE;
+    if (delta.mask & D::FLAGS) size += sizeof(BitBufferUnderlyingType<8>);
+
+    return size;
+}
+
+template<> void ByteBuffer::customEncode(const PlayerDataDelta& delta) {
+    delta.encode(*this, nullptr);
+}
+
+template<> ByteBuffer::DecodeResult<PlayerDataDelta> ByteBuffer::customDecode() {
+    return PlayerDataDelta::decode(*this, nullptr);
+}
+
+/* TransformQuantizer */
+
+static uint64_t quantizeAxis(float value, float origin) {
+    constexpr int64_t min = -(int64_t(1) << (TransformQuantizer::POSITION_BITS - 1));
+    constexpr int64_t max = (int64_t(1) << (TransformQuantizer::POSITION_BITS - 1)) - 1;
+
+    // clamp as a float first, so that converting huge offsets to an integer is well defined
+    float scaled = std::clamp(std::round((value - origin) * TransformQuantizer::POSITION_SCALE), (float) min, (float) max);
+    return static_cast<uint64_t>(static_cast<int64_t>(scaled)) & ((uint64_t(1) << TransformQuantizer::POSITION_BITS) - 1);
+}
+
+static float dequantizeAxis(uint64_t bits, float origin) {
+    // sign-extend the offset
+    constexpr size_t shift = 32 - TransformQuantizer::POSITION_BITS;
+    int32_t q = static_cast<int32_t>(static_cast<uint32_t>(bits) << shift) >> shift;
+
+    return origin + static_cast<float>(q) / TransformQuantizer::POSITION_SCALE;
+}
+
+BitBuffer<64> TransformQuantizer::pack(CCPoint position, float rotation) const {
+    BitBuffer<64> bits;
+    bits.writeUnsigned<POSITION_BITS>(quantizeAxis(position.x, origin.x));
+    bits.writeUnsigned<POSITION_BITS>(quantizeAxis(position.y, origin.y));
+    bits.writeUnsigned<ROTATION_BITS>(quantizeRotation(rotation));
+    return bits;
+}
+
+void TransformQuantizer::unpack(BitBuffer<64> bits, CCPoint& position, float& rotation) const {
+    position.x = dequantizeAxis(bits.readUnsigned<POSITION_BITS>(), origin.x);
+    position.y = dequantizeAxis(bits.readUnsigned<POSITION_BITS>(), origin.y);
+    rotation = dequantizeRotation(bits.readUnsigned<ROTATION_BITS>());
+}
+
+uint16_t TransformQuantizer::quantizeRotation(float rotation) {
+    float wrapped = std::remainder(rotation, 360.f);
+    // a full turn spans the entire range, so +180 wraps around to -180 as it should
+    return static_cast<uint16_t>(static_cast<int32_t>(std::round(wrapped / 360.f * 65536.f)));
+}
+
+float TransformQuantizer::dequantizeRotation(uint16_t bits) {
+    return static_cast<float>(static_cast<int16_t>(bits)) * 360.f / 65536.f;
+}
@@ -24,6 +24,8 @@ GLOBED_SERIALIZABLE_STRUCT(SpiderTeleportData, (from, to));
 
 struct SpecificIconData {
     void copyFlagsFrom(const SpecificIconData& other);
+    // Carry over the one-frame events (jump, spider teleport) of an older snapshot that is being dropped in favor of this one
+    void mergeEventsFrom(const SpecificIconData& older);
 
     cocos2d::CCPoint position;
     float rotation;
@@ -44,6 +46,14 @@ struct SpecificIconData {
     std::optional<SpiderTeleportData> spiderTeleportData;
 };
 
+template <>
+struct CustomEncodedSize<SpecificIconData> {
+    static constexpr bool KNOWN = true;
+    static constexpr bool FIXED = false;
+
+    static size_t of(const SpecificIconData& data);
+};
+
 struct PlayerData {
     float timestamp;
 
@@ -61,6 +71,101 @@ struct PlayerData {
     bool isInEditor;
     bool isEditorBuilding; // in the editor && not playtesting (incl. not paused)
     bool isLastDeathReal; // for deathlink, to prevent death chains
+    bool isTimestampSynced; // `timestamp` is the wrapped server time from `ClockSync`, rather than the level time
+};
+
+template <>
+struct CustomEncodedSize<PlayerData> {
+    static constexpr bool KNOWN = true;
+    static constexpr bool FIXED = false;
+
+    static size_t of(const PlayerData& data);
+};
+
+class AssociatedPlayerData {
+public:
+    AssociatedPlayerData(int accountId, const PlayerData& data) : accountId(accountId), data(data) {}
+    AssociatedPlayerData() {}
+
+    // Merge the players of an older snapshot that is being dropped into `players`. A player that is in both keeps the newer data
+    // along with the events of the older one, a player that is only in the older snapshot (e.g. sent in another fragment) is kept as is.
+    static void mergeDropped(std::vector<AssociatedPlayerData>& players, const std::vector<AssociatedPlayerData>& older);
+
+    int accountId;
+    PlayerData data;
+};
+
+GLOBED_SERIALIZABLE_STRUCT(AssociatedPlayerData, (
+    accountId, data
+));
+
+// Packs a position and a rotation into 64 bits (protocol v13 and newer), from the most significant bit:
+// 24 bits of x and 24 bits of y, stored as signed fixed-point offsets from `origin` in 1/16 of a unit,
+// then 16 bits of rotation, wrapped into [-180, 180) degrees. Offsets that don't fit are clamped.
+class TransformQuantizer {
+public:
+    static constexpr size_t POSITION_BITS = 24;
+    static constexpr float POSITION_SCALE = 16.f;
+    static constexpr size_t ROTATION_BITS = 16;
+
+    TransformQuantizer(cocos2d::CCPoint origin) : origin(origin) {}
+
+    BitBuffer<64> pack(cocos2d::CCPoint position, float rotation) const;
+    void unpack(BitBuffer<64> bits, cocos2d::CCPoint& position, float& rotation) const;
+
+    static uint16_t quantizeRotation(float rotation);
+    static float dequantizeRotation(uint16_t bits);
+
+    cocos2d::CCPoint origin;
+};
+
+// PlayerData encoded relative to an earlier snapshot (baseline).
+// The timestamp is always present, every other field only if its bit in `mask` is set.
+// Spider teleports are events rather than state, so they are never inherited from the baseline.
+struct PlayerDataDelta {
+    // per-icon bits, shifted by `PLAYER1_SHIFT` or `PLAYER2_SHIFT`
+    static constexpr uint16_t ICON_POSITION = 1 << 0;
+    static constexpr uint16_t ICON_ROTATION = 1 << 1;
+    static constexpr uint16_t ICON_TYPE = 1 << 2;
+    static constexpr uint16_t ICON_FLAGS = 1 << 3;
+    static constexpr uint16_t ICON_SPIDER_TP = 1 << 4;
+    static constexpr uint16_t PLAYER1_SHIFT = 0;
+    static constexpr uint16_t PLAYER2_SHIFT = 5;
+
+    static constexpr uint16_t LAST_DEATH_TIMESTAMP = 1 << 10;
+    static constexpr uint16_t CURRENT_PERCENTAGE = 1 << 11;
+    static constexpr uint16_t FLAGS = 1 << 12;
+    // set if the delta was made without a baseline and contains every field
+    static constexpr uint16_t KEYFRAME = 1 << 15;
+
+    // Create a delta that turns `baseline` into `current`. If `baseline` is nullptr, creates a keyframe.
+    static PlayerDataDelta diff(const PlayerData& current, const PlayerData* baseline);
+
+    // Reconstruct the full data by applying this delta on top of `baseline`. Keyframes ignore the baseline.
+    PlayerData apply(const PlayerData* baseline) const;
+
+    bool isKeyframe() const {
+        return (mask & KEYFRAME) != 0;
+    }
+
+    // Write the delta. If `quantizer` is not nullptr, positions and rotations are quantized with it,
+    // and an icon's rotation is always written together with its position.
+    void encode(ByteBuffer& buf, const TransformQuantizer* quantizer) const;
+
+    // Read a delta written by `encode` with the same quantizer
+    static ByteBuffer::DecodeResult<PlayerDataDelta> decode(ByteBuffer& buf, const TransformQuantizer* quantizer);
+
+    uint16_t mask;
+    PlayerData data;
+};
+
+// the size when encoded without quantization
+template <>
+struct CustomEncodedSize<PlayerDataDelta> {
+    static constexpr bool KNOWN = true;
+    static constexpr bool FIXED = false;
+
+    static size_t of(const PlayerDataDelta& delta);
 };
 
 struct PlayerMetadata {
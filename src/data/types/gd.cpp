@@ -0,0 +1,48 @@
+#include "gd.hpp"
+
+using namespace cocos2d;
+
+template<> void ByteBuffer::customEncode(const QuantizedPlayerDataDeltas& data) {
+    TransformQuantizer quantizer(data.origin);
+
+    this->writeValue(data.origin);
+    this->writeLength(data.entries.size());
+
+    for (const auto& entry : data.entries) {
+        this->writeValue(entry.accountId);
+        this->writeValue(entry.seq);
+        this->writeValue(entry.baselineOffset);
+        entry.delta.encode(*this, &quantizer);
+    }
+}
+
+template<> ByteBuffer::DecodeResult<> ByteBuffer::customDecodeInto(QuantizedPlayerDataDeltas& data) {
+    GLOBED_UNWRAP_INTO(this->readValue<CCPoint>(), data.origin);
+    GLOBED_UNWRAP_INTO(this->readLength(), auto length);
+
+    TransformQuantizer quantizer(data.origin);
+
+    // entries are overwritten in place, so that a reused instance keeps its capacity
+    data.entries.resize(std::min<size_t>(length, 256));
+    for (size_t i = 0; i < length; i++) {
+        if (i == data.entries.size()) {
+            data.entries.emplace_back();
+        }
+
+        auto& entry = data.entries[i];
+
+        GLOBED_UNWRAP_INTO(this->readValue<int>(), entry.accountId);
+        GLOBED_UNWRAP_INTO(this->readValue<uint32_t>(), entry.seq);
+        GLOBED_UNWRAP_INTO(this->readValue<uint8_t>(), entry.baselineOffset);
+        GLOBED_UNWRAP_INTO(PlayerDataDelta::decode(*this, &quantizer), entry.delta);
+    }
+
+    return Ok();
+}
+
+template<> ByteBuffer::DecodeResult<QuantizedPlayerDataDeltas> ByteBuffer::customDecode() {
+    QuantizedPlayerDataDeltas data;
+    GLOBED_UNWRAP(this->customDecodeInto(data));
+
+    return Ok(std::move(data));
+}
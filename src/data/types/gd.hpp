@@ -157,19 +157,37 @@ inline const PlayerAccountData PlayerAccountData::DEFAULT_DATA = PlayerAccountDa
     PlayerIconData::DEFAULT_ICONS
 );
 
-class AssociatedPlayerData {
+// `seq` is the sequence number of the snapshot from the player that owns it, or 0 if that player does not use delta encoding.
+// `baselineOffset` is how many sequence numbers back the baseline is (`seq - baselineOffset`), it is ignored for keyframes.
+class AssociatedPlayerDataDelta {
 public:
-    AssociatedPlayerData(int accountId, const PlayerData& data) : accountId(accountId), data(data) {}
-    AssociatedPlayerData() {}
+    AssociatedPlayerDataDelta() {}
 
     int accountId;
-    PlayerData data;
+    uint32_t seq;
+    uint8_t baselineOffset;
+    PlayerDataDelta delta;
 };
 
-GLOBED_SERIALIZABLE_STRUCT(AssociatedPlayerData, (
-    accountId, data
+GLOBED_SERIALIZABLE_STRUCT(AssociatedPlayerDataDelta, (
+    accountId, seq, baselineOffset, delta
 ));
 
+// The players sent in a LevelDataDeltaPacket (protocol v13 and newer).
+// Their positions and rotations are quantized relative to `origin`, see `TransformQuantizer`.
+class QuantizedPlayerDataDeltas {
+public:
+    QuantizedPlayerDataDeltas() {}
+
+    cocos2d::CCPoint origin;
+    std::vector<AssociatedPlayerDataDelta> entries;
+};
+
+template <>
+struct CustomDecodeInto<QuantizedPlayerDataDeltas> {
+    static constexpr bool ENABLED = true;
+};
+
 class AssociatedPlayerMetadata {
 public:
     AssociatedPlayerMetadata(int accountId, const PlayerMetadata& data) : accountId(accountId), data(data) {}
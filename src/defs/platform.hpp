@@ -16,6 +16,8 @@
 * GLOBED_PLATFORM_STRING_PLATFORM - string in format like "Mac", "Android", "Windows"
 * GLOBED_PLATFORM_STRING_ARCH - string in format like "x86", "x64", "armv7", "arm64"
 * GLOBED_PLATFORM_STRING - those two above combined into one, i.e. "Windows x86"
+*
+* GLOBED_HOST_BUILD - defined by the tools in tools/, which build parts of the mod as a regular executable without Geode
 */
 
 #if !defined(GEODE_IS_WINDOWS)
@@ -57,6 +59,9 @@
 #  define GLOBED_PLATFORM_STRING_ARCH "arm64"
 # define GLOBED_IS_ARM 1
 # define GLOBED_IS_ARM64 1
+#elif defined(GLOBED_HOST_BUILD)
+# define GLOBED_PLATFORM_STRING_PLATFORM "Host"
+# define GLOBED_PLATFORM_STRING_ARCH "native"
 #endif
 
 #define GLOBED_PLATFORM_STRING GLOBED_PLATFORM_STRING_PLATFORM " " GLOBED_PLATFORM_STRING_ARCH
@@ -83,6 +88,10 @@
 # define GLOBED_HAS_FMOD GLOBED_FMOD_IOS
 # define GLOBED_HAS_DRPC GLOBED_DRPC_IOS
 # define GLOBED_HAS_KEYBINDS 0
+#elif defined(GLOBED_HOST_BUILD)
+# define GLOBED_HAS_FMOD 0
+# define GLOBED_HAS_DRPC 0
+# define GLOBED_HAS_KEYBINDS 0
 #else
 # error "what"
 #endif
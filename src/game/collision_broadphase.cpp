@@ -0,0 +1,35 @@
+#include "collision_broadphase.hpp"
+
+#include <cmath>
+
+using namespace geode::prelude;
+
+void CollisionBroadphase::clear() {
+    bodies.clear();
+    maxWidth = 0.f;
+}
+
+void CollisionBroadphase::add(int playerId, bool isSecond, const CCRect& rect) {
+    // positions come from other clients, a NaN would break the ordering
+    if (!std::isfinite(rect.origin.x) || !std::isfinite(rect.origin.y) || !std::isfinite(rect.size.width) || !std::isfinite(rect.size.height)) {
+        return;
+    }
+
+    bodies.push_back(Body {
+        .rect = rect,
+        .playerId = playerId,
+        .isSecond = isSecond,
+    });
+
+    maxWidth = std::max(maxWidth, rect.size.width);
+}
+
+void CollisionBroadphase::build() {
+    std::sort(bodies.begin(), bodies.end(), [](const Body& a, const Body& b) {
+        return a.rect.getMinX() < b.rect.getMinX();
+    });
+}
+
+size_t CollisionBroadphase::size() const {
+    return bodies.size();
+}
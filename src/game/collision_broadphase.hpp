@@ -0,0 +1,52 @@
+#pragma once
+
+#include <algorithm>
+#include <vector>
+
+/*
+* CollisionBroadphase - sorted list of remote player icon bounding boxes, used to find collision candidates.
+*
+* It is rebuilt once per frame and then queried by every physics step of that frame. Boxes are sorted by their left edge,
+* so a query only has to binary search to the first box that could reach the queried rect and walk forward until the boxes
+* start to the right of it. With icons spread out over a level that means a handful of comparisons instead of one per player.
+*/
+class CollisionBroadphase {
+public:
+    struct Body {
+        cocos2d::CCRect rect;
+        int playerId;
+        bool isSecond;
+    };
+
+    // Drops all bodies, keeping the allocation around for the next frame.
+    void clear();
+    void add(int playerId, bool isSecond, const cocos2d::CCRect& rect);
+    // Sorts the bodies added since the last `clear`. Must be called before querying.
+    void build();
+
+    size_t size() const;
+
+    // Calls `callback(const Body&)` for every body whose rect intersects `rect`.
+    template <typename F>
+    void query(const cocos2d::CCRect& rect, F&& callback) const {
+        float minX = rect.getMinX(), maxX = rect.getMaxX();
+        float minY = rect.getMinY(), maxY = rect.getMaxY();
+
+        // nothing that starts further left than this can reach us
+        auto it = std::lower_bound(bodies.begin(), bodies.end(), minX - maxWidth, [](const Body& body, float x) {
+            return body.rect.getMinX() < x;
+        });
+
+        for (; it != bodies.end() && it->rect.getMinX() <= maxX; ++it) {
+            const auto& body = *it;
+
+            if (body.rect.getMaxX() >= minX && body.rect.getMinY() <= maxY && body.rect.getMaxY() >= minY) {
+                callback(body);
+            }
+        }
+    }
+
+private:
+    std::vector<Body> bodies;
+    float maxWidth = 0.f;
+};
@@ -1,90 +1,218 @@
 #include "interpolator.hpp"
 
 #include "lerp_logger.hpp"
-#include <hooks/gjbasegamelayer.hpp>
+#include <net/clock_sync.hpp>
 #include <util/math.hpp>
-#include <util/debug.hpp>
-#include <util/format.hpp>
 
 using namespace geode::prelude;
 
 PlayerInterpolator::PlayerInterpolator(const InterpolatorSettings& settings) : settings(settings) {}
 
 void PlayerInterpolator::addPlayer(int playerId) {
-    players.emplace(playerId, PlayerState {});
+    if (slots.contains(playerId)) return;
+
+    size_t slot;
+    if (!freeSlots.empty()) {
+        slot = freeSlots.back();
+        freeSlots.pop_back();
+    } else {
+        slot = states.size();
+        states.emplace_back();
+        transforms.resize(states.size() * 2);
+    }
+
+    states[slot] = PlayerState {};
+    states[slot].playerId = playerId;
+    states[slot].active = true;
+    slots.emplace(playerId, slot);
+
 #ifdef GLOBED_DEBUG_INTERPOLATION
     LerpLogger::get().reset(playerId);
 #endif
 }
 
 void PlayerInterpolator::removePlayer(int playerId) {
-    players.erase(playerId);
+    auto it = slots.find(playerId);
+    if (it == slots.end()) return;
+
+    states[it->second].active = false;
+    freeSlots.push_back(it->second);
+    slots.erase(it);
 }
 
 bool PlayerInterpolator::hasPlayer(int playerId) {
-    return players.contains(playerId);
+    return slots.contains(playerId);
+}
+
+PlayerInterpolator::PlayerState& PlayerInterpolator::getPlayer(int playerId) {
+    return states[slots.at(playerId)];
+}
+
+// Set the flags of the events that happened in this snapshot, they stay set until `swapFrameFlags` is called
+static inline void raiseEvents(FrameFlags& flags, const PlayerInterpolator::LerpFrame& frame) {
+    if (frame.died) {
+        flags.pendingDeath = true;
+        flags.pendingRealDeath = frame.diedReal;
+    }
+
+    flags.pendingP1Jump = flags.pendingP1Jump || frame.visual.player1.didJustJump;
+    flags.pendingP2Jump = flags.pendingP2Jump || frame.visual.player2.didJustJump;
+
+    if (frame.visual.player1.spiderTeleportData) {
+        flags.pendingP1Teleport = frame.visual.player1.spiderTeleportData;
+    }
+
+    if (frame.visual.player2.spiderTeleportData) {
+        flags.pendingP2Teleport = frame.visual.player2.spiderTeleportData;
+    }
 }
 
 void PlayerInterpolator::updatePlayer(int playerId, const PlayerData& data, float updateCounter) {
-    auto& player = players.at(playerId);
+    auto& player = this->getPlayer(playerId);
     player.updateCounter = updateCounter;
     player.pendingRealFrame = true;
     player.totalFrames++;
 
+    LerpFrame frame(data);
+
     if (!util::math::equal(player.lastDeathTimestamp, data.lastDeathTimestamp)) {
         player.lastDeathTimestamp = data.lastDeathTimestamp;
         if (player.totalFrames > 1) {
-            player.frameFlags.pendingDeath = true;
-            player.frameFlags.pendingRealDeath = data.isLastDeathReal;
+            frame.died = true;
+            frame.diedReal = data.isLastDeathReal;
         }
     }
 
-    player.frameFlags.pendingP1Teleport = data.player1.spiderTeleportData;
-    player.frameFlags.pendingP2Teleport = data.player2.spiderTeleportData;
-    player.frameFlags.pendingP1Jump = data.player1.didJustJump;
-    player.frameFlags.pendingP2Jump = data.player1.didJustJump;
+    // data from senders with a synchronized clock is stamped with the server time, which is the same timeline for everyone
+    auto& clock = ClockSync::get();
+    bool synced = data.isTimestampSynced && clock.isSynced();
+    float timestamp = synced ? this->toSyncedTimeline(clock.unwrap(data.timestamp)) : data.timestamp;
 
-    LerpLogger::get().logRealFrame(playerId, this->getLocalTs(), data.timestamp, data.player1);
+    LerpLogger::get().logRealFrame(playerId, this->getLocalTs(), timestamp, data.player1);
 
     if (settings.realtime) {
         player.interpolatedState = data;
+        raiseEvents(player.frameFlags, frame);
+        return;
+    }
+
+    auto& snapshots = player.snapshots;
+
+    // the player restarted their clock, or switched to or from the synchronized one, start over
+    if (synced != player.timestampsSynced || (!snapshots.empty() && timestamp < snapshots.back().timestamp - TIMESTAMP_RESET_THRESHOLD)) {
+        snapshots.clear();
+        player.timestampsSynced = synced;
+    }
+
+    frame.timestamp = timestamp;
+
+    float transit = localTime - timestamp;
+
+    if (snapshots.empty()) {
+        player.transit = player.lastTransit = transit;
+        player.jitter = 0.f;
+        player.playoutDelay = player.targetDelay = settings.expectedDelta;
+        player.timeCounter = timestamp - player.playoutDelay;
+        player.eventsRaisedUntil = player.timeCounter;
+        player.underrun = false;
+
+        snapshots.insert(frame);
         return;
     }
 
-    player.olderFrame = player.newerFrame;
-    player.newerFrame = data;
+    // RFC 3550 style inter-arrival jitter
+    player.jitter += (std::abs(transit - player.lastTransit) - player.jitter) / 16.f;
+    player.lastTransit = transit;
+
+    // follow faster packets immediately and slower ones only gradually, so that the estimate stays close to the fastest path
+    if (transit < player.transit) {
+        player.transit = transit;
+    } else {
+        player.transit += (transit - player.transit) * TRANSIT_DRIFT;
+    }
+
+    // on a stable connection this is just one packet interval, only jitter makes it longer
+    player.targetDelay = std::clamp(
+        settings.expectedDelta + JITTER_DELAY_FACTOR * player.jitter,
+        settings.expectedDelta,
+        MAX_PLAYOUT_DELAY
+    );
+
+    // grow the delay right away, shrink it slowly in `tick`
+    player.playoutDelay = std::max(player.playoutDelay, player.targetDelay);
+
+    if (timestamp <= player.timeCounter) {
+        player.lateFrames++;
+        // the snapshot won't be shown, but a death or a jump in it still should be
+        raiseEvents(player.frameFlags, frame);
+        return;
+    }
 
-    player.timeCounter = player.olderFrame.timestamp;
+    snapshots.insert(frame);
 }
 
-static inline void lerpSpecific(
+// Project `newer` forward by `time` seconds, using the velocity between the two snapshots
+static inline void extrapolateSpecific(
         const SpecificIconData& older,
         const SpecificIconData& newer,
         SpecificIconData& out,
-        float lerpRatio
+        float frameDelta,
+        float time
     ) {
 
-    out.copyFlagsFrom(older);
+    out = newer;
 
-    // i hate spider
-    if (out.iconType == PlayerIconType::Spider && std::abs(older.position.y - newer.position.y) >= 33.f) {
-        out.position.x = std::lerp(older.position.x, newer.position.x, lerpRatio);
-        out.position.y = older.position.y;
-    } else {
-        out.position = older.position.lerp(newer.position, lerpRatio);
+    // no velocity across a teleport or a gamemode change
+    if (newer.spiderTeleportData || older.iconType != newer.iconType) {
+        return;
     }
-    out.rotation = std::lerp(older.rotation, newer.rotation, lerpRatio);
+
+    auto velocity = (newer.position - older.position) / frameDelta;
+
+    // same as in `lerpTransforms`, a spider flipping gravity teleports vertically
+    if (newer.iconType == PlayerIconType::Spider && std::abs(older.position.y - newer.position.y) >= 33.f) {
+        velocity.y = 0.f;
+    }
+
+    out.position = newer.position + velocity * time;
+    out.rotation = newer.rotation + (newer.rotation - older.rotation) / frameDelta * time;
 }
 
-static inline void lerpPlayer(
-        const VisualPlayerState& older,
-        const VisualPlayerState& newer,
+static inline void extrapolatePlayer(
+        const PlayerInterpolator::LerpFrame& older,
+        const PlayerInterpolator::LerpFrame& newer,
         VisualPlayerState& out,
-        float lerpRatio
+        float time
+    ) {
+
+    float frameDelta = newer.timestamp - older.timestamp;
+
+    // dead or paused players don't move
+    if (frameDelta <= 0.f || newer.visual.isDead || newer.visual.isPaused) {
+        out = newer.visual;
+        return;
+    }
+
+    extrapolateSpecific(older.visual.player1, newer.visual.player1, out.player1, frameDelta, time);
+    extrapolateSpecific(older.visual.player2, newer.visual.player2, out.player2, frameDelta, time);
+
+    out.currentPercentage = newer.visual.currentPercentage;
+    out.isDead = newer.visual.isDead;
+    out.isPaused = newer.visual.isPaused;
+    out.isPracticing = newer.visual.isPracticing;
+    out.isDualMode = newer.visual.isDualMode;
+    out.isInEditor = newer.visual.isInEditor;
+    out.isEditorBuilding = newer.visual.isEditorBuilding;
+}
+
+// Everything except positions and rotations, those are interpolated separately for all players at once
+static inline void lerpPlayerState(
+        const VisualPlayerState& older,
+        VisualPlayerState& out
     ) {
 
-    lerpSpecific(older.player1, newer.player1, out.player1, lerpRatio);
-    lerpSpecific(older.player2, newer.player2, out.player2, lerpRatio);
+    out.player1.copyFlagsFrom(older.player1);
+    out.player2.copyFlagsFrom(older.player2);
 
     out.currentPercentage = older.currentPercentage;
     out.isDead = older.isDead;
@@ -96,32 +224,175 @@ static inline void lerpPlayer(
 }
 
 void PlayerInterpolator::tick(float dt) {
+    localTime += dt;
+
     if (settings.realtime) return;
 
-    for (auto& [playerId, player] : players) {
-        if (player.totalFrames < 2) continue;
+    // first pass: advance playback, then either handle the player right away, or set up their transforms for interpolation
+    for (size_t slot = 0; slot < states.size(); slot++) {
+        auto& player = states[slot];
+        player.lerping = false;
+
+        auto& snapshots = player.snapshots;
+        if (!player.active || snapshots.empty()) continue;
+
+        int playerId = player.playerId;
+
+        if (player.playoutDelay > player.targetDelay) {
+            player.playoutDelay = std::max(player.targetDelay, player.playoutDelay - DELAY_DECAY_RATE * dt);
+        }
+
+        // run playback slightly faster or slower to reach the target time, rather than jumping to it
+        float targetTime = localTime - player.transit - player.playoutDelay;
+        float error = targetTime - player.timeCounter;
+
+        if (std::abs(error) > MAX_PLAYBACK_ERROR) {
+            player.timeCounter = targetTime;
+        } else {
+            player.timeCounter += dt + std::clamp(error, -PLAYBACK_WARP * dt, PLAYBACK_WARP * dt);
+        }
+
+        // events are raised once playback reaches their snapshot, not when it arrives, so that they line up with the movement
+        for (size_t i = 0; i < snapshots.size() && snapshots[i].timestamp <= player.timeCounter; i++) {
+            if (snapshots[i].timestamp > player.eventsRaisedUntil) {
+                raiseEvents(player.frameFlags, snapshots[i]);
+            }
+        }
+
+        // playback may be past the newest snapshot until the underrun clamp below, snapshots that arrive in that gap still need their events
+        player.eventsRaisedUntil = std::max(player.eventsRaisedUntil, std::min(player.timeCounter, snapshots.back().timestamp));
+
+        // drop the snapshots that were already played, but keep the one right before the playback time,
+        // and always keep two, so that there's a velocity to extrapolate with
+        while (snapshots.size() > 2 && snapshots[1].timestamp <= player.timeCounter) {
+            snapshots.popFront();
+        }
+
+        if (player.timeCounter >= snapshots.back().timestamp) {
+            // ran out of snapshots, the network needs more buffering than we thought
+            if (!player.underrun) {
+                player.underrun = true;
+                player.underruns++;
+                player.extrapolationTime = 0.f;
+                player.playoutDelay = std::min(player.playoutDelay + settings.expectedDelta * 0.5f, MAX_PLAYOUT_DELAY);
+            }
+
+            // don't run ahead of the data, or the next snapshot would arrive late
+            player.timeCounter = snapshots.back().timestamp;
+
+            if (settings.extrapolate && snapshots.size() >= 2) {
+                const auto& older = snapshots[snapshots.size() - 2];
+                const auto& newer = snapshots.back();
+
+                player.extrapolationTime = std::min(player.extrapolationTime + dt, MAX_EXTRAPOLATION_TIME);
+                extrapolatePlayer(older, newer, player.interpolatedState, player.extrapolationTime);
+
+                LerpLogger::get().logExtrapolatedRealFrame(
+                    playerId, this->getLocalTs(), newer.timestamp, player.timeCounter + player.extrapolationTime,
+                    newer.visual.player1, player.interpolatedState.player1
+                );
+            } else {
+                player.interpolatedState = snapshots.back().visual;
+
+                LerpLogger::get().logLerpSkip(playerId, this->getLocalTs(), player.timeCounter, player.interpolatedState.player1);
+            }
+
+            continue;
+        }
+
+        // fresh data arrived after extrapolating, remember where the player was shown so that we can blend from there
+        if (player.underrun && player.extrapolationTime > 0.f) {
+            player.p1Correction.position = player.interpolatedState.player1.position;
+            player.p1Correction.rotation = player.interpolatedState.player1.rotation;
+            player.p2Correction.position = player.interpolatedState.player2.position;
+            player.p2Correction.rotation = player.interpolatedState.player2.rotation;
+            player.correctionLeft = CORRECTION_BLEND_TIME;
+            player.pendingCorrection = true;
+        }
+
+        player.underrun = false;
+        player.extrapolationTime = 0.f;
+
+        if (player.timeCounter < snapshots.front().timestamp) {
+            // still filling up
+            player.interpolatedState = snapshots.front().visual;
 
-        float frameDelta = player.newerFrame.timestamp - player.olderFrame.timestamp;
-        if (frameDelta == 0.f) {
             LerpLogger::get().logLerpSkip(playerId, this->getLocalTs(), player.timeCounter, player.interpolatedState.player1);
+            this->applyCorrection(player, dt);
             continue;
         }
 
-        float lerpRatio = (player.timeCounter - player.olderFrame.timestamp) / frameDelta;
-        lerpPlayer(player.olderFrame.visual, player.newerFrame.visual, player.interpolatedState, lerpRatio);
+        const auto& older = snapshots[0];
+        const auto& newer = snapshots[1];
+
+        float lerpRatio = (player.timeCounter - older.timestamp) / (newer.timestamp - older.timestamp);
+        lerpPlayerState(older.visual, player.interpolatedState);
+
+        transforms.set(slot * 2, older.visual.player1, newer.visual.player1, lerpRatio);
+        transforms.set(slot * 2 + 1, older.visual.player2, newer.visual.player2, lerpRatio);
+        player.lerping = true;
+    }
+
+    // second pass: interpolate the transforms of every slot at once. lanes of slots that aren't lerping hold stale data,
+    // computing them anyway is cheaper than packing the lanes
+    util::simd::lerpTransforms(transforms.lanes());
+
+    // third pass: write the results back
+    for (size_t slot = 0; slot < states.size(); slot++) {
+        auto& player = states[slot];
+        if (!player.lerping) continue;
+
+        auto& p1 = player.interpolatedState.player1;
+        auto& p2 = player.interpolatedState.player2;
+
+        p1.position = CCPoint{transforms.outX[slot * 2], transforms.outY[slot * 2]};
+        p1.rotation = transforms.outRotation[slot * 2];
+        p2.position = CCPoint{transforms.outX[slot * 2 + 1], transforms.outY[slot * 2 + 1]};
+        p2.rotation = transforms.outRotation[slot * 2 + 1];
+
+        LerpLogger::get().logLerpOperation(player.playerId, this->getLocalTs(), player.timeCounter, p1);
+
+        this->applyCorrection(player, dt);
+    }
+}
+
+void PlayerInterpolator::applyCorrection(PlayerState& player, float dt) {
+    // turn the absolute positions saved when extrapolation ended into offsets from the new state
+    if (player.pendingCorrection) {
+        player.pendingCorrection = false;
+
+        auto makeOffset = [](IconCorrection& corr, const SpecificIconData& icon) {
+            corr.position = corr.position - icon.position;
+            corr.rotation = std::remainder(corr.rotation - icon.rotation, 360.f);
 
-        LerpLogger::get().logLerpOperation(playerId, this->getLocalTs(), player.timeCounter, player.interpolatedState.player1);
+            // teleports and large mispredictions are not worth smoothing out
+            if (corr.position.getLength() > MAX_CORRECTION_DISTANCE) {
+                corr = {};
+            }
+        };
 
-        player.timeCounter += dt;
+        makeOffset(player.p1Correction, player.interpolatedState.player1);
+        makeOffset(player.p2Correction, player.interpolatedState.player2);
     }
+
+    if (player.correctionLeft <= 0.f) return;
+
+    float factor = player.correctionLeft / CORRECTION_BLEND_TIME;
+
+    player.interpolatedState.player1.position = player.interpolatedState.player1.position + player.p1Correction.position * factor;
+    player.interpolatedState.player1.rotation += player.p1Correction.rotation * factor;
+    player.interpolatedState.player2.position = player.interpolatedState.player2.position + player.p2Correction.position * factor;
+    player.interpolatedState.player2.rotation += player.p2Correction.rotation * factor;
+
+    player.correctionLeft -= dt;
 }
 
 VisualPlayerState& PlayerInterpolator::getPlayerState(int playerId) {
-    return players.at(playerId).interpolatedState;
+    return this->getPlayer(playerId).interpolatedState;
 }
 
 FrameFlags PlayerInterpolator::swapFrameFlags(int playerId) {
-    auto& state = players.at(playerId);
+    auto& state = this->getPlayer(playerId);
     FrameFlags out;
     out.pendingDeath = util::misc::swapFlag(state.frameFlags.pendingDeath);
     out.pendingRealDeath = util::misc::swapFlag(state.frameFlags.pendingRealDeath);
@@ -135,21 +406,134 @@ FrameFlags PlayerInterpolator::swapFrameFlags(int playerId) {
 }
 
 bool PlayerInterpolator::isPlayerStale(int playerId, float lastServerPacket) {
-    auto uc = players.at(playerId).updateCounter;
+    auto& player = this->getPlayer(playerId);
+    auto uc = player.updateCounter;
+
+    if (uc != 0.f && std::abs(uc - lastServerPacket) > 0.5f) {
+        return true;
+    }
 
-    return uc != 0.f && std::abs(uc - lastServerPacket) > 0.5f;
+    // the server keeps relaying the last data of a player until it notices that they're gone,
+    // with a synchronized clock we can tell that the data itself stopped changing
+    if (player.timestampsSynced && !player.snapshots.empty()) {
+        return this->toSyncedTimeline(ClockSync::get().now()) - player.snapshots.back().timestamp > STALE_SNAPSHOT_AGE;
+    }
+
+    return false;
+}
+
+PlayerInterpolator::JitterStats PlayerInterpolator::getJitterStats(int playerId) {
+    auto& player = this->getPlayer(playerId);
+
+    return JitterStats {
+        .bufferDepth = player.snapshots.size(),
+        .underruns = player.underruns,
+        .lateFrames = player.lateFrames,
+        .jitter = player.jitter,
+        .delay = player.playoutDelay,
+        .playbackTime = player.timeCounter + player.extrapolationTime,
+    };
 }
 
 float PlayerInterpolator::getLocalTs() {
-    return GlobedGJBGL::get()->m_fields->timeCounter;
+    return localTime;
+}
+
+float PlayerInterpolator::toSyncedTimeline(double time) {
+    if (!syncedTimeBase) {
+        syncedTimeBase = time;
+    }
+
+    return static_cast<float>(time - *syncedTimeBase);
+}
+
+void PlayerInterpolator::TransformStorage::resize(size_t lanes) {
+    for (auto* vec : {&olderX, &olderY, &olderRotation, &newerX, &newerY, &newerRotation, &ratio, &spider, &outX, &outY, &outRotation}) {
+        vec->resize(lanes);
+    }
+}
+
+void PlayerInterpolator::TransformStorage::set(size_t lane, const SpecificIconData& older, const SpecificIconData& newer, float lerpRatio) {
+    olderX[lane] = older.position.x;
+    olderY[lane] = older.position.y;
+    olderRotation[lane] = older.rotation;
+    newerX[lane] = newer.position.x;
+    newerY[lane] = newer.position.y;
+    newerRotation[lane] = newer.rotation;
+    ratio[lane] = lerpRatio;
+    spider[lane] = older.iconType == PlayerIconType::Spider ? 1.f : 0.f;
+}
+
+util::simd::TransformLanes PlayerInterpolator::TransformStorage::lanes() {
+    return util::simd::TransformLanes {
+        .olderX = olderX.data(),
+        .olderY = olderY.data(),
+        .olderRotation = olderRotation.data(),
+        .newerX = newerX.data(),
+        .newerY = newerY.data(),
+        .newerRotation = newerRotation.data(),
+        .ratio = ratio.data(),
+        .spider = spider.data(),
+        .outX = outX.data(),
+        .outY = outY.data(),
+        .outRotation = outRotation.data(),
+        .count = outX.size(),
+    };
 }
 
 PlayerInterpolator::LerpFrame::LerpFrame() {
     timestamp = 0.f;
     visual = {};
+    died = false;
+    diedReal = false;
 }
 
 PlayerInterpolator::LerpFrame::LerpFrame(const PlayerData& data) {
     timestamp = data.timestamp;
     visual = data;
+    died = false;
+    diedReal = false;
+}
+
+void PlayerInterpolator::SnapshotBuffer::insert(const LerpFrame& frame) {
+    // a snapshot with the same timestamp replaces the old one
+    for (size_t i = count; i > 0 && this->at(i - 1).timestamp >= frame.timestamp; i--) {
+        if (this->at(i - 1).timestamp == frame.timestamp) {
+            // the server keeps relaying the last data of a player, only the first copy is seen as a death
+            auto& existing = this->at(i - 1);
+            bool died = existing.died, diedReal = existing.diedReal;
+
+            existing = frame;
+
+            if (died) {
+                existing.died = true;
+                existing.diedReal = diedReal;
+            }
+
+            return;
+        }
+    }
+
+    if (count == JITTER_BUFFER_SIZE) {
+        this->popFront();
+    }
+
+    // snapshots almost always arrive in order, so usually nothing has to be moved
+    size_t idx = count++;
+    while (idx > 0 && this->at(idx - 1).timestamp > frame.timestamp) {
+        this->at(idx) = this->at(idx - 1);
+        idx--;
+    }
+
+    this->at(idx) = frame;
+}
+
+void PlayerInterpolator::SnapshotBuffer::popFront() {
+    start = (start + 1) % JITTER_BUFFER_SIZE;
+    count--;
+}
+
+void PlayerInterpolator::SnapshotBuffer::clear() {
+    start = 0;
+    count = 0;
 }
@@ -2,10 +2,14 @@
 
 #include "visual_state.hpp"
 #include <data/types/game.hpp>
+#include <util/simd.hpp>
+
+#include <array>
 
 struct InterpolatorSettings {
     bool realtime;      // no interpolation at all
     bool isPlatformer;  // platformer duh
+    bool extrapolate;   // dead reckoning, predict where players move when running out of snapshots
     float expectedDelta;
 };
 
@@ -34,16 +38,81 @@ public:
     // returns `true` if death animation needs to be played and sets the flag back to false (so next call won't return `true` again)
     FrameFlags swapFrameFlags(int playerId);
 
-    // returns `true` if the given time of the last packet doesn't match the last update time of the player
+    // returns `true` if the given time of the last packet doesn't match the last update time of the player,
+    // or if the player's clock is synchronized and their newest data is too old
     bool isPlayerStale(int playerId, float lastServerPacket);
 
+    struct JitterStats {
+        size_t bufferDepth; // snapshots currently buffered
+        size_t underruns;   // how many times playback caught up with the newest snapshot
+        size_t lateFrames;  // snapshots dropped because they arrived after their time was already played
+        float jitter;       // smoothed inter-arrival jitter, in seconds
+        float delay;        // current playout delay, in seconds
+        float playbackTime; // the player's timestamp that is currently being shown, including extrapolation
+    };
+
+    // Get the jitter buffer statistics of the player
+    JitterStats getJitterStats(int playerId);
+
     float getLocalTs();
 
 private:
-    std::unordered_map<int, PlayerState> players;
+    // Structure of arrays with the transforms of every player slot, interpolated all at once with `util::simd::lerpTransforms`.
+    // Lane `slot * 2` holds player1 of the slot, lane `slot * 2 + 1` holds player2.
+    struct TransformStorage {
+        std::vector<float> olderX, olderY, olderRotation;
+        std::vector<float> newerX, newerY, newerRotation;
+        std::vector<float> ratio, spider;
+        std::vector<float> outX, outY, outRotation;
+
+        void resize(size_t lanes);
+        void set(size_t lane, const SpecificIconData& older, const SpecificIconData& newer, float lerpRatio);
+        util::simd::TransformLanes lanes();
+    };
+
+    // players are stored densely, a player keeps its slot until removed, and freed slots get reused
+    std::vector<PlayerState> states;
+    std::unordered_map<int, size_t> slots;
+    std::vector<size_t> freeSlots;
+    TransformStorage transforms;
     InterpolatorSettings settings;
 
-    constexpr static bool EXTRAPOLATION = false;
+    PlayerState& getPlayer(int playerId);
+    void applyCorrection(PlayerState& player, float dt);
+
+    // Turn a synchronized time (see `ClockSync`) into seconds since the first synchronized snapshot of this interpolator.
+    // The synchronized clock counts from when the game connected, so it would lose float precision after a few hours of playing.
+    float toSyncedTimeline(double time);
+
+    // local time, advanced in `tick`. Arrival times of snapshots are measured with it
+    float localTime = 0.f;
+    // synchronized time that all synchronized snapshot timestamps are relative to, set by the first one
+    std::optional<double> syncedTimeBase;
+
+    // how far ahead of the newest snapshot a player can be predicted
+    constexpr static float MAX_EXTRAPOLATION_TIME = 0.25f;
+    // how long it takes to blend from a predicted position back to real data
+    constexpr static float CORRECTION_BLEND_TIME = 0.15f;
+    // mispredictions further off than this are snapped instead of blended
+    constexpr static float MAX_CORRECTION_DISTANCE = 150.f;
+
+    // how many snapshots are buffered per player
+    constexpr static size_t JITTER_BUFFER_SIZE = 16;
+    // the playout delay is `expectedDelta + JITTER_DELAY_FACTOR * jitter`, at most `MAX_PLAYOUT_DELAY`
+    constexpr static float JITTER_DELAY_FACTOR = 3.f;
+    constexpr static float MAX_PLAYOUT_DELAY = 0.5f;
+    // how fast the delay goes back down after the network calms down, in seconds per second
+    constexpr static float DELAY_DECAY_RATE = 0.05f;
+    // how much faster or slower than realtime playback may run to converge to its target time
+    constexpr static float PLAYBACK_WARP = 0.1f;
+    // if playback is further than this from its target time, it jumps there instead
+    constexpr static float MAX_PLAYBACK_ERROR = 0.25f;
+    // how fast the transit estimate follows packets that are slower than it
+    constexpr static float TRANSIT_DRIFT = 0.01f;
+    // a snapshot this much older than the newest one means the player restarted their clock (e.g. rejoined the level)
+    constexpr static float TIMESTAMP_RESET_THRESHOLD = 1.f;
+    // with synchronized clocks, a player whose newest snapshot is older than this is considered gone
+    constexpr static float STALE_SNAPSHOT_AGE = 3.f;
 
 public:
 
@@ -53,17 +122,88 @@ public:
 
         float timestamp;
         VisualPlayerState visual;
+        // the player died in this snapshot, jumps and spider teleports are already in `visual`
+        bool died;
+        bool diedReal;
+    };
+
+    // Fixed size ring of snapshots, ordered by timestamp (oldest first). When full, inserting drops the oldest one.
+    class SnapshotBuffer {
+    public:
+        void insert(const LerpFrame& frame);
+        void popFront();
+        void clear();
+
+        size_t size() const {
+            return count;
+        }
+
+        bool empty() const {
+            return count == 0;
+        }
+
+        // 0 is the oldest snapshot
+        const LerpFrame& operator[](size_t idx) const {
+            return frames[(start + idx) % JITTER_BUFFER_SIZE];
+        }
+
+        const LerpFrame& front() const {
+            return (*this)[0];
+        }
+
+        const LerpFrame& back() const {
+            return (*this)[count - 1];
+        }
+
+    private:
+        std::array<LerpFrame, JITTER_BUFFER_SIZE> frames;
+        size_t start = 0, count = 0;
+
+        LerpFrame& at(size_t idx) {
+            return frames[(start + idx) % JITTER_BUFFER_SIZE];
+        }
+    };
+
+    struct IconCorrection {
+        cocos2d::CCPoint position;
+        float rotation = 0.f;
     };
 
     struct PlayerState {
+        int playerId = 0;
+        bool active = false;
+        // set in the first pass of `tick` if the transforms of this player are being interpolated
+        bool lerping = false;
+
         float updateCounter = 0.0f;
+        // playback position in the timeline of the player's timestamps
         float timeCounter = 0.0f;
         float lastDeathTimestamp = 0.0f;
         size_t totalFrames = 0;
 
-        LerpFrame olderFrame, newerFrame;
+        SnapshotBuffer snapshots;
         VisualPlayerState interpolatedState;
         bool pendingRealFrame = false;
         FrameFlags frameFlags;
+        // events of snapshots up to this timestamp were already added to `frameFlags`
+        float eventsRaisedUntil = 0.f;
+
+        // (local arrival time - player timestamp), tracks the fastest recent transit
+        float transit = 0.f;
+        float lastTransit = 0.f;
+        float jitter = 0.f;
+        float playoutDelay = 0.f;
+        float targetDelay = 0.f;
+        bool underrun = false;
+        size_t underruns = 0;
+        // snapshot timestamps are on the synchronized clock (see `ClockSync`) rather than the player's own
+        bool timestampsSynced = false;
+        size_t lateFrames = 0;
+
+        // dead reckoning
+        float extrapolationTime = 0.f;
+        IconCorrection p1Correction, p2Correction;
+        float correctionLeft = 0.f;
+        bool pendingCorrection = false;
     };
 };
\ No newline at end of file
@@ -1,5 +1,6 @@
 #include "lerp_logger.hpp"
 
+#include <Geode/utils/file.hpp>
 #include <defs/assert.hpp>
 
 void LerpLogger::reset(uint32_t id) {
@@ -78,4 +79,27 @@ void LerpLogger::makeDump(const std::filesystem::path path) {
     file.write(reinterpret_cast<const char*>(bb.data().data()), bb.size());
     log::debug("dumped interpolation data to {} ({} bytes)", path, bb.size());
 #endif
-}
\ No newline at end of file
+}
+
+Result<std::unordered_map<uint32_t, PlayerLog>> LerpLogger::loadDump(const std::filesystem::path& path) {
+    GLOBED_UNWRAP_INTO(geode::utils::file::readBinary(path), auto data);
+
+    ByteBuffer bb(std::move(data));
+
+    auto countR = bb.readU32();
+    if (!countR) return Err(ByteBuffer::strerror(countR.unwrapErr()));
+
+    std::unordered_map<uint32_t, PlayerLog> players;
+
+    for (uint32_t i = 0; i < countR.unwrap(); i++) {
+        auto idR = bb.readU32();
+        if (!idR) return Err(ByteBuffer::strerror(idR.unwrapErr()));
+
+        auto logR = bb.readValue<PlayerLog>();
+        if (!logR) return Err(ByteBuffer::strerror(logR.unwrapErr()));
+
+        players.emplace(idR.unwrap(), std::move(logR.unwrap()));
+    }
+
+    return Ok(std::move(players));
+}
@@ -37,6 +37,9 @@ public:
 
     void makeDump(const std::filesystem::path path);
 
+    // Read a dump written by `makeDump`. Works regardless of whether interpolation debugging is enabled.
+    static Result<std::unordered_map<uint32_t, PlayerLog>> loadDump(const std::filesystem::path& path);
+
 private:
     PlayerLog& ensureExists(uint32_t player);
     PlayerLogData makeLogData(const SpecificIconData& data, float localts, float timeCounter);
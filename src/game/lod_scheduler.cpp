@@ -0,0 +1,64 @@
+#include "lod_scheduler.hpp"
+
+using namespace geode::prelude;
+
+void PlayerLodScheduler::beginFrame() {
+    frame++;
+}
+
+bool PlayerLodScheduler::schedule(int playerId, bool nearby, CCPoint position, const GameCameraState& camState) {
+    auto& state = states[playerId];
+
+    PlayerLod lod = classify(nearby, position, camState);
+    PlayerLod oldLod = state.lod;
+    state.lod = lod;
+
+    // always update on a change, so promoted players show up immediately and demoted ones get to turn their effects off
+    if (lod != oldLod || lod == PlayerLod::Full) {
+        return true;
+    }
+
+    uint32_t interval = intervalFor(lod);
+    return (frame + static_cast<uint32_t>(playerId)) % interval == 0;
+}
+
+PlayerLod PlayerLodScheduler::getLod(int playerId) const {
+    auto it = states.find(playerId);
+    return it == states.end() ? PlayerLod::Full : it->second.lod;
+}
+
+void PlayerLodScheduler::remove(int playerId) {
+    states.erase(playerId);
+}
+
+void PlayerLodScheduler::clear() {
+    states.clear();
+}
+
+PlayerLod PlayerLodScheduler::classify(bool nearby, CCPoint position, const GameCameraState& camState) {
+    if (nearby) return PlayerLod::Full;
+
+    CCSize coverage = camState.cameraCoverage();
+    if (coverage.width <= 0.f || coverage.height <= 0.f) return PlayerLod::Full;
+
+    CCPoint center = camState.cameraOrigin + CCPoint{coverage.width / 2.f, coverage.height / 2.f};
+
+    // distance in screens along the axis where they are the furthest away
+    float screens = std::max(
+        std::abs(position.x - center.x) / coverage.width,
+        std::abs(position.y - center.y) / coverage.height
+    );
+
+    // also catches NaN positions
+    return screens < REDUCED_DISTANCE ? PlayerLod::Reduced : PlayerLod::Minimal;
+}
+
+uint32_t PlayerLodScheduler::intervalFor(PlayerLod lod) {
+    switch (lod) {
+        case PlayerLod::Full: return 1;
+        case PlayerLod::Reduced: return REDUCED_INTERVAL;
+        case PlayerLod::Minimal: return MINIMAL_INTERVAL;
+    }
+
+    return 1;
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <unordered_map>
+
+#include "camera_state.hpp"
+
+enum class PlayerLod : uint8_t {
+    Full,     // within 3 screens of the camera, updated every frame with all animations
+    Reduced,  // a few screens away, updated every few frames
+    Minimal,  // far away, updated rarely, only the progress indicators really matter
+};
+
+/*
+* PlayerLodScheduler - decides how often the visuals of every remote player are updated.
+*
+* Players that are marked nearby by the spatial index are always updated, and are promoted the very same frame they come into view.
+* Everyone else is bucketed by their distance to the camera center (measured in screens) and only gets a full visual update
+* once every `REDUCED_INTERVAL` or `MINIMAL_INTERVAL` frames. Update frames are staggered by player ID, so that a room full of
+* far away players doesn't turn into a spike every N frames.
+*/
+class PlayerLodScheduler {
+public:
+    static constexpr uint32_t REDUCED_INTERVAL = 4;
+    static constexpr uint32_t MINIMAL_INTERVAL = 15;
+
+    // in screens from the camera center, the 3-screen nearby area ends at 1.5
+    static constexpr float REDUCED_DISTANCE = 4.f;
+
+    // Call once per frame before `schedule`.
+    void beginFrame();
+
+    // Assigns a level of detail to the player and returns whether their visuals should be updated this frame.
+    bool schedule(int playerId, bool nearby, cocos2d::CCPoint position, const GameCameraState& camState);
+
+    PlayerLod getLod(int playerId) const;
+
+    void remove(int playerId);
+    void clear();
+
+private:
+    struct State {
+        PlayerLod lod = PlayerLod::Full;
+    };
+
+    std::unordered_map<int, State> states;
+    uint32_t frame = 0;
+
+    static PlayerLod classify(bool nearby, cocos2d::CCPoint position, const GameCameraState& camState);
+    static uint32_t intervalFor(PlayerLod lod);
+};
@@ -33,74 +33,74 @@ static bool shouldCorrectCollision(const CCRect& p1, const CCRect& p2, CCPoint&
     return false;
 }
 
-void CollisionModule::checkCollisions(PlayerObject* player, float dt, bool p2) {
-    bool isSecond = player == gameLayer->m_player2;
+void CollisionModule::selUpdate(float dt) {
+    broadphase.clear();
 
-    for (const auto& [_, rp] : gameLayer->m_fields->players) {
-        auto* p1 = static_cast<PlayerObject*>(rp->player1->getPlayerObject());
-        auto* p2 = static_cast<PlayerObject*>(rp->player2->getPlayerObject());
+    // we are always on screen, so anyone we can collide with is nearby and has an up to date position
+    for (const auto [playerId, isSecond] : gameLayer->m_fields->nearbyIcons) {
+        auto it = gameLayer->m_fields->players.find(playerId);
+        if (it == gameLayer->m_fields->players.end()) continue;
 
-        auto& p1Rect = p1->getObjectRect();
-        auto& p2Rect = p2->getObjectRect();
+        auto* visual = isSecond ? it->second->player2 : it->second->player1;
+        auto* object = static_cast<PlayerObject*>(visual->getPlayerObject());
+
+        broadphase.add(playerId, isSecond, object->getObjectRect());
+    }
 
-        auto& playerRect = player->getObjectRect();
+    broadphase.build();
+}
 
-        CCRect p1CollRect = p1Rect;
-        CCRect p2CollRect = p2Rect;
+void CollisionModule::checkCollisions(PlayerObject* player, float dt, bool p2) {
+    bool isSecond = player == gameLayer->m_player2;
 
-        constexpr float padding = 2.f;
+    auto& players = gameLayer->m_fields->players;
+    auto& sticky = isSecond ? stickyP2 : stickyP1;
 
-        // p1CollRect.origin += CCPoint{padding, padding};
-        // p1CollRect.size -= CCSize{padding * 2, padding * 2};
+    for (const auto [playerId, isSecondIcon] : sticky) {
+        auto it = players.find(playerId);
+        if (it == players.end()) continue;
 
-        // p2CollRect.origin += CCPoint{padding, padding};
-        // p2CollRect.size -= CCSize{padding * 2, padding * 2};
+        auto* visual = isSecondIcon ? it->second->player2 : it->second->player1;
+        isSecond ? visual->setP2StickyState(false) : visual->setP1StickyState(false);
+    }
 
-        bool intersectsP1 = playerRect.intersectsRect(p1CollRect);
-        bool intersectsP2 = playerRect.intersectsRect(p2CollRect);
+    sticky.clear();
 
-        if (isSecond) {
-            rp->player1->setP2StickyState(false);
-            rp->player2->setP2StickyState(false);
-        } else {
-            rp->player1->setP1StickyState(false);
-            rp->player2->setP1StickyState(false);
-        }
+    auto& playerRect = player->getObjectRect();
 
-        if (intersectsP1) {
-            auto prev = player->getPosition();
-            player->collidedWithObject(dt, p1, p1CollRect, false);
-            auto displacement = player->getPosition() - prev;
+    broadphase.query(playerRect, [&](const CollisionBroadphase::Body& body) {
+        auto it = players.find(body.playerId);
+        if (it == players.end()) return;
 
-            // log::debug("p1 intersect, displacement: {}", displacement);
+        auto* visual = body.isSecond ? it->second->player2 : it->second->player1;
+        auto* object = static_cast<PlayerObject*>(visual->getPlayerObject());
 
-            bool shouldRevert = shouldCorrectCollision(playerRect, p1Rect, displacement);
+        auto& objectRect = object->getObjectRect();
 
-            if (shouldRevert) {
-                player->setPosition(player->getPosition() + displacement);
-            }
+        CCRect collRect = objectRect;
 
-            if (std::abs(displacement.y) > 0.001f) {
-                isSecond ? rp->player1->setP2StickyState(true) : rp->player1->setP1StickyState(true);
-            }
-        }
+        constexpr float padding = 2.f;
 
-        if (intersectsP2) {
-            auto prev = player->getPosition();
-            player->collidedWithObject(dt, p2, p2CollRect, false);
-            auto displacement = player->getPosition() - prev;
+        // collRect.origin += CCPoint{padding, padding};
+        // collRect.size -= CCSize{padding * 2, padding * 2};
 
-            // log::debug("p2 intersect, displacement: {}", displacement);
+        if (!playerRect.intersectsRect(collRect)) return;
 
-            bool shouldRevert = shouldCorrectCollision(playerRect, p2Rect, displacement);
+        auto prev = player->getPosition();
+        player->collidedWithObject(dt, object, collRect, false);
+        auto displacement = player->getPosition() - prev;
 
-            if (shouldRevert) {
-                player->setPosition(player->getPosition() + displacement);
-            }
+        // log::debug("{} intersect, displacement: {}", body.isSecond ? "p2" : "p1", displacement);
 
-            if (std::abs(displacement.y) > 0.001f) {
-                isSecond ? rp->player2->setP2StickyState(true) : rp->player2->setP1StickyState(true);
-            }
+        bool shouldRevert = shouldCorrectCollision(playerRect, objectRect, displacement);
+
+        if (shouldRevert) {
+            player->setPosition(player->getPosition() + displacement);
         }
-    }
+
+        if (std::abs(displacement.y) > 0.001f) {
+            isSecond ? visual->setP2StickyState(true) : visual->setP1StickyState(true);
+            sticky.emplace_back(body.playerId, body.isSecond);
+        }
+    });
 }
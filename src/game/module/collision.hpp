@@ -1,6 +1,7 @@
 #pragma once
 
 #include "base.hpp"
+#include <game/collision_broadphase.hpp>
 
 class CollisionModule : public BaseGameplayModule {
 public:
@@ -9,8 +10,13 @@ public:
     void loadLevelSettingsPre() override;
     void loadLevelSettingsPost() override;
     void checkCollisions(PlayerObject* player, float dt, bool p2) override;
+    void selUpdate(float dt) override;
 
 private:
     bool lastPlat = false;
     int lastLength = 0;
+
+    CollisionBroadphase broadphase;
+    // (player id, is second icon) of the remote icons that are sticky to our player 1 and player 2
+    std::vector<std::pair<int, bool>> stickyP1, stickyP2;
 };
\ No newline at end of file
@@ -36,6 +36,17 @@ void TwoPlayerModeModule::mainPlayerUpdate(PlayerObject* player, float dt) {
     }
 }
 
+void TwoPlayerModeModule::onPlayerLeave(RemotePlayer* player) {
+    PlayerObject* ignored = this->isPrimary ? gameLayer->m_player2 : gameLayer->m_player1;
+
+    ComplexVisualPlayer* cvp = static_cast<ComplexVisualPlayer*>(ignored->getUserObject(LOCKED_TO_KEY));
+    if (!cvp || cvp->getRemotePlayer() != player) return;
+
+    // the player node gets reused for whoever joins next, don't keep following it
+    ignored->setUserObject(LOCKED_TO_KEY, nullptr);
+    this->linked = false;
+}
+
 void TwoPlayerModeModule::updateFromLockedPlayer(PlayerObject* player, bool ignorePos) {
     ComplexVisualPlayer* cvp = static_cast<ComplexVisualPlayer*>(player->getUserObject(LOCKED_TO_KEY));
     if (!cvp) return;
@@ -8,6 +8,7 @@ public:
     TwoPlayerModeModule(GlobedGJBGL* gameLayer);
 
     void mainPlayerUpdate(PlayerObject* player, float dt) override;
+    void onPlayerLeave(RemotePlayer* player) override;
     EventOutcome resetLevel() override;
     EventOutcome destroyPlayerPre(PlayerObject* player, GameObject* object) override;
     void destroyPlayerPost(PlayerObject* player, GameObject* object) override;
@@ -0,0 +1,80 @@
+#include "spatial_index.hpp"
+
+using namespace geode::prelude;
+
+void PlayerSpatialIndex::update(int playerId, CCPoint player1, std::optional<CCPoint> player2) {
+    auto& location = locations[playerId];
+
+    this->place(playerId, false, location[0], player1);
+
+    if (player2) {
+        this->place(playerId, true, location[1], *player2);
+    } else {
+        this->unplace(playerId, true, location[1]);
+    }
+}
+
+void PlayerSpatialIndex::remove(int playerId) {
+    auto it = locations.find(playerId);
+    if (it == locations.end()) return;
+
+    this->unplace(playerId, false, it->second[0]);
+    this->unplace(playerId, true, it->second[1]);
+
+    locations.erase(it);
+}
+
+void PlayerSpatialIndex::clear() {
+    cells.clear();
+    locations.clear();
+    entryCount = 0;
+}
+
+size_t PlayerSpatialIndex::size() const {
+    return entryCount;
+}
+
+void PlayerSpatialIndex::place(int playerId, bool isSecond, Location& location, CCPoint position) {
+    CellKey cell = cellKey(cellCoord(position.x), cellCoord(position.y));
+
+    // still in the same cell, only the position changes
+    if (location.indexed && location.cell == cell) {
+        for (auto& entry : cells[cell]) {
+            if (entry.playerId == playerId && entry.isSecond == isSecond) {
+                entry.position = position;
+                return;
+            }
+        }
+    }
+
+    this->unplace(playerId, isSecond, location);
+
+    cells[cell].push_back(Entry {
+        .playerId = playerId,
+        .isSecond = isSecond,
+        .position = position,
+    });
+
+    location.cell = cell;
+    location.indexed = true;
+    entryCount++;
+}
+
+void PlayerSpatialIndex::unplace(int playerId, bool isSecond, Location& location) {
+    if (!location.indexed) return;
+
+    location.indexed = false;
+
+    auto it = cells.find(location.cell);
+    if (it == cells.end()) return;
+
+    auto& entries = it->second;
+    for (size_t i = 0; i < entries.size(); i++) {
+        if (entries[i].playerId == playerId && entries[i].isSecond == isSecond) {
+            entries[i] = entries.back();
+            entries.pop_back();
+            entryCount--;
+            return;
+        }
+    }
+}
@@ -0,0 +1,115 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+/*
+* PlayerSpatialIndex - uniform grid over the interpolated positions of remote player icons.
+*
+* Every icon lives in the cell containing its position. Moving within a cell only updates the stored position,
+* moving to another cell is a swap-remove from the old one and a push to the new one, so the index can be kept up to date
+* every frame for little more than the cost of a hash lookup per player.
+*
+* Queries only visit the cells overlapping the queried area, their cost depends on how many players are nearby,
+* not on how many are in the level. Empty cells are kept around so that players going back and forth over a cell border don't allocate.
+*/
+class PlayerSpatialIndex {
+public:
+    // in units, roughly half of the screen height at the default zoom
+    static constexpr float CELL_SIZE = 256.f;
+
+    struct Entry {
+        int playerId;
+        bool isSecond;
+        cocos2d::CCPoint position;
+    };
+
+    // Insert the icons of a player or move them to their new positions. The second icon is only indexed if `player2` is set.
+    void update(int playerId, cocos2d::CCPoint player1, std::optional<cocos2d::CCPoint> player2);
+    void remove(int playerId);
+    void clear();
+
+    // number of indexed icons
+    size_t size() const;
+
+    // Calls `callback(const Entry&)` for every icon inside of `rect` (edges included).
+    template <typename F>
+    void queryRect(const cocos2d::CCRect& rect, F&& callback) const {
+        float minX = rect.getMinX(), maxX = rect.getMaxX();
+        float minY = rect.getMinY(), maxY = rect.getMaxY();
+
+        auto check = [&](const std::vector<Entry>& entries) {
+            for (const auto& entry : entries) {
+                if (entry.position.x >= minX && entry.position.x <= maxX && entry.position.y >= minY && entry.position.y <= maxY) {
+                    callback(entry);
+                }
+            }
+        };
+
+        int64_t cellMinX = cellCoord(minX), cellMaxX = cellCoord(maxX);
+        int64_t cellMinY = cellCoord(minY), cellMaxY = cellCoord(maxY);
+
+        // when zoomed out far enough, walking every existing cell is cheaper than looking up every covered one
+        if ((cellMaxX - cellMinX + 1) * (cellMaxY - cellMinY + 1) > static_cast<int64_t>(cells.size())) {
+            for (const auto& [_, entries] : cells) {
+                check(entries);
+            }
+
+            return;
+        }
+
+        for (int64_t x = cellMinX; x <= cellMaxX; x++) {
+            for (int64_t y = cellMinY; y <= cellMaxY; y++) {
+                auto it = cells.find(cellKey(x, y));
+                if (it != cells.end()) {
+                    check(it->second);
+                }
+            }
+        }
+    }
+
+    // Calls `callback(const Entry&)` for every icon at most `radius` units away from `center`.
+    template <typename F>
+    void queryRadius(cocos2d::CCPoint center, float radius, F&& callback) const {
+        float radiusSq = radius * radius;
+
+        this->queryRect(cocos2d::CCRect{center.x - radius, center.y - radius, radius * 2.f, radius * 2.f}, [&](const Entry& entry) {
+            float dx = entry.position.x - center.x;
+            float dy = entry.position.y - center.y;
+
+            if (dx * dx + dy * dy <= radiusSq) {
+                callback(entry);
+            }
+        });
+    }
+
+private:
+    using CellKey = uint64_t;
+
+    struct Location {
+        CellKey cell;
+        bool indexed = false;
+    };
+
+    std::unordered_map<CellKey, std::vector<Entry>> cells;
+    std::unordered_map<int, std::array<Location, 2>> locations;
+    size_t entryCount = 0;
+
+    static int64_t cellCoord(float pos) {
+        // positions come from other clients, don't let garbage overflow the conversion
+        if (!std::isfinite(pos)) return 0;
+
+        return static_cast<int64_t>(std::floor(std::clamp(pos, -1e9f, 1e9f) / CELL_SIZE));
+    }
+
+    static CellKey cellKey(int64_t x, int64_t y) {
+        return (static_cast<uint64_t>(static_cast<uint32_t>(x)) << 32) | static_cast<uint32_t>(y);
+    }
+
+    void place(int playerId, bool isSecond, Location& location, cocos2d::CCPoint position);
+    void unplace(int playerId, bool isSecond, Location& location);
+};
@@ -17,8 +17,10 @@
 #include <managers/settings.hpp>
 #include <managers/room.hpp>
 #include <data/packets/all.hpp>
+#include <net/clock_sync.hpp>
 #include <game/module/all.hpp>
 #include <game/camera_state.hpp>
+#include <game/lerp_logger.hpp>
 #include <hooks/game_manager.hpp>
 #include <util/math.hpp>
 #include <util/debug.hpp>
@@ -31,6 +33,12 @@ using namespace geode::prelude;
 // how many units before the voice disappears
 constexpr float PROXIMITY_VOICE_LIMIT = 1200.f;
 
+// players created ahead of time during level load, and the minimum kept around afterwards
+constexpr size_t PLAYER_POOL_WARM_SIZE = 8;
+constexpr size_t PLAYER_POOL_MIN_SIZE = 4;
+// players that left beyond this many are destroyed instead of pooled
+constexpr size_t PLAYER_POOL_MAX_SIZE = 32;
+
 constexpr float VOICE_OVERLAY_PAD_X = 5.f;
 constexpr float VOICE_OVERLAY_PAD_Y = 20.f;
 
@@ -421,6 +429,7 @@ void GlobedGJBGL::setupMisc() {
     m_fields->interpolator = std::make_unique<PlayerInterpolator>(InterpolatorSettings {
         .realtime = false,
         .isPlatformer = m_level->isPlatformer(),
+        .extrapolate = true,
         .expectedDelta = (1.0f / m_fields->configuredTps)
     });
 
@@ -527,6 +536,9 @@ void GlobedGJBGL::setupUi() {
         }
     }
 
+    // build a few players now, so the first joins don't stutter
+    this->warmPlayerPool(PLAYER_POOL_WARM_SIZE);
+
     GLOBED_EVENT(this, setupUi());
 }
 
@@ -651,6 +663,11 @@ void GlobedGJBGL::selPeriodicalUpdate(float dt) {
         NetworkManager::get().updateServerPing();
     }
 
+    // refill the pool one player at a time, so that it never costs more than a single join
+    if (self->m_fields->playerPool.size() < PLAYER_POOL_MIN_SIZE) {
+        self->warmPlayerPool(self->m_fields->playerPool.size() + 1);
+    }
+
     GLOBED_EVENT(this, selPeriodicalUpdate(dt));
 }
 
@@ -681,6 +698,7 @@ void GlobedGJBGL::selUpdate(float timescaledDt) {
     self->m_fields->timeCounter += dt;
 
     self->m_fields->interpolator->tick(dt);
+    self->updateSpatialIndex();
 
     if (auto pl = PlayLayer::get()) {
         if (self->m_fields->progressBarWrapper->getParent() != nullptr) {
@@ -699,19 +717,30 @@ void GlobedGJBGL::selUpdate(float timescaledDt) {
     auto& settings = GlobedSettings::get();
 
     bool hasBeenKilled = false;
+    bool isEditor = self->isEditor();
+
+    auto& lod = self->m_fields->lodScheduler;
+    lod.beginFrame();
 
     for (const auto [playerId, remotePlayer] : self->m_fields->players) {
         const auto& vstate = self->m_fields->interpolator->getPlayerState(playerId);
 
         auto frameFlags = self->m_fields->interpolator->swapFrameFlags(playerId);
 
-        bool isSpeaking = vpm.isSpeaking(playerId);
-        remotePlayer->updateData(
-            vstate,
-            frameFlags,
-            isSpeaking,
-            isSpeaking ? vpm.getLoudness(playerId) : 0.f
-        );
+        // everyone is always rendered in the editor
+        bool nearby = isEditor || remotePlayer->isNearby();
+
+        if (lod.schedule(playerId, nearby, vstate.player1.position, self->m_fields->camState)) {
+            bool isSpeaking = vpm.isSpeaking(playerId);
+            remotePlayer->updateData(
+                vstate,
+                frameFlags,
+                isSpeaking,
+                isSpeaking ? vpm.getLoudness(playerId) : 0.f
+            );
+        } else {
+            remotePlayer->updateProgressData(vstate, frameFlags);
+        }
 
         // update progress icons
         if (auto self = PlayLayer::get()) {
@@ -721,12 +750,12 @@ void GlobedGJBGL::selUpdate(float timescaledDt) {
             }
         }
 
-        // update voice proximity
-        self->updateProximityVolume(playerId);
-
         GLOBED_EVENT(self, onUpdatePlayer(playerId, remotePlayer, frameFlags));
     }
 
+    // update voice proximity
+    self->updateProximityVolumes();
+
     if (self->m_fields->selfStatusIcons) {
         self->m_fields->selfStatusIcons->setPosition(self->m_player1->getPosition() + CCPoint{0.f, 25.f});
         bool recording = VoiceRecordingManager::get().isRecording();
@@ -861,8 +890,12 @@ PlayerData GlobedGJBGL::gatherPlayerData() {
         isEditorBuilding = this->m_playbackMode == PlaybackMode::Not;
     }
 
+    // once synchronized, send the server time instead, so that everyone's timestamps are on the same timeline
+    auto& clock = ClockSync::get();
+    bool timestampSynced = clock.isSynced();
+
     return PlayerData {
-        .timestamp = m_fields->timeCounter,
+        .timestamp = timestampSynced ? clock.wrappedNow() : m_fields->timeCounter,
 
         .player1 = this->gatherSpecificIconData(m_player1),
         .player2 = this->gatherSpecificIconData(m_player2),
@@ -877,7 +910,8 @@ PlayerData GlobedGJBGL::gatherPlayerData() {
         .isDualMode = m_gameState.m_isDualMode,
         .isInEditor = isInEditor,
         .isEditorBuilding = isEditorBuilding,
-        .isLastDeathReal = m_fields->isLastDeathReal
+        .isLastDeathReal = m_fields->isLastDeathReal,
+        .isTimestampSynced = timestampSynced,
     };
 }
 
@@ -946,49 +980,104 @@ void GlobedGJBGL::updateProximityVolume(int playerId) {
     }
 }
 
-void GlobedGJBGL::handlePlayerJoin(int playerId) {
-    auto& settings = GlobedSettings::get();
+void GlobedGJBGL::updateProximityVolumes() {
+    if (m_fields->deafened || !m_fields->isVoiceProximity) return;
 
-    PlayerProgressIcon* progressIcon = nullptr;
-    PlayerProgressArrow* progressArrow = nullptr;
+    auto& inRange = m_fields->voiceInRange;
+    auto& lastInRange = m_fields->lastVoiceInRange;
+
+    std::swap(inRange, lastInRange);
+    inRange.clear();
 
-    bool platformer = m_level->isPlatformer();
-
-    if (!platformer && settings.levelUi.progressIndicators) {
-        Build<PlayerProgressIcon>::create()
-            .zOrder(2)
-            .id(util::cocos::spr(fmt::format("remote-player-progress-{}", playerId)))
-            .parent(m_fields->progressBarWrapper)
-            .store(progressIcon);
-    } else if (platformer && settings.levelUi.progressIndicators) {
-        Build<PlayerProgressArrow>::create()
-            .zOrder(2)
-            .id(util::cocos::spr(fmt::format("remote-player-progress-{}", playerId)))
-            .parent(this)
-            .store(progressArrow);
+    m_fields->spatialIndex.queryRadius(m_player1->getPosition(), PROXIMITY_VOICE_LIMIT, [&](const PlayerSpatialIndex::Entry& entry) {
+        if (!entry.isSecond) {
+            inRange.push_back(entry.playerId);
+        }
+    });
+
+    std::sort(inRange.begin(), inRange.end());
+
+    for (int playerId : inRange) {
+        this->updateProximityVolume(playerId);
+    }
+
+    // everyone else is either silent already or gets updated by their next voice packet, except for those who just went out of range
+    for (int playerId : lastInRange) {
+        if (!std::binary_search(inRange.begin(), inRange.end(), playerId)) {
+            this->updateProximityVolume(playerId);
+        }
+    }
+}
+
+void GlobedGJBGL::updateSpatialIndex() {
+    auto& index = m_fields->spatialIndex;
+
+    for (const auto& [playerId, _] : m_fields->players) {
+        const auto& vstate = m_fields->interpolator->getPlayerState(playerId);
+
+        index.update(
+            playerId,
+            vstate.player1.position,
+            vstate.isDualMode ? std::optional(vstate.player2.position) : std::nullopt
+        );
+    }
+
+    auto& nearby = m_fields->nearbyIcons;
+
+    for (const auto [playerId, isSecond] : nearby) {
+        auto it = m_fields->players.find(playerId);
+        if (it == m_fields->players.end()) continue;
+
+        (isSecond ? it->second->player2 : it->second->player1)->setNearby(false);
+    }
+
+    nearby.clear();
+
+    // check if they are inside 3 screens
+    const auto& camState = m_fields->camState;
+
+    constexpr float fullScaleMult = 3.f;
+    constexpr float originMoveMult = (fullScaleMult - 1.f) / 2.f; // magic
+    CCSize origCoverage = camState.cameraCoverage();
+    CCSize cameraCoverage = origCoverage * fullScaleMult;
+    CCPoint cameraOrigin = camState.cameraOrigin - origCoverage * originMoveMult;
+
+    index.queryRect(CCRect{cameraOrigin, cameraCoverage}, [&](const PlayerSpatialIndex::Entry& entry) {
+        auto it = m_fields->players.find(entry.playerId);
+        if (it == m_fields->players.end()) return;
+
+        (entry.isSecond ? it->second->player2 : it->second->player1)->setNearby(true);
+        nearby.emplace_back(entry.playerId, entry.isSecond);
+    });
+}
+
+void GlobedGJBGL::handlePlayerJoin(int playerId) {
+    Ref<RemotePlayer> rp = this->acquirePooledPlayer();
+    rp->setID(util::cocos::spr(fmt::format("remote-player-{}", playerId)));
+
+    if (rp->progressIcon) {
+        rp->progressIcon->setID(util::cocos::spr(fmt::format("remote-player-progress-{}", playerId)));
+        m_fields->progressBarWrapper->addChild(rp->progressIcon);
+    } else if (rp->progressArrow) {
+        rp->progressArrow->setID(util::cocos::spr(fmt::format("remote-player-progress-{}", playerId)));
+        this->addChild(rp->progressArrow);
     }
 
     // if we are in the editor, hide the progress indicators
     if (this->isEditor()) {
-        if (progressArrow) {
-            progressArrow->setVisible(false);
+        if (rp->progressArrow) {
+            rp->progressArrow->setVisible(false);
         }
 
-        if (progressIcon) {
-            progressIcon->setVisible(false);
+        if (rp->progressIcon) {
+            rp->progressIcon->setVisible(false);
         }
     }
 
-    auto* rp = Build<RemotePlayer>::create(&m_fields->camState, progressIcon, progressArrow)
-        .zOrder(10)
-        .id(util::cocos::spr(fmt::format("remote-player-{}", playerId)))
-        .collect();
-
+    // the icons are only reassigned if they differ from the last player that used this node
     auto& pcm = ProfileCacheManager::get();
     auto pcmData = pcm.getData(playerId);
-    if (pcmData.has_value()) {
-        rp->updateAccountData(pcmData.value(), true);
-    }
+    rp->updateAccountData(pcmData.value_or(PlayerAccountData::DEFAULT_DATA));
 
     auto& bl = BlockListManager::get();
     if (bl.isHidden(playerId)) {
@@ -1012,12 +1101,87 @@ void GlobedGJBGL::handlePlayerLeave(int playerId) {
 
     GLOBED_EVENT(this, onPlayerLeave(rp));
 
-    rp->removeProgressIndicators();
+    if (m_fields->playerPool.size() < PLAYER_POOL_MAX_SIZE) {
+        rp->detachProgressIndicators();
+        rp->resetState();
+        m_fields->playerPool.emplace_back(rp);
+    } else {
+        rp->removeProgressIndicators();
+    }
+
     rp->removeFromParent();
 
     m_fields->players.erase(playerId);
+
+#ifdef GLOBED_DEBUG_INTERPOLATION
+    auto jstats = m_fields->interpolator->getJitterStats(playerId);
+    log::debug(
+        "player {} left, jitter buffer: {} snapshots, {} underruns, {} late, jitter {}ms, delay {}ms",
+        playerId, jstats.bufferDepth, jstats.underruns, jstats.lateFrames, jstats.jitter * 1000.f, jstats.delay * 1000.f
+    );
+#endif
+
     m_fields->interpolator->removePlayer(playerId);
     m_fields->playerStore->removePlayer(playerId);
+    m_fields->spatialIndex.remove(playerId);
+    m_fields->lodScheduler.remove(playerId);
+}
+
+Ref<RemotePlayer> GlobedGJBGL::createPooledPlayer() {
+    auto& settings = GlobedSettings::get();
+
+    PlayerProgressIcon* progressIcon = nullptr;
+    PlayerProgressArrow* progressArrow = nullptr;
+
+    if (settings.levelUi.progressIndicators) {
+        if (m_level->isPlatformer()) {
+            Build<PlayerProgressArrow>::create()
+                .zOrder(2)
+                .store(progressArrow);
+        } else {
+            Build<PlayerProgressIcon>::create()
+                .zOrder(2)
+                .store(progressIcon);
+        }
+    }
+
+    return Build<RemotePlayer>::create(&m_fields->camState, progressIcon, progressArrow)
+        .zOrder(10)
+        .collect();
+}
+
+Ref<RemotePlayer> GlobedGJBGL::acquirePooledPlayer() {
+    auto& pool = m_fields->playerPool;
+
+    // if the settings changed since the pool was filled, the pooled players have the wrong progress indicators
+    if (!pool.empty()) {
+        auto& settings = GlobedSettings::get();
+        bool platformer = m_level->isPlatformer();
+        bool wantsIcon = settings.levelUi.progressIndicators && !platformer;
+        bool wantsArrow = settings.levelUi.progressIndicators && platformer;
+
+        auto& rp = pool.back();
+        if ((rp->progressIcon != nullptr) != wantsIcon || (rp->progressArrow != nullptr) != wantsArrow) {
+            pool.clear();
+        }
+    }
+
+    if (pool.empty()) {
+        return this->createPooledPlayer();
+    }
+
+    Ref<RemotePlayer> rp = std::move(pool.back());
+    pool.pop_back();
+
+    return rp;
+}
+
+void GlobedGJBGL::warmPlayerPool(size_t count) {
+    auto& pool = m_fields->playerPool;
+
+    while (pool.size() < count) {
+        pool.emplace_back(this->createPooledPlayer());
+    }
 }
 
 bool GlobedGJBGL::established() {
@@ -1083,6 +1247,11 @@ void GlobedGJBGL::onQuitActions() {
 
         GLOBED_EVENT(this, onQuit());
     }
+
+#ifdef GLOBED_DEBUG_INTERPOLATION
+    // can be replayed later with tools/lerp_replay
+    LerpLogger::get().makeDump(Mod::get()->getSaveDir() / "lerp-dump.bin");
+#endif
 }
 
 void GlobedGJBGL::pausedUpdate(float dt) {
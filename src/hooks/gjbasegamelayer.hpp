@@ -6,6 +6,8 @@
 #include <data/types/room.hpp>
 #include <game/interpolator.hpp>
 #include <game/player_store.hpp>
+#include <game/spatial_index.hpp>
+#include <game/lod_scheduler.hpp>
 #include <game/module/base.hpp>
 #include <net/manager.hpp>
 #include <ui/game/player/remote_player.hpp>
@@ -32,6 +34,8 @@ class $modify(GlobedGJBGL, GJBaseGameLayer) {
         float lastServerUpdate = 0.f;
         std::unique_ptr<PlayerInterpolator> interpolator;
         std::unique_ptr<PlayerStore> playerStore;
+        PlayerSpatialIndex spatialIndex;
+        PlayerLodScheduler lodScheduler;
         RoomSettings roomSettings;
 
         std::vector<std::unique_ptr<BaseGameplayModule>> modules;
@@ -55,6 +59,9 @@ class $modify(GlobedGJBGL, GJBaseGameLayer) {
         // ui elements
         GlobedOverlay* overlay = nullptr;
         std::unordered_map<int, RemotePlayer*> players;
+        std::vector<Ref<RemotePlayer>> playerPool; // detached players ready to be reused by handlePlayerJoin
+        std::vector<std::pair<int, bool>> nearbyIcons; // (player id, is second icon) within 3 screens of the camera
+        std::vector<int> voiceInRange, lastVoiceInRange; // players within voice proximity range, sorted
         Ref<PlayerProgressIcon> selfProgressIcon = nullptr;
         Ref<CCNode> progressBarWrapper = nullptr;
         Ref<PlayerStatusIcons> selfStatusIcons = nullptr;
@@ -136,10 +143,22 @@ class $modify(GlobedGJBGL, GJBaseGameLayer) {
 
     bool shouldLetMessageThrough(int playerId);
     void updateProximityVolume(int playerId);
+    // update the volume of everyone in voice proximity range, and of everyone who just left it
+    void updateProximityVolumes();
+
+    // move everyone in the spatial index to their interpolated position, and mark the ones close to the camera as nearby
+    void updateSpatialIndex();
 
     void handlePlayerJoin(int playerId);
     void handlePlayerLeave(int playerId);
 
+    // create a detached remote player with the progress indicator that the current settings ask for
+    Ref<RemotePlayer> createPooledPlayer();
+    // take a player out of the pool, or create a new one if the pool is empty
+    Ref<RemotePlayer> acquirePooledPlayer();
+    // fill the pool up to `count` players
+    void warmPlayerPool(size_t count);
+
     /* misc */
 
     bool established();
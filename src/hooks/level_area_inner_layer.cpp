@@ -1,7 +1,5 @@
 #include "level_area_inner_layer.hpp"
 
-#include <data/packets/client/general.hpp>
-#include <data/packets/server/general.hpp>
 #include <net/manager.hpp>
 
 using namespace geode::prelude;
@@ -45,39 +43,24 @@ bool HookedLevelAreaInnerLayer::init(bool p0) {
         m_fields->doorNodes[id] = wrapper;
     }
 
-    nm.addListener<LevelPlayerCountPacket>(this, [this](auto packet) {
-        auto currentLayer = getChildOfType<LevelAreaInnerLayer>(CCScene::get(), 0);
-        if (currentLayer && this != currentLayer) return;
-
-        m_fields->levels.clear();
-        for (const auto& level : packet->levels) {
-            m_fields->levels[level.first] = level.second;
-        }
-
+    nm.subscribePlayerCounts(this, std::vector<LevelId>(TOWER_LEVELS.begin(), TOWER_LEVELS.end()), [this] {
         this->updatePlayerCounts();
     });
 
-    this->schedule(schedule_selector(HookedLevelAreaInnerLayer::sendRequest), 5.f);
-    this->sendRequest(0.f);
+    // show cached counts until the server sends fresh ones
+    this->updatePlayerCounts();
 
     return true;
 }
 
-void HookedLevelAreaInnerLayer::sendRequest(float) {
+void HookedLevelAreaInnerLayer::updatePlayerCounts() {
     auto& nm = NetworkManager::get();
-    if (nm.established()) {
-        nm.send(RequestPlayerCountPacket::create(std::move(std::vector<LevelId>(TOWER_LEVELS.begin(), TOWER_LEVELS.end()))));
-    }
-}
 
-void HookedLevelAreaInnerLayer::updatePlayerCounts() {
     for (int id : TOWER_LEVELS) {
-        if (!m_fields->levels.contains(id)) {
-            m_fields->doorNodes[id]->setVisible(false);
-            continue;
-        }
+        if (!m_fields->doorNodes.contains(id)) continue;
 
-        if (m_fields->levels.at(id) == 0) {
+        auto count = nm.getPlayerCount(id);
+        if (!count || *count == 0) {
             m_fields->doorNodes[id]->setVisible(false);
             continue;
         }
@@ -86,7 +69,7 @@ void HookedLevelAreaInnerLayer::updatePlayerCounts() {
         auto* label = m_fields->doorNodes[id]->getChildByID("door-playercount-label"_spr);
         if (!label) continue;
 
-        static_cast<CCLabelBMFont*>(label)->setString(std::to_string(m_fields->levels.at(id)).c_str());
+        static_cast<CCLabelBMFont*>(label)->setString(std::to_string(*count).c_str());
 
         m_fields->doorNodes[id]->updateLayout();
     }
@@ -9,7 +9,6 @@ class $modify(HookedLevelAreaInnerLayer, LevelAreaInnerLayer) {
     static inline const auto TOWER_LEVELS = std::to_array<LevelId>({5001, 5002, 5003, 5004});
 
     struct Fields {
-        std::unordered_map<int, uint16_t> levels;
         std::unordered_map<int, Ref<cocos2d::CCNode>> doorNodes;
     };
 
@@ -22,6 +21,5 @@ class $modify(HookedLevelAreaInnerLayer, LevelAreaInnerLayer) {
     $override
     void onDoor(cocos2d::CCObject*);
 
-    void sendRequest(float);
     void updatePlayerCounts();
 };
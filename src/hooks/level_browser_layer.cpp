@@ -2,8 +2,6 @@
 
 #include <hooks/level_cell.hpp>
 #include <hooks/gjgamelevel.hpp>
-#include <data/packets/client/general.hpp>
-#include <data/packets/server/general.hpp>
 #include <net/manager.hpp>
 
 using namespace geode::prelude;
@@ -28,22 +26,19 @@ void HookedLevelBrowserLayer::setupLevelBrowser(cocos2d::CCArray* p0) {
         }
     }
 
-    nm.send(RequestPlayerCountPacket::create(std::move(levelIds)));
-    nm.addListener<LevelPlayerCountPacket>(this, [this](std::shared_ptr<LevelPlayerCountPacket> packet) {
-        for (const auto& [levelId, playerCount] : packet->levels) {
-            m_fields->levels[levelId] = playerCount;
-        }
-
+    nm.subscribePlayerCounts(this, std::move(levelIds), [this] {
         this->refreshPagePlayerCounts();
     });
 
-    this->schedule(schedule_selector(HookedLevelBrowserLayer::updatePlayerCounts), 5.0f);
+    // show cached counts until the server sends fresh ones
+    this->refreshPagePlayerCounts();
 }
 
 void HookedLevelBrowserLayer::refreshPagePlayerCounts() {
     if (!m_list->m_listView) return;
 
     bool inLists = typeinfo_cast<LevelListLayer*>(this) != nullptr;
+    auto& nm = NetworkManager::get();
 
     for (auto* cell_ : CCArrayExt<CCNode*>(m_list->m_listView->m_tableView->m_contentLayer->getChildren())) {
         if (!typeinfo_cast<LevelCell*>(cell_)) continue;
@@ -52,26 +47,10 @@ void HookedLevelBrowserLayer::refreshPagePlayerCounts() {
         if (!isValidLevelType(cell->m_level->m_levelType)) continue;
 
         LevelId levelId = HookedGJGameLevel::getLevelIDFrom(cell->m_level);
-        if (m_fields->levels.contains(levelId)) {
-            cell->updatePlayerCount(m_fields->levels.at(levelId), inLists);
+        if (auto count = nm.getPlayerCount(levelId)) {
+            cell->updatePlayerCount(*count, inLists);
         } else {
             cell->updatePlayerCount(-1, inLists);
         }
     }
 }
-
-void HookedLevelBrowserLayer::updatePlayerCounts(float) {
-    auto& nm = NetworkManager::get();
-    if (nm.established() && m_list->m_listView) {
-        std::vector<LevelId> levelIds;
-        for (auto* cell_ : CCArrayExt<CCNode*>(m_list->m_listView->m_tableView->m_contentLayer->getChildren())) {
-            if (auto* cell = typeinfo_cast<LevelCell*>(cell_)) {
-                if (isValidLevelType(cell->m_level->m_levelType)) {
-                    levelIds.push_back(HookedGJGameLevel::getLevelIDFrom(cell->m_level));
-                }
-            }
-        }
-
-        nm.send(RequestPlayerCountPacket::create(std::move(levelIds)));
-    }
-}
\ No newline at end of file
@@ -6,15 +6,10 @@
 #include <data/types/gd.hpp>
 
 class $modify(HookedLevelBrowserLayer, LevelBrowserLayer) {
-    struct Fields {
-        std::unordered_map<LevelId, uint16_t> levels;
-    };
-
     $override
     void setupLevelBrowser(cocos2d::CCArray* p0);
 
     void refreshPagePlayerCounts();
-    void updatePlayerCounts(float);
 
     constexpr bool isValidLevelType(GJLevelType level) {
         return (int)level == 3 || (int)level == 4;
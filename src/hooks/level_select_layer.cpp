@@ -1,8 +1,6 @@
 #include "level_select_layer.hpp"
 
 #include <hooks/gjgamelevel.hpp>
-#include <data/packets/client/general.hpp>
-#include <data/packets/server/general.hpp>
 #include <net/manager.hpp>
 #include <managers/settings.hpp>
 
@@ -80,29 +78,12 @@ bool HookedLevelSelectLayer::init(int p0) {
     auto& nm = NetworkManager::get();
     if (!nm.established()) return true;
 
-    nm.addListener<LevelPlayerCountPacket>(this, [this](auto packet) {
-        auto currentLayer = getChildOfType<LevelSelectLayer>(CCScene::get(), 0);
-        if (currentLayer && this != currentLayer) return;
-
-        m_fields->levels.clear();
-        for (const auto& level : packet->levels) {
-            m_fields->levels[level.first] = level.second;
-        }
-
+    nm.subscribePlayerCounts(this, std::vector<LevelId>(MAIN_LEVELS.begin(), MAIN_LEVELS.end()), [this] {
         this->updatePlayerCounts();
     });
 
-    this->schedule(schedule_selector(HookedLevelSelectLayer::sendRequest), 5.f);
-    this->sendRequest(0.f);
-
     return true;
 }
-void HookedLevelSelectLayer::sendRequest(float) {
-    auto& nm = NetworkManager::get();
-    if (nm.established()) {
-        nm.send(RequestPlayerCountPacket::create(std::move(std::vector<LevelId>(MAIN_LEVELS.begin(), MAIN_LEVELS.end()))));
-    }
-}
 
 void HookedLevelSelectLayer::updatePlayerCounts() {
     auto* bsl = getChildOfType<BoomScrollLayer>(this, 0);
@@ -132,11 +113,12 @@ void HookedLevelSelectLayer::updatePlayerCounts() {
                 .store(label);
         }
 
-        if (!NetworkManager::get().established()) {
+        auto& nm = NetworkManager::get();
+
+        if (!nm.established()) {
             label->setVisible(false);
-        } else if (m_fields->levels.contains(levelId)) {
-            auto players = m_fields->levels[levelId];
-            label->updateCount(players);
+        } else if (auto players = nm.getPlayerCount(levelId)) {
+            label->updateCount(*players);
         } else {
             label->updateCount(-1);
         }
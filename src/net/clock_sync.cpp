@@ -0,0 +1,129 @@
+#include "clock_sync.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+uint64_t ClockSync::localMicros() {
+    // steady, unlike `util::time::clock`, which may be the system clock on some platforms
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void ClockSync::addSample(uint64_t clientTime, uint64_t serverTime) {
+    int64_t received = static_cast<int64_t>(localMicros());
+    int64_t sent = static_cast<int64_t>(clientTime);
+
+    // a response to a keepalive from before a reset, or from an older server that doesn't echo anything
+    if (sent == 0 || serverTime == 0 || sent > received) return;
+
+    int64_t local = sent + (received - sent) / 2;
+
+    auto state = this->state.lock();
+
+    state->samples[state->next] = Sample {
+        .local = local,
+        .offset = static_cast<int64_t>(serverTime) - local,
+        .rtt = received - sent,
+    };
+
+    state->next = (state->next + 1) % MAX_SAMPLES;
+    state->count = std::min(state->count + 1, MAX_SAMPLES);
+
+    bool first = state->epoch == 0;
+    updateEstimate(*state);
+
+    if (first) {
+        constexpr int64_t period = static_cast<int64_t>(WRAP_PERIOD) * 1'000'000;
+        int64_t serverNow = local + state->offset;
+        state->epoch = serverNow - serverNow % period;
+    }
+}
+
+void ClockSync::updateEstimate(State& state) {
+    const Sample* best = &state.samples[0];
+    for (size_t i = 1; i < state.count; i++) {
+        if (state.samples[i].rtt < best->rtt) {
+            best = &state.samples[i];
+        }
+    }
+
+    state.reference = best->local;
+    state.offset = best->offset;
+    state.rtt = best->rtt;
+
+    // fit a line through the offsets of samples that were nearly as fast as the best one, its slope is the drift
+    int64_t maxRtt = best->rtt * 2 + 2000;
+
+    size_t n = 0;
+    double meanX = 0.0, meanY = 0.0;
+    int64_t minLocal = best->local, maxLocal = best->local;
+
+    for (size_t i = 0; i < state.count; i++) {
+        const auto& sample = state.samples[i];
+        if (sample.rtt > maxRtt) continue;
+
+        n++;
+        meanX += static_cast<double>(sample.local - best->local);
+        meanY += static_cast<double>(sample.offset - best->offset);
+        minLocal = std::min(minLocal, sample.local);
+        maxLocal = std::max(maxLocal, sample.local);
+    }
+
+    // not enough data, keep whatever drift we had before
+    if (n < MIN_SAMPLES || maxLocal - minLocal < MIN_DRIFT_SPAN) return;
+
+    meanX /= n;
+    meanY /= n;
+
+    double covariance = 0.0, variance = 0.0;
+    for (size_t i = 0; i < state.count; i++) {
+        const auto& sample = state.samples[i];
+        if (sample.rtt > maxRtt) continue;
+
+        double x = static_cast<double>(sample.local - best->local) - meanX;
+        double y = static_cast<double>(sample.offset - best->offset) - meanY;
+        covariance += x * y;
+        variance += x * x;
+    }
+
+    state.drift = std::clamp(covariance / variance, -MAX_DRIFT, MAX_DRIFT);
+}
+
+void ClockSync::reset() {
+    *this->state.lock() = State{};
+}
+
+bool ClockSync::isSynced() {
+    return this->state.lock()->count >= MIN_SAMPLES;
+}
+
+double ClockSync::nowLocked(const State& state) {
+    int64_t local = static_cast<int64_t>(localMicros());
+    double server = static_cast<double>(local - state.reference) * (1.0 + state.drift) + static_cast<double>(state.reference + state.offset - state.epoch);
+
+    return server / 1'000'000.0;
+}
+
+double ClockSync::now() {
+    return nowLocked(*this->state.lock());
+}
+
+float ClockSync::wrappedNow() {
+    return static_cast<float>(std::fmod(this->now(), WRAP_PERIOD));
+}
+
+double ClockSync::unwrap(float timestamp) {
+    double periods = std::round((this->now() - timestamp) / WRAP_PERIOD);
+    return static_cast<double>(timestamp) + periods * WRAP_PERIOD;
+}
+
+ClockSync::Stats ClockSync::getStats() {
+    auto state = this->state.lock();
+
+    return Stats {
+        .offset = static_cast<double>(state->offset) / 1'000'000.0,
+        .drift = state->drift * 1'000'000.0,
+        .rtt = static_cast<double>(state->rtt) / 1'000'000.0,
+        .samples = state->count,
+    };
+}
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <array>
+#include <asp/sync.hpp>
+
+#include <util/singleton.hpp>
+
+/*
+* ClockSync - estimates the offset and drift between our clock and the game server's clock (protocol v14 and newer).
+*
+* Every keepalive carries our clock, and the response echoes it back together with the server's clock, like an NTP exchange.
+* The sample with the lowest round trip time has the most symmetric delay, so the offset is taken from the best recent one,
+* and the drift is fitted through all samples that are nearly as good.
+*
+* Synchronized time is exposed in seconds since an epoch picked when the first sample arrives. Player data timestamps are sent
+* wrapped to `WRAP_PERIOD`, which makes them the same for every client while still fitting in a float with sub-millisecond precision.
+*
+* Thread safe, samples arrive on the network thread while the game reads the time.
+*/
+class ClockSync : public SingletonBase<ClockSync> {
+public:
+    static constexpr size_t MAX_SAMPLES = 8;
+    // samples needed before the clock counts as synchronized
+    static constexpr size_t MIN_SAMPLES = 3;
+    // in seconds, 4096 keeps a float timestamp accurate to half a millisecond
+    static constexpr double WRAP_PERIOD = 4096.0;
+    // drift estimates beyond this are measurement errors, real clocks are within a few dozen ppm
+    static constexpr double MAX_DRIFT = 500e-6;
+    // drift is only estimated once the good samples span at least this long, in microseconds
+    static constexpr int64_t MIN_DRIFT_SPAN = 20'000'000;
+
+    // our monotonic clock in microseconds, this is what gets sent in `KeepalivePacket`
+    static uint64_t localMicros();
+
+    // Process a keepalive response. `clientTime` is the echoed time the keepalive was sent at, `serverTime` is the server's clock
+    void addSample(uint64_t clientTime, uint64_t serverTime);
+
+    // Forget all samples, called when connecting to a server
+    void reset();
+
+    bool isSynced();
+
+    // current synchronized time, in seconds since the epoch
+    double now();
+
+    // current synchronized time wrapped to `WRAP_PERIOD`, sent as `PlayerData::timestamp`
+    float wrappedNow();
+
+    // Turn a wrapped timestamp of another client into seconds since our epoch, by picking the period closest to now.
+    // The same timestamp always maps to the same value, as long as it's within half a period from now.
+    double unwrap(float timestamp);
+
+    struct Stats {
+        double offset; // server clock - local clock, in seconds
+        double drift;  // how much faster the server clock runs, in parts per million
+        double rtt;    // round trip time of the sample the offset comes from, in seconds
+        size_t samples;
+    };
+
+    Stats getStats();
+
+private:
+    friend class SingletonBase;
+    ClockSync() = default;
+
+    struct Sample {
+        int64_t local;  // midpoint between sending and receiving, on our clock
+        int64_t offset; // server clock - our clock
+        int64_t rtt;
+    };
+
+    struct State {
+        std::array<Sample, MAX_SAMPLES> samples;
+        size_t count = 0;
+        size_t next = 0;
+
+        // server time = local + offset + drift * (local - reference)
+        int64_t reference = 0;
+        int64_t offset = 0;
+        int64_t rtt = 0;
+        double drift = 0.0;
+
+        // server time of the epoch in microseconds, a multiple of `WRAP_PERIOD` so that wrapped timestamps agree between clients
+        int64_t epoch = 0;
+    };
+
+    asp::Mutex<State> state;
+
+    static void updateEstimate(State& state);
+    static double nowLocked(const State& state);
+};
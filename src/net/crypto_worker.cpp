@@ -0,0 +1,82 @@
+#include "crypto_worker.hpp"
+
+#include "game_socket.hpp"
+
+#include <thread>
+
+#include <data/bytebuffer.hpp>
+#include <util/time.hpp>
+
+using namespace geode::prelude;
+
+CryptoWorker::CryptoWorker(GameSocket& socket) : socket(socket) {
+    thread.setLoopFunction(&CryptoWorker::threadFunc);
+    thread.setStartFunction([] { geode::utils::thread::setName("Crypto Thread"); });
+    thread.start(this);
+}
+
+CryptoWorker::~CryptoWorker() {
+    thread.stopAndWait();
+}
+
+bool CryptoWorker::submit(Job&& job) {
+    auto& count = inFlight[static_cast<size_t>(job.channel)];
+
+    // tcp packets must never be lost, if too many of them pile up the worker just waits for us to catch up
+    if (job.channel == SessionBox::Channel::Udp && inFlight[0] + inFlight[1] >= MAX_PENDING) {
+        if (dropped++ % 256 == 0) {
+            log::warn("crypto worker is overloaded, dropped {} packets so far", dropped);
+        }
+
+        return false;
+    }
+
+    count++;
+    jobs.push(std::move(job));
+
+    return true;
+}
+
+std::optional<CryptoWorker::Output> CryptoWorker::tryPop() {
+    auto out = done.tryPop();
+
+    if (out) {
+        inFlight[static_cast<size_t>(out->channel)]--;
+    }
+
+    return out;
+}
+
+size_t CryptoWorker::pending(SessionBox::Channel channel) const {
+    return inFlight[static_cast<size_t>(channel)];
+}
+
+void CryptoWorker::threadFunc(decltype(thread)::StopToken&) {
+    // time out every now and then, so that stopping the thread doesn't hang
+    auto job_ = jobs.popTimeout(util::time::millis(50));
+    if (!job_) return;
+
+    auto job = std::move(job_.value());
+
+    Output out {
+        .session = std::move(job.session),
+        .channel = job.channel,
+        .fromConnected = job.fromConnected,
+    };
+
+    ByteBuffer buf(job.data.data(), job.data.size(), ByteBuffer::borrow);
+
+    auto result = socket.decodePacket(buf, job.channel, out.session.get());
+    if (result) {
+        out.packet = std::move(result.unwrap());
+    } else {
+        out.error = std::move(result.unwrapErr());
+    }
+
+    // the network thread is way faster at draining this than we are at filling it, this only spins in extreme cases
+    while (!done.tryPush(std::move(out))) {
+        std::this_thread::yield();
+    }
+
+    socket.wakeup();
+}
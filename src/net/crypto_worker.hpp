@@ -0,0 +1,64 @@
+#pragma once
+
+#include <data/packets/packet.hpp>
+#include <crypto/session_box.hpp>
+#include <util/data.hpp>
+#include <util/lockfree.hpp>
+
+#include <asp/sync.hpp>
+#include <asp/thread.hpp>
+
+class GameSocket;
+
+/*
+* CryptoWorker - decrypts and decodes encrypted packets off the network thread.
+*
+* The network thread only reads packets off the sockets and looks at their header. Encrypted ones are copied into a job
+* and handed to this worker, so that a burst of voice packets doesn't hold up the unencrypted player data arriving right behind it.
+* There is a single worker thread and it handles jobs in order, so packets on the same channel come out in the order they were received.
+* Finished packets are queued back to the network thread, which dispatches them like any other packet.
+*/
+class CryptoWorker {
+public:
+    // finished packets that haven't been collected yet, the network thread stops handing off UDP packets past this
+    static constexpr size_t MAX_PENDING = 1024;
+
+    struct Job {
+        std::shared_ptr<SessionBox> session;
+        SessionBox::Channel channel = SessionBox::Channel::Tcp;
+        util::data::bytevector data;
+        bool fromConnected = false;
+    };
+
+    struct Output {
+        std::shared_ptr<SessionBox> session;
+        SessionBox::Channel channel = SessionBox::Channel::Tcp;
+        std::shared_ptr<Packet> packet; // nullptr if decryption or decoding failed
+        bool fromConnected = false;
+        std::string error;
+    };
+
+    CryptoWorker(GameSocket& socket);
+    CryptoWorker(const CryptoWorker&) = delete;
+    CryptoWorker& operator=(const CryptoWorker&) = delete;
+    ~CryptoWorker();
+
+    // Network thread only. Returns false (and drops the job) if it's a UDP packet and too many are pending already.
+    bool submit(Job&& job);
+
+    // Network thread only.
+    std::optional<Output> tryPop();
+
+    // Network thread only. Amount of jobs on this channel that were submitted, but not popped yet.
+    size_t pending(SessionBox::Channel channel) const;
+
+private:
+    GameSocket& socket;
+    asp::Thread<CryptoWorker*> thread;
+    asp::Channel<Job> jobs;
+    util::lockfree::SpscQueue<Output, MAX_PENDING * 2> done;
+    size_t inFlight[2] = {0, 0};
+    size_t dropped = 0;
+
+    void threadFunc(decltype(thread)::StopToken&);
+};
@@ -0,0 +1,128 @@
+#include "delta_sync.hpp"
+
+#include <cmath>
+#include <limits>
+#include <data/packets/pool.hpp>
+
+
+std::shared_ptr<PlayerDataDeltaPacket> PlayerDeltaSync::encode(const PlayerDataPacket& packet) {
+    uint32_t seq = ++lastSentSeq;
+
+    const PlayerData* baseline = nullptr;
+    if (ackedSeq != 0 && seq - ackedSeq <= std::numeric_limits<uint8_t>::max()) {
+        baseline = sent.get(ackedSeq);
+    }
+
+    auto pkt = std::make_shared<PlayerDataDeltaPacket>();
+    pkt->seq = seq;
+    pkt->baselineOffset = baseline ? seq - ackedSeq : 0;
+    pkt->ack = lastReceivedSeq;
+    pkt->ackBits = receivedBits;
+    pkt->needsKeyframe = std::exchange(needsKeyframe, false);
+    pkt->data = PlayerDataDelta::diff(packet.data, baseline);
+    pkt->meta = packet.meta;
+
+    sent.push(seq, packet.data);
+
+    return pkt;
+}
+
+std::shared_ptr<LevelDataPacket> PlayerDeltaSync::decode(const LevelDataDeltaPacket& packet) {
+    this->markReceived(packet.seq);
+
+    if (packet.needsKeyframe) {
+        ackedSeq = 0;
+    } else if (packet.ack > ackedSeq) {
+        ackedSeq = packet.ack;
+    }
+
+    // pooled, so that the vector keeps its capacity between packets
+    auto out = PacketPool<LevelDataPacket>::get().acquire();
+    out->players.clear();
+    out->players.reserve(packet.players.entries.size());
+
+    for (const auto& entry : packet.players.entries) {
+        // seq 0 means the player does not use delta encoding, it is always a keyframe and never a baseline
+        if (entry.seq == 0) {
+            auto data = entry.delta.apply(nullptr);
+            this->unwrapRotations(entry.accountId, data);
+            out->players.emplace_back(entry.accountId, data);
+            continue;
+        }
+
+        auto& history = players[entry.accountId];
+
+        // the player's sequence went far back, they must have reconnected
+        if (entry.seq < history.latest && history.latest - entry.seq > HISTORY_SIZE) {
+            history.clear();
+        }
+
+        const PlayerData* baseline = nullptr;
+        if (!entry.delta.isKeyframe()) {
+            baseline = history.get(entry.seq - entry.baselineOffset);
+            if (!baseline) {
+                needsKeyframe = true;
+                continue;
+            }
+        }
+
+        auto data = entry.delta.apply(baseline);
+        this->unwrapRotations(entry.accountId, data);
+        history.push(entry.seq, data);
+        out->players.emplace_back(entry.accountId, data);
+    }
+
+    return out;
+}
+
+void PlayerDeltaSync::reset() {
+    ackedSeq = 0;
+    sent.clear();
+
+    players.clear();
+    lastRotations.clear();
+    // the server may still hold baselines that we just dropped
+    needsKeyframe = true;
+}
+
+void PlayerDeltaSync::resetConnection() {
+    this->reset();
+
+    lastReceivedSeq = 0;
+    receivedBits = 0;
+}
+
+void PlayerDeltaSync::unwrapRotations(int accountId, PlayerData& data) {
+    auto [it, inserted] = lastRotations.try_emplace(accountId, data.player1.rotation, data.player2.rotation);
+
+    if (!inserted) {
+        auto& [p1, p2] = it->second;
+        data.player1.rotation = p1 + std::remainder(data.player1.rotation - p1, 360.f);
+        data.player2.rotation = p2 + std::remainder(data.player2.rotation - p2, 360.f);
+        it->second = {data.player1.rotation, data.player2.rotation};
+    }
+}
+
+void PlayerDeltaSync::markReceived(uint32_t seq) {
+    if (seq > lastReceivedSeq) {
+        uint32_t shift = seq - lastReceivedSeq;
+
+        if (shift >= 32) {
+            receivedBits = 0;
+        } else {
+            receivedBits <<= shift;
+        }
+
+        // the previous newest packet now becomes one of the bits
+        if (lastReceivedSeq != 0 && shift <= 32) {
+            receivedBits |= 1u << (shift - 1);
+        }
+
+        lastReceivedSeq = seq;
+    } else if (seq < lastReceivedSeq) {
+        uint32_t distance = lastReceivedSeq - seq;
+        if (distance <= 32) {
+            receivedBits |= 1u << (distance - 1);
+        }
+    }
+}
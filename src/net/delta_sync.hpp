@@ -0,0 +1,74 @@
+#pragma once
+
+#include <data/packets/client/game.hpp>
+#include <data/packets/server/game.hpp>
+
+/*
+* PlayerDeltaSync - client side of the delta encoded player data exchange (protocol v12 and newer).
+*
+* Outgoing PlayerDataPackets are turned into deltas against the newest of our snapshots that the server confirmed applying,
+* and incoming LevelDataDeltaPackets are turned back into plain LevelDataPackets, so that listeners never see deltas.
+* Whenever a baseline is missing on either side, a keyframe is used instead.
+*
+* Not thread safe, must only be used from the network thread.
+*/
+class PlayerDeltaSync {
+public:
+    static constexpr size_t HISTORY_SIZE = 32;
+
+    // Encode an outgoing packet relative to the last acknowledged snapshot
+    std::shared_ptr<PlayerDataDeltaPacket> encode(const PlayerDataPacket& packet);
+
+    // Reconstruct full player data. Players whose baseline we no longer have are left out, and a keyframe is requested.
+    std::shared_ptr<LevelDataPacket> decode(const LevelDataDeltaPacket& packet);
+
+    // Forget all baselines, called when joining or leaving a level
+    void reset();
+
+    // Like `reset`, but also forgets which packets were received, called when connecting to a server
+    void resetConnection();
+
+private:
+    template <typename T>
+    class History {
+    public:
+        void push(uint32_t seq, const T& value) {
+            entries[seq % HISTORY_SIZE] = std::make_pair(seq, value);
+            latest = std::max(latest, seq);
+        }
+
+        const T* get(uint32_t seq) const {
+            auto& entry = entries[seq % HISTORY_SIZE];
+            return (entry && entry->first == seq) ? &entry->second : nullptr;
+        }
+
+        void clear() {
+            entries.fill(std::nullopt);
+            latest = 0;
+        }
+
+        uint32_t latest = 0;
+
+    private:
+        std::array<std::optional<std::pair<uint32_t, T>>, HISTORY_SIZE> entries;
+    };
+
+    // upstream, not reset between levels so that the server never mistakes new packets for old ones
+    uint32_t lastSentSeq = 0;
+    uint32_t ackedSeq = 0;
+    History<PlayerData> sent;
+
+    // downstream
+    uint32_t lastReceivedSeq = 0;
+    uint32_t receivedBits = 0;
+    bool needsKeyframe = false;
+    std::unordered_map<int, History<PlayerData>> players;
+    // the rotations of the newest decoded snapshot of every player, see `unwrapRotations`
+    std::unordered_map<int, std::pair<float, float>> lastRotations;
+
+    void markReceived(uint32_t seq);
+
+    // Quantized rotations are wrapped into [-180, 180), turn them back into a continuous angle by picking the one closest
+    // to the previous snapshot of the player. This way a spin across the wrap point is lerped like any other rotation.
+    void unwrapRotations(int accountId, PlayerData& data);
+};
@@ -0,0 +1,136 @@
+#include "dispatch_table.hpp"
+
+#include <limits>
+
+using namespace geode::prelude;
+
+struct WeakRefDummy {
+    std::shared_ptr<WeakRefController> ctrl;
+};
+
+template <typename T>
+static void* addrFromWeakRef(const WeakRef<T>& ref) {
+    // Do not do this.
+    auto dummy = reinterpret_cast<const WeakRefDummy&>(ref);
+    return dummy.ctrl ? dummy.ctrl->get() : nullptr;
+}
+
+PacketDispatchTable::PacketDispatchTable() : bucketIndex(std::numeric_limits<packetid_t>::max() + 1, 0) {}
+
+void PacketDispatchTable::registerListener(packetid_t id, PacketListener* listener) {
+    if (dispatching) {
+        pending.push_back(PendingRegistration {
+            .id = id,
+            .listener = WeakRef(listener),
+        });
+        return;
+    }
+
+    this->insertListener(id, listener);
+}
+
+bool PacketDispatchTable::dispatch(const std::shared_ptr<Packet>& packet) {
+    packetid_t id = packet->getPacketId();
+
+    bool invoked = false;
+
+    // look up by index rather than holding a reference, a callback may register a listener and reallocate `buckets`,
+    // though those registrations are deferred until we are done here
+    size_t idx = bucketIndex[id];
+    if (idx != 0) {
+        dispatching = true;
+
+        bool sawDead = false;
+        auto& entries = buckets[idx - 1].entries;
+
+        for (auto& entry : entries) {
+            auto l = entry.listener.lock();
+            if (!l) {
+                sawDead = true;
+                continue;
+            }
+
+            invoked = true;
+            l->invokeCallback(packet);
+
+            if (l->isFinal) {
+                break;
+            }
+        }
+
+        dispatching = false;
+
+        if (sawDead) {
+            this->removeDeadListeners(buckets[idx - 1]);
+        }
+    }
+
+    if (!pending.empty()) {
+        for (auto& reg : pending) {
+            if (auto l = reg.listener.lock()) {
+                this->insertListener(reg.id, l.data());
+            }
+        }
+
+        pending.clear();
+    }
+
+    return invoked;
+}
+
+void PacketDispatchTable::clear() {
+    std::fill(bucketIndex.begin(), bucketIndex.end(), 0);
+    buckets.clear();
+    pending.clear();
+}
+
+PacketDispatchTable::Bucket* PacketDispatchTable::getBucket(packetid_t id) {
+    size_t idx = bucketIndex[id];
+    return idx == 0 ? nullptr : &buckets[idx - 1];
+}
+
+PacketDispatchTable::Bucket& PacketDispatchTable::getOrCreateBucket(packetid_t id) {
+    if (auto bucket = this->getBucket(id)) {
+        return *bucket;
+    }
+
+    buckets.push_back(Bucket { .id = id });
+    bucketIndex[id] = buckets.size();
+
+    return buckets.back();
+}
+
+void PacketDispatchTable::insertListener(packetid_t id, PacketListener* listener) {
+    auto& bucket = this->getOrCreateBucket(id);
+
+    // registration is rare compared to dispatch, so take this chance to clean up
+    this->removeDeadListeners(bucket);
+
+    for (auto& entry : bucket.entries) {
+        if (entry.listener.lock() == listener) {
+            log::warn("duped listener ({}, id {}, owner {}), not adding again", listener, id, listener->owner);
+            return;
+        }
+    }
+
+    // insert after all listeners with the same or lower priority, so equal priorities run in registration order
+    auto pos = std::upper_bound(bucket.entries.begin(), bucket.entries.end(), listener->priority, [](int priority, const Entry& entry) {
+        return priority < entry.priority;
+    });
+
+    bucket.entries.insert(pos, Entry {
+        .listener = WeakRef(listener),
+        .priority = listener->priority,
+    });
+}
+
+void PacketDispatchTable::removeDeadListeners(Bucket& bucket) {
+    std::erase_if(bucket.entries, [&](const Entry& entry) {
+        if (entry.listener.valid()) return false;
+
+#ifdef GLOBED_DEBUG
+        log::debug("Unregistering listener {} (id {})", addrFromWeakRef(entry.listener), bucket.id);
+#endif
+        return true;
+    });
+}
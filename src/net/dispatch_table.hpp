@@ -0,0 +1,62 @@
+#pragma once
+
+#include "listener.hpp"
+
+#include <defs/geode.hpp>
+#include <data/packets/packet.hpp>
+
+/*
+* PacketDispatchTable - maps packet IDs to the listeners that should receive them.
+*
+* Every bucket is kept sorted by priority at registration time, so dispatching a packet is a single
+* lookup followed by a linear walk, without sorting or allocating anything.
+* Listeners whose owner got destroyed are removed lazily, when dispatch runs into them.
+*
+* Not thread safe, must only be used from one thread (the main thread for the global listener pool).
+*/
+class PacketDispatchTable {
+public:
+    PacketDispatchTable();
+
+    PacketDispatchTable(const PacketDispatchTable&) = delete;
+    PacketDispatchTable& operator=(const PacketDispatchTable&) = delete;
+
+    // Register a listener. If called from within a listener callback, the registration is applied after the current packet is dispatched.
+    void registerListener(packetid_t id, PacketListener* listener);
+
+    // Deliver the packet to all live listeners of its ID in priority order, stopping after the first final listener.
+    // Returns whether any listener was invoked.
+    bool dispatch(const std::shared_ptr<Packet>& packet);
+
+    // Remove every listener from the table
+    void clear();
+
+private:
+    struct Entry {
+        geode::WeakRef<PacketListener> listener;
+        // cached so that ordering never needs to lock the weak reference
+        int priority;
+    };
+
+    struct Bucket {
+        packetid_t id;
+        std::vector<Entry> entries;
+    };
+
+    struct PendingRegistration {
+        packetid_t id;
+        geode::WeakRef<PacketListener> listener;
+    };
+
+    // indexed directly by packet ID, stores the index into `buckets` plus one, 0 means no bucket exists for the ID
+    std::vector<uint16_t> bucketIndex;
+    std::vector<Bucket> buckets;
+
+    std::vector<PendingRegistration> pending;
+    bool dispatching = false;
+
+    Bucket* getBucket(packetid_t id);
+    Bucket& getOrCreateBucket(packetid_t id);
+    void insertListener(packetid_t id, PacketListener* listener);
+    void removeDeadListeners(Bucket& bucket);
+};
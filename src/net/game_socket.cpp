@@ -2,6 +2,7 @@
 
 #include <data/bytebuffer.hpp>
 #include <data/packets/all.hpp>
+#include <util/compress.hpp>
 #include <util/debug.hpp>
 #include <util/net.hpp>
 #include <util/format.hpp>
@@ -21,7 +22,7 @@ using namespace util::debug;
 using PollResult = GameSocket::PollResult;
 using ReceivedPacket = GameSocket::ReceivedPacket;
 
-GameSocket::GameSocket() {
+GameSocket::GameSocket() : cryptoWorker(*this) {
     dataBuffer = new byte[DATA_BUF_SIZE];
 }
 
@@ -62,20 +63,27 @@ bool GameSocket::isConnected() {
 }
 
 Result<std::shared_ptr<Packet>> GameSocket::recvPacketTCP() {
-    ByteBuffer bb;
-    bb.grow(4);
+    GLOBED_UNWRAP_INTO(tcpSocket.nextFrame(), auto frame);
 
-    // receive the packet length
-    GLOBED_UNWRAP(tcpSocket.recvExact(reinterpret_cast<char*>(bb.data().data()), 4));
+    // only read from the socket once everything buffered is used up, a single read often brings in several packets at once
+    if (!frame) {
+        GLOBED_UNWRAP(tcpSocket.fillReadBuffer());
+        GLOBED_UNWRAP_INTO(tcpSocket.nextFrame(), frame);
+    }
 
-    auto packetSize = bb.readU32().value_or(0); // must always be 4 bytes so cant error
-    GLOBED_REQUIRE_SAFE(packetSize < DATA_BUF_SIZE, "packet is too big, rejecting")
+    // the rest of the packet hasn't arrived yet
+    if (!frame) {
+        return Ok(nullptr);
+    }
 
-    GLOBED_UNWRAP(tcpSocket.recvExact(reinterpret_cast<char*>(dataBuffer), packetSize));
+    // decode straight out of the read-ahead buffer, it is not touched again until the packet is fully decoded
+    ByteBuffer buf(frame->data(), frame->size(), ByteBuffer::borrow);
 
-    ByteBuffer buf(dataBuffer, packetSize);
+    return this->decodeOrDefer(buf, SessionBox::Channel::Tcp, true);
+}
 
-    return this->decodePacket(buf);
+bool GameSocket::hasBufferedPacketTCP() {
+    return tcpSocket.hasFrame();
 }
 
 Result<ReceivedPacket> GameSocket::recvPacketUDP() {
@@ -88,23 +96,44 @@ Result<ReceivedPacket> GameSocket::recvPacketUDP() {
         return Err("udp recv failed");
     }
 
-    ByteBuffer buf(dataBuffer, (size_t)recvResult.result);
+    ByteBuffer buf(dataBuffer, (size_t)recvResult.result, ByteBuffer::borrow);
 
-    GLOBED_UNWRAP_INTO(this->decodePacket(buf), out.packet);
+    GLOBED_UNWRAP_INTO(this->decodeOrDefer(buf, SessionBox::Channel::Udp, out.fromConnected), out.packet);
 
     return Ok(std::move(out));
 }
 
+std::optional<CryptoWorker::Output> GameSocket::popDecrypted() {
+    this->checkNetworkThread();
+
+    while (auto out = cryptoWorker.tryPop()) {
+        if (out->session == sessionBox) {
+            return out;
+        }
+    }
+
+    return std::nullopt;
+}
+
 Result<ReceivedPacket> GameSocket::recvPacket(int timeoutMs) {
+    // buffered packets don't make the socket readable, so they would be stuck until more data arrives
+    if (this->hasBufferedPacketTCP()) {
+        GLOBED_UNWRAP_INTO(this->recvPacketTCP(), auto packet);
+        return Ok(ReceivedPacket {
+            .packet = std::move(packet),
+            .fromConnected = true
+        });
+    }
+
     // negative value means poll indefinitely until either tcp or udp receives data
     GLOBED_UNWRAP_INTO(this->poll(timeoutMs), auto pollResult);
 
-    if (pollResult == PollResult::None) {
+    if (!pollResult.tcp && !pollResult.udp) {
         return Err("timed out");
     }
 
-    // prioritize TCP, if the result is Tcp or Both, we care about TCP.
-    if (pollResult != PollResult::Udp) {
+    // prioritize TCP
+    if (pollResult.tcp) {
         GLOBED_UNWRAP_INTO(this->recvPacketTCP(), auto packet);
         return Ok(ReceivedPacket {
             .packet = std::move(packet),
@@ -123,17 +152,34 @@ Result<ReceivedPacket> GameSocket::recvPacket() {
 Result<> GameSocket::sendPacket(std::shared_ptr<Packet> packet) {
     GLOBED_REQUIRE_SAFE(this->isConnected(), "attempting to send a packet while disconnected")
 
-    ByteBuffer buf;
-    GLOBED_UNWRAP(this->encodePacket(*packet, buf))
+    auto buf = sendBuffer.lock();
+    GLOBED_UNWRAP_INTO(this->encodePacket(*packet, *buf), auto payload)
 
     if (dumpPackets) {
-        this->dumpPacket(packet->getPacketId(), buf, true);
+        this->dumpPacket(packet->getPacketId(), *buf, true, payload);
     }
 
+    SendSlice encoded = {reinterpret_cast<const char*>(buf->rawData()), buf->size()};
+    SendSlice trailer = {
+        payload ? reinterpret_cast<const char*>(payload->rawData()) : nullptr,
+        payload ? payload->size() : 0
+    };
+
     if (packet->getUseTcp()) {
-        GLOBED_UNWRAP(tcpSocket.sendAll(reinterpret_cast<const char*>(buf.data().data()), buf.size()));
+        // the length prefix goes out as its own slice, so nothing has to be moved to make room for it
+        uint32_t length = util::data::maybeByteswap<uint32_t>(encoded.size + trailer.size);
+
+        SendSlice slices[] = {
+            {reinterpret_cast<const char*>(&length), sizeof(length)},
+            encoded,
+            trailer,
+        };
+
+        GLOBED_UNWRAP(tcpSocket.sendAll(slices));
     } else {
-        GLOBED_UNWRAP(udpSocket.send(reinterpret_cast<const char*>(buf.data().data()), buf.size()));
+        SendSlice slices[] = {encoded, trailer};
+
+        GLOBED_UNWRAP(udpSocket.send(std::span(slices, payload ? 2 : 1)));
     }
 
     return Ok();
@@ -142,17 +188,22 @@ Result<> GameSocket::sendPacket(std::shared_ptr<Packet> packet) {
 Result<> GameSocket::sendPacketTo(std::shared_ptr<Packet> packet, const NetworkAddress& address) {
     GLOBED_REQUIRE_SAFE(!packet->getUseTcp(), "cannot send a TCP packet to a UDP connection")
 
-    ByteBuffer buf;
-    GLOBED_UNWRAP(this->encodePacket(*packet, buf))
+    auto buf = sendBuffer.lock();
+    GLOBED_UNWRAP_INTO(this->encodePacket(*packet, *buf), auto payload)
+
+    // rarely used, so just make the data contiguous
+    if (payload) {
+        buf->writeValue(*payload);
+    }
 
     if (dumpPackets) {
-        this->dumpPacket(packet->getPacketId(), buf, true);
+        this->dumpPacket(packet->getPacketId(), *buf, true);
     }
 
-    GLOBED_UNWRAP_INTO(udpSocket.sendTo(reinterpret_cast<const char*>(buf.data().data()), buf.size(), address), auto res)
+    GLOBED_UNWRAP_INTO(udpSocket.sendTo(reinterpret_cast<const char*>(buf->rawData()), buf->size(), address), auto res)
 
     GLOBED_REQUIRE_SAFE(
-        res == buf.size(),
+        res == buf->size(),
         "failed to send the entire buffer"
     )
 
@@ -168,11 +219,32 @@ Result<> GameSocket::sendRecoveryData(int accountId, uint32_t secretKey) {
 }
 
 void GameSocket::cleanupBox() {
+    this->checkNetworkThread();
     cryptoBox = std::unique_ptr<CryptoBox>(nullptr);
+    sessionBox = std::shared_ptr<SessionBox>(nullptr);
 }
 
 void GameSocket::createBox() {
+#ifdef GLOBED_DEBUG
+    networkThread = std::this_thread::get_id();
+#endif
+
     cryptoBox = std::make_unique<CryptoBox>();
+    sessionBox = std::shared_ptr<SessionBox>(nullptr);
+}
+
+void GameSocket::createSession(const byte* seed) {
+    this->checkNetworkThread();
+    sessionBox = std::make_shared<SessionBox>(seed);
+}
+
+void GameSocket::checkNetworkThread() {
+#ifdef GLOBED_DEBUG
+    GLOBED_REQUIRE(
+        networkThread == std::thread::id{} || networkThread == std::this_thread::get_id(),
+        "the session must only be used on the network thread"
+    )
+#endif
 }
 
 void GameSocket::togglePacketLogging(bool state) {
@@ -180,84 +252,120 @@ void GameSocket::togglePacketLogging(bool state) {
 }
 
 Result<PollResult> GameSocket::poll(int timeoutMs) {
-    if (!tcpSocket.connected) {
-        GLOBED_UNWRAP_INTO(udpSocket.poll(timeoutMs), auto res);
-        return Ok(res ? PollResult::Udp : PollResult::None);
-    }
+    GLOBED_SOCKET_POLLFD fds[3];
+    size_t fdCount = 0;
+
+    fds[fdCount].fd = wakeupHandle.pollHandle();
+    fds[fdCount++].events = POLLIN;
 
-    GLOBED_SOCKET_POLLFD fds[2];
+    fds[fdCount].fd = udpSocket.socket_;
+    fds[fdCount++].events = POLLIN;
 
-    fds[0].fd = tcpSocket.socket_;
-    fds[0].events = POLLIN;
-    fds[1].fd = udpSocket.socket_;
-    fds[1].events = POLLIN;
+    // only poll the tcp socket if connected, closed sockets are not valid poll targets on windows
+    bool pollTcp = tcpSocket.connected;
+    if (pollTcp) {
+        fds[fdCount].fd = tcpSocket.socket_;
+        fds[fdCount++].events = POLLIN;
+    }
 
-    int result = GLOBED_SOCKET_POLL(fds, 2, timeoutMs);
+    int result = GLOBED_SOCKET_POLL(fds, fdCount, timeoutMs);
 
     if (result == -1) {
         return Err(util::net::lastErrorString());
     }
 
-    bool tcp = fds[0].revents & POLLIN;
-    bool udp = fds[1].revents & POLLIN;
+    PollResult out;
+    out.wakeup = fds[0].revents & POLLIN;
+    out.udp = fds[1].revents & POLLIN;
+    // treat hangups and errors as readable too, so that the following recv notices the closed connection
+    out.tcp = pollTcp && (fds[2].revents & (POLLIN | POLLHUP | POLLERR));
 
-    if (tcp && udp) {
-        return Ok(PollResult::Both);
-    } else if (tcp) {
-        return Ok(PollResult::Tcp);
-    } else if (udp) {
-        return Ok(PollResult::Udp);
-    } else {
-        return Ok(PollResult::None);
+    if (out.wakeup) {
+        wakeupHandle.drain();
     }
+
+    return Ok(out);
+}
+
+void GameSocket::wakeup() {
+    wakeupHandle.wake();
 }
 
-Result<> GameSocket::encodePacket(Packet& packet, ByteBuffer& buffer) {
+Result<const ByteBuffer*> GameSocket::encodePacket(Packet& packet, ByteBuffer& buffer) {
     PacketHeader header = {
         .id = packet.getPacketId(),
-        .encrypted = packet.getEncrypted(),
+        .flags = packet.getEncrypted() ? PacketHeader::FLAG_ENCRYPTED : uint8_t(0),
     };
 
-    bool tcp = packet.getUseTcp();
+    const ByteBuffer* payload = packet.getEncodedPayload();
+
+    // the buffer is reused for every packet, clearing it keeps the allocation around
+    buffer.clear();
+    buffer.reserve(PacketHeader::SIZE + packet.encodedSize() + SessionBox::PREFIX_LEN);
+
+    buffer.writeValue<PacketHeader>(header);
 
-    // reserve space for packet length when using TCP
-    size_t startPos = buffer.getPosition();
+    if (!packet.getEncrypted()) {
+        // already encoded data is sent right after the header, without copying it
+        if (payload) {
+            return Ok(payload);
+        }
 
-    if (tcp) {
-        buffer.writeU32(0);
+        packet.encode(buffer);
+        return Ok(nullptr);
+    }
+
+    this->checkNetworkThread();
+    GLOBED_REQUIRE_SAFE(sessionBox.get() != nullptr, "attempted to encrypt a packet before the handshake was done")
+
+    auto channel = packet.getUseTcp() ? SessionBox::Channel::Tcp : SessionBox::Channel::Udp;
+
+    if (payload) {
+        // encrypt straight out of the packet's own buffer, rather than copying it in and encrypting in place
+        buffer.grow(payload->size() + SessionBox::PREFIX_LEN);
+        GLOBED_UNWRAP(sessionBox->encryptInto(channel, payload->rawData(), buffer.rawData() + PacketHeader::SIZE, payload->size()));
+        return Ok(nullptr);
     }
 
-    buffer.writeValue<PacketHeader>(header);
     packet.encode(buffer);
 
-    if (packet.getEncrypted()) {
-        GLOBED_REQUIRE_SAFE(cryptoBox.get() != nullptr, "attempted to encrypt a packet when no cryptobox is initialized")
+    // grow the vector by SessionBox::PREFIX_LEN extra bytes to do in-place encryption
+    size_t rawSize = buffer.size() - PacketHeader::SIZE;
+    buffer.grow(SessionBox::PREFIX_LEN);
+    GLOBED_UNWRAP(sessionBox->encryptInPlace(channel, buffer.rawData() + PacketHeader::SIZE, rawSize));
 
-        // grow the vector by CryptoBox::PREFIX_LEN extra bytes to do in-place encryption
-        buffer.grow(CryptoBox::PREFIX_LEN);
-        uint32_t headerSize = PacketHeader::SIZE;
-        if (tcp) {
-            headerSize += sizeof(uint32_t);
-        }
+    return Ok(nullptr);
+}
 
-        auto rawSize = buffer.size() - headerSize - startPos - CryptoBox::PREFIX_LEN;
-        cryptoBox->encryptInPlace(buffer.data().data() + startPos + headerSize, rawSize);
-    }
+Result<std::shared_ptr<Packet>> GameSocket::decodeOrDefer(ByteBuffer& buffer, SessionBox::Channel channel, bool fromConnected) {
+    GLOBED_REQUIRE_SAFE(buffer.size() >= PacketHeader::SIZE, "packet is too short to contain a header")
+
+    auto header = buffer.readValue<PacketHeader>().unwrap();
+    buffer.setPosition(0);
 
-    // write length
-    if (tcp) {
-        size_t lastPos = buffer.getPosition();
-        size_t packetSize = buffer.size() - sizeof(uint32_t) - startPos;
+    this->checkNetworkThread();
 
-        buffer.setPosition(startPos);
-        buffer.writeU32(packetSize);
-        buffer.setPosition(lastPos);
+    // tcp packets must stay in order, so while any are being decrypted, the cleartext ones queue up behind them too
+    bool defer = sessionBox && (
+        header.encrypted() || (channel == SessionBox::Channel::Tcp && cryptoWorker.pending(channel) > 0)
+    );
+
+    if (!defer) {
+        return this->decodePacket(buffer, channel, sessionBox.get());
     }
 
-    return Ok();
+    // the receive buffer is reused for the next packet, so the worker gets its own copy
+    cryptoWorker.submit(CryptoWorker::Job {
+        .session = sessionBox,
+        .channel = channel,
+        .data = bytevector(buffer.rawData(), buffer.rawData() + buffer.size()),
+        .fromConnected = fromConnected,
+    });
+
+    return Ok(nullptr);
 }
 
-Result<std::shared_ptr<Packet>> GameSocket::decodePacket(ByteBuffer& buffer) {
+Result<std::shared_ptr<Packet>> GameSocket::decodePacket(ByteBuffer& buffer, SessionBox::Channel channel, SessionBox* session) {
     // read header
     auto header = buffer.readValue<PacketHeader>().unwrap(); // we know that the header must be present by now.
 
@@ -268,15 +376,13 @@ Result<std::shared_ptr<Packet>> GameSocket::decodePacket(ByteBuffer& buffer) {
 
     GLOBED_REQUIRE_SAFE(packet.get() != nullptr, std::string("invalid server-side packet: ") + std::to_string(header.id))
 
-    if (packet->getEncrypted() && !header.encrypted) {
+    if (packet->getEncrypted() && !header.encrypted()) {
         GLOBED_REQUIRE_SAFE(false, "server sent a cleartext packet when expected an encrypted one")
     }
 
-    if (header.encrypted) {
-        GLOBED_REQUIRE_SAFE(cryptoBox.get() != nullptr, "attempted to decrypt a packet when no cryptobox is initialized")
-        bytevector& bufvec = buffer.data();
-
-        GLOBED_UNWRAP_INTO(cryptoBox->decryptInPlace(bufvec.data() + PacketHeader::SIZE, messageLength), messageLength);
+    if (header.encrypted()) {
+        GLOBED_REQUIRE_SAFE(session != nullptr, "attempted to decrypt a packet before the handshake was done")
+        GLOBED_UNWRAP_INTO(session->decryptInPlace(channel, buffer.rawData() + PacketHeader::SIZE, messageLength), messageLength);
         buffer.resize(messageLength + PacketHeader::SIZE);
     }
 
@@ -284,7 +390,17 @@ Result<std::shared_ptr<Packet>> GameSocket::decodePacket(ByteBuffer& buffer) {
         this->dumpPacket(header.id, buffer, false);
     }
 
-    auto result = packet->decode(buffer);
+    // big lists come compressed, they are decoded from a separate buffer that is kept around for the next one.
+    // this runs on both the network thread and the crypto worker, so each of them gets its own
+    std::optional<ByteBuffer> decompressed;
+    if (header.compressed()) {
+        static thread_local bytevector decompressBuffer;
+
+        GLOBED_UNWRAP_INTO(util::compress::decompress(buffer.rawData() + PacketHeader::SIZE, messageLength, decompressBuffer), size_t decompressedLength);
+        decompressed.emplace(decompressBuffer.data(), decompressedLength, ByteBuffer::borrow);
+    }
+
+    auto result = packet->decode(decompressed ? *decompressed : buffer);
     if (result.isErr()) {
         return Err(fmt::format("Decoding packet ID {} failed: {}", header.id, ByteBuffer::strerror(result.unwrapErr())));
     }
@@ -292,7 +408,7 @@ Result<std::shared_ptr<Packet>> GameSocket::decodePacket(ByteBuffer& buffer) {
     return Ok(std::move(packet));
 }
 
-void GameSocket::dumpPacket(packetid_t id, ByteBuffer& buffer, bool sending) {
+void GameSocket::dumpPacket(packetid_t id, const ByteBuffer& buffer, bool sending, const ByteBuffer* payload) {
     log::debug("{} packet {}", sending ? "Sending" : "Receiving", id);
 
     auto folder = Mod::get()->getSaveDir() / "packets";
@@ -306,6 +422,9 @@ void GameSocket::dumpPacket(packetid_t id, ByteBuffer& buffer, bool sending) {
 
     std::ofstream fs(filepath, std::ios::binary);
 
-    const auto& vec = buffer.data();
-    fs.write(reinterpret_cast<const char*>(vec.data()), vec.size());
+    fs.write(reinterpret_cast<const char*>(buffer.rawData()), buffer.size());
+
+    if (payload) {
+        fs.write(reinterpret_cast<const char*>(payload->rawData()), payload->size());
+    }
 }
\ No newline at end of file
@@ -1,11 +1,17 @@
 #pragma once
 
 #include "address.hpp"
+#include "crypto_worker.hpp"
 #include "udp_socket.hpp"
 #include "tcp_socket.hpp"
+#include "wakeup_handle.hpp"
 
 #include <data/packets/packet.hpp>
 #include <crypto/box.hpp>
+#include <crypto/session_box.hpp>
+#include <asp/sync.hpp>
+
+#include <thread>
 
 class GameSocket {
     static constexpr uint8_t MARKER_CONN_INITIAL = 0xe0;
@@ -24,13 +30,21 @@ public:
         bool fromConnected;
     };
 
-    // Try to receive a packet on the TCP socket
+    // Try to receive a packet on the TCP socket. Only reads from the socket if no complete packet is buffered already.
+    // Returns nullptr if the packet was handed off to the crypto worker, or if it wasn't fully received yet.
     Result<std::shared_ptr<Packet>> recvPacketTCP();
 
-    // Try to receive a packet on the UDP socket
+    // Whether a complete TCP packet is already buffered, so that `recvPacketTCP` can return it without reading from the socket.
+    // The socket won't be polled as readable for these, so they must be drained after every read.
+    bool hasBufferedPacketTCP();
+
+    // Try to receive a packet on the UDP socket. The packet is nullptr if it was handed off to the crypto worker.
     Result<ReceivedPacket> recvPacketUDP();
 
-    // Try to receive a packet
+    // Collect a packet that was decrypted by the crypto worker. Packets from a previous session are skipped.
+    std::optional<CryptoWorker::Output> popDecrypted();
+
+    // Try to receive a packet, see `recvPacketTCP` and `recvPacketUDP`
     Result<ReceivedPacket> recvPacket();
 
     // Try to receive a packet, returns "timed out" if timeout is reached.
@@ -44,33 +58,72 @@ public:
 
     Result<> sendRecoveryData(int accountId, uint32_t secretKey);
 
+    // These three must only be called on the network thread, `sessionBox` is read there without any locking.
     void cleanupBox();
     void createBox();
+    // Switch to the session cipher, `seed` is the decrypted seed from the handshake response.
+    void createSession(const util::data::byte* seed);
 
     void togglePacketLogging(bool enabled);
 
-    enum class PollResult {
-        None, Tcp, Udp, Both
+    struct PollResult {
+        bool tcp = false;
+        bool udp = false;
+        bool wakeup = false;
+
+        bool any() const {
+            return tcp || udp || wakeup;
+        }
     };
 
+    // Wait until either socket has data, or until `wakeup` is called. Negative timeout means wait indefinitely.
     Result<PollResult> poll(int timeoutMs);
 
+    // Interrupt an ongoing (or the next) `poll` call. Thread safe.
+    void wakeup();
+
 private:
     friend class NetworkManager;
+    friend class CryptoWorker;
 
     TcpSocket tcpSocket;
     UdpSocket udpSocket;
+    WakeupHandle wakeupHandle;
 
+    // only used for the handshake, encrypted packets go through `sessionBox`
     std::unique_ptr<CryptoBox> cryptoBox;
+    // shared with in-flight crypto worker jobs, which may outlive it after a reconnect.
+    // Owned by the network thread: only replaced there, and only read there when decoding, encrypting and collecting decrypted packets.
+    // Other threads may only send unencrypted packets (i.e. `DisconnectPacket`), those never touch it.
+    std::shared_ptr<SessionBox> sessionBox;
     util::data::byte* dataBuffer;
+    // outgoing packets are encoded here, reused to avoid allocating for every packet
+    asp::Mutex<ByteBuffer> sendBuffer;
 
     bool dumpPackets = false;
 
-    // Write a packet, packet header, and optionally length if the packet is TCP to the given buffer.
-    Result<> encodePacket(Packet& packet, ByteBuffer& buffer);
+#ifdef GLOBED_DEBUG
+    // the thread that called `createBox`, the session must not be touched from any other one
+    std::thread::id networkThread;
+#endif
+
+    // Throws in debug builds if called on a different thread than `createBox` was
+    void checkNetworkThread();
+
+    // must be the last member, so that the worker thread is stopped before anything it uses is destroyed
+    CryptoWorker cryptoWorker;
+
+    // Clear the buffer, then write the packet header and the (optionally encrypted) packet into it.
+    // The TCP length prefix is not written. For unencrypted packets with an encoded payload (see `Packet::getEncodedPayload`),
+    // only the header is written and the payload is returned, it must be sent right after the buffer. Otherwise returns nullptr.
+    Result<const ByteBuffer*> encodePacket(Packet& packet, ByteBuffer& buffer);
+
+    // Decode a packet from a buffer, `channel` is the socket it was received on. Thread safe, as long as `session` is only
+    // used for decryption by one thread at a time.
+    Result<std::shared_ptr<Packet>> decodePacket(ByteBuffer& buffer, SessionBox::Channel channel, SessionBox* session);
 
-    // Decode a packet from a buffer
-    Result<std::shared_ptr<Packet>> decodePacket(ByteBuffer& buffer);
+    // Decode the packet right away, or hand it off to the crypto worker if it's encrypted. Returns nullptr in the latter case.
+    Result<std::shared_ptr<Packet>> decodeOrDefer(ByteBuffer& buffer, SessionBox::Channel channel, bool fromConnected);
 
-    void dumpPacket(packetid_t id, ByteBuffer& buffer, bool sending);
+    void dumpPacket(packetid_t id, const ByteBuffer& buffer, bool sending, const ByteBuffer* payload = nullptr);
 };
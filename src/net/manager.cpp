@@ -1,7 +1,12 @@
 #include "manager.hpp"
 
 #include "address.hpp"
+#include "clock_sync.hpp"
+#include "delta_sync.hpp"
+#include "dispatch_table.hpp"
 #include "listener.hpp"
+#include "pending_packets.hpp"
+#include "player_counts.hpp"
 #include "game_socket.hpp"
 
 #include <Geode/ui/GeodeUI.hpp>
@@ -21,17 +26,22 @@
 #include <managers/role.hpp>
 #include <util/cocos.hpp>
 #include <util/format.hpp>
+#include <util/lockfree.hpp>
 #include <util/time.hpp>
 #include <util/net.hpp>
+#include <util/debug.hpp>
 #include <ui/notification/panel.hpp>
 
 using namespace asp;
 using namespace geode::prelude;
 using ConnectionState = NetworkManager::ConnectionState;
 
-static constexpr uint16_t MIN_PROTOCOL_VERSION = 11;
-static constexpr uint16_t MAX_PROTOCOL_VERSION = 11;
-static constexpr std::array SUPPORTED_PROTOCOLS = std::to_array<uint16_t>({11});
+static constexpr uint16_t MIN_PROTOCOL_VERSION = 18;
+static constexpr uint16_t MAX_PROTOCOL_VERSION = 18;
+static constexpr std::array SUPPORTED_PROTOCOLS = std::to_array<uint16_t>({18});
+
+static constexpr auto CLOCK_SYNC_INITIAL_INTERVAL = util::time::seconds(1);
+static constexpr auto CLOCK_SYNC_INTERVAL = util::time::seconds(10);
 
 static bool isProtocolSupported(uint16_t proto) {
 #ifdef GLOBED_DEBUG
@@ -59,27 +69,14 @@ static std::string formatListenerKey(packetid_t id) {
     return util::cocos::spr(fmt::format("packet-listener-{}", id));
 }
 
-struct WeakRefDummy {
-    std::shared_ptr<WeakRefController> ctrl;
-};
-
-template <typename T>
-static void* addrFromWeakRef(const WeakRef<T>& ref) {
-    // Do not do this.
-    auto dummy = reinterpret_cast<const WeakRefDummy&>(ref);
-    return dummy.ctrl ? dummy.ctrl->get() : nullptr;
-}
-
-template <typename T>
-static const WeakRefController& controllerFromWeakRef(const WeakRef<T>& ref) {
-    // Do not do this.
-    auto dummy = reinterpret_cast<const WeakRefDummy&>(ref);
-    return *dummy.ctrl;
-}
-
 // Packet listener pool. Most of the functions must not be used on a different thread than main.
 class PacketListenerPool : public CCObject {
 public:
+    // how long delivering packets may take in a single frame, the rest is left for the next frame
+    static constexpr auto DELIVERY_BUDGET = util::time::micros(2000);
+    // how many received packets can wait for the main thread, a couple of seconds worth of a busy level
+    static constexpr size_t QUEUE_CAPACITY = 4096;
+
     PacketListenerPool(const PacketListenerPool&) = delete;
     PacketListenerPool(PacketListenerPool&&) = delete;
     PacketListenerPool& operator=(const PacketListenerPool&) = delete;
@@ -101,57 +98,25 @@ public:
 
             // clear the queue
             while (auto t = packetQueue.tryPop());
+            pending.clear();
 
             return;
         }
 
-        if (packetQueue.empty()) return;
-
-        // clear any dead listeners
-        this->removeDeadListeners();
-
-        while (auto packet_ = packetQueue.tryPop()) {
-            auto& packet = packet_.value();
-            packetid_t id = packet->getPacketId();
-
-            bool invoked = false;
-            auto& lsm = listeners[id];
-
-            // reorder them based on priority
-            std::sort(lsm.begin(), lsm.end(), [](auto& l1, auto& l2) -> bool {
-                auto r1 = l1.lock();
-                auto r2 = l2.lock();
-
-                if (!r1) return false;
-                if (!r2) return true;
-
-                return r1->priority < r2->priority;
-            });
-
-            for (auto& listener : lsm) {
-                if (auto l = listener.lock()) {
-                    l->invokeCallback(packet);
-
-                    if (l->isFinal) {
-                        break;
-                    }
-                }
-            }
+        while (auto packet = packetQueue.tryPop()) {
+            pending.push(std::move(packet.value()));
         }
-    }
 
-    void removeDeadListeners() {
-        for (auto& [id, listeners] : listeners) {
-            for (int i = listeners.size() - 1; i >= 0; i--) {
-                auto addr = addrFromWeakRef(listeners[i]);
+        // always deliver at least one packet, so that a slow listener can't stall the queue forever
+        auto start = util::time::now();
+        bool first = true;
 
-                if (!listeners[i].valid()) {
-#ifdef GLOBED_DEBUG
-                    log::debug("Unregistering listener {} (id {})", addr, id);
-#endif
-                    listeners.erase(listeners.begin() + i);
-                }
-            }
+        while (first || util::time::now() - start < DELIVERY_BUDGET) {
+            auto packet = pending.pop();
+            if (!packet) break;
+
+            first = false;
+            dispatchTable.dispatch(packet);
         }
     }
 
@@ -160,34 +125,28 @@ public:
         log::debug("Registering listener {} (id {}) for {}", listener, id, listener->owner);
 #endif
 
-        auto& ls = listeners[id];
-
-        this->removeDeadListeners();
-
-        // verify it's not a duplicate
-        bool duped = false;
-        for (auto& l : ls) {
-            if (l.lock() == listener) {
-                duped = true;
-                break;
-            }
-        }
-
-        if (!duped) {
-            ls.push_back(WeakRef(listener));
-        } else {
-            log::warn("duped listener ({}, id {}, owner {}), not adding again", listener, id, listener->owner);
-        }
+        dispatchTable.registerListener(id, listener);
     }
 
-    // Push a packet to the queue. Thread safe.
+    // Push a packet to the queue. Must only be called from the network thread.
     void pushPacket(std::shared_ptr<Packet> packet) {
-        packetQueue.push(std::move(packet));
+        // only happens if the main thread has been stuck for a long while, at which point the packets are outdated anyway
+        if (!packetQueue.tryPush(std::move(packet))) {
+            size_t dropped = droppedPackets.fetch_add(1, std::memory_order_relaxed);
+            if (dropped % 256 == 0) {
+                log::warn("main thread packet queue is full, dropped {} packets so far", dropped + 1);
+            }
+        }
     }
 
 private:
-    std::unordered_map<packetid_t, std::vector<WeakRef<PacketListener>>> listeners;
-    asp::Channel<std::shared_ptr<Packet>> packetQueue;
+    PacketDispatchTable dispatchTable;
+    // network thread -> main thread
+    util::lockfree::SpscQueue<std::shared_ptr<Packet>, QUEUE_CAPACITY> packetQueue;
+    std::atomic<size_t> droppedPackets = 0;
+
+    // packets waiting to be delivered on the main thread
+    PendingPacketQueue pending;
 
     PacketListenerPool() {
         CCScheduler::get()->scheduleSelector(schedule_selector(PacketListenerPool::update), this, 0.f, false);
@@ -201,9 +160,19 @@ protected:
 
     static constexpr int BUILTIN_LISTENER_PRIORITY = 10000000;
 
+    // how long the network thread sleeps when there is no socket activity and no queued tasks.
+    // only affects how often timeouts and keepalives are checked, queued tasks wake the thread up immediately.
+    static constexpr int IDLE_POLL_TIMEOUT_MS = 250;
+
+    // how many tasks can be queued up for the network thread, only fills up if it's stuck connecting for a long time
+    static constexpr size_t TASK_QUEUE_CAPACITY = 1024;
+
     struct TaskPingServers {};
     struct TaskSendPacket {
         std::shared_ptr<Packet> packet;
+#ifdef GLOBED_DEBUG_NET_LATENCY
+        util::time::time_point enqueuedAt = util::time::now();
+#endif
     };
     struct TaskPingActive {};
 
@@ -214,15 +183,20 @@ protected:
     };
 
     using Task = std::variant<TaskPingServers, TaskSendPacket, TaskPingActive>;
+    using ListenerMap = std::unordered_map<packetid_t, GlobalListener>;
 
     AtomicConnectionState state;
     GameSocket socket;
-    asp::Thread<NetworkManager::Impl*> threadRecv, threadMain;
-    asp::Channel<Task> taskQueue;
-
-    // Note that we intentionally don't use Ref here,
-    // as we use the destructor to know if the object owning the listener has been destroyed.
-    asp::Mutex<std::unordered_map<packetid_t, GlobalListener>> listeners;
+    asp::Thread<NetworkManager::Impl*> threadMain;
+    // main thread, audio thread, network thread -> network thread
+    util::lockfree::MpscQueue<Task, TASK_QUEUE_CAPACITY> taskQueue;
+    std::atomic<size_t> droppedTasks = 0;
+
+    // Internal listeners, read by the network thread for every received packet without locking.
+    // Writers copy the current map, modify the copy and swap it in. Replaced maps are kept alive until destruction,
+    // since the network thread may still be reading them (listeners are only ever added during startup, so there's few of them).
+    std::atomic<const ListenerMap*> listeners;
+    asp::Mutex<std::vector<std::unique_ptr<const ListenerMap>>> listenerSnapshots;
     asp::Mutex<std::unordered_map<packetid_t, util::time::system_time_point>> suppressed;
 
     // these fields are only used by us and in a safe manner, so they don't need a mutex
@@ -231,6 +205,9 @@ protected:
     util::time::time_point lastReceivedPacket;
     util::time::time_point lastSentKeepalive;
     util::time::time_point lastTcpExchange;
+    PlayerDeltaSync deltaSync;
+    // main thread only
+    PlayerCountSubscriptions playerCounts;
 
     AtomicBool suspended;
     AtomicBool standalone;
@@ -244,20 +221,22 @@ protected:
     AtomicU32 serverTps;
     AtomicU16 serverProtocol;
 
+#ifdef GLOBED_DEBUG_NET_LATENCY
+    util::debug::LatencyRecorder sendLatency{"send latency"};
+#endif
+
     Impl() {
         // initialize winsock
         util::net::initialize();
 
-        this->setupGlobalListeners();
+        this->replaceListeners([](ListenerMap&) {});
 
-        // start up the threads
+        this->setupGlobalListeners();
 
-        threadRecv.setLoopFunction(&NetworkManager::Impl::threadRecvFunc);
-        threadRecv.setStartFunction([] { geode::utils::thread::setName("Network Thread (in)"); });
-        threadRecv.start(this);
+        // start up the network thread
 
         threadMain.setLoopFunction(&NetworkManager::Impl::threadMainFunc);
-        threadMain.setStartFunction([] { geode::utils::thread::setName("Network Thread (out)"); });
+        threadMain.setStartFunction([] { geode::utils::thread::setName("Network Thread"); });
         threadMain.start(this);
 
         this->resetConnectionState();
@@ -267,8 +246,8 @@ protected:
         // remove all listeners
         this->removeAllListeners();
 
-        log::debug("waiting for network threads to terminate..");
-        threadRecv.stopAndWait();
+        log::debug("waiting for the network thread to terminate..");
+        socket.wakeup();
         threadMain.stopAndWait();
 
         if (state != ConnectionState::Disconnected) {
@@ -299,6 +278,7 @@ protected:
         lastReceivedPacket = {};
         lastSentKeepalive = {};
         lastTcpExchange = {};
+        ClockSync::get().reset();
     }
 
     /* connection and tasks */
@@ -374,18 +354,29 @@ protected:
         ErrorQueues::get().debugWarn(reason);
     }
 
+    void pushTask(Task&& task) {
+        if (!taskQueue.tryPush(std::move(task))) {
+            size_t dropped = droppedTasks.fetch_add(1, std::memory_order_relaxed);
+            if (dropped % 256 == 0) {
+                log::warn("network task queue is full, dropped {} tasks so far", dropped + 1);
+            }
+        }
+
+        socket.wakeup();
+    }
+
     void send(std::shared_ptr<Packet> packet) {
-        taskQueue.push(TaskSendPacket {
+        this->pushTask(TaskSendPacket {
             .packet = std::move(packet)
         });
     }
 
     void pingServers() {
-        taskQueue.push(TaskPingServers {});
+        this->pushTask(TaskPingServers {});
     }
 
     void updateServerPing() {
-        taskQueue.push(TaskPingActive {});
+        this->pushTask(TaskPingActive {});
     }
 
     ConnectionState getConnectionState() {
@@ -430,7 +421,21 @@ protected:
     }
 
     void removeAllListeners() {
-        listeners.lock()->clear();
+        this->replaceListeners([](ListenerMap& map) {
+            map.clear();
+        });
+    }
+
+    // Copy the internal listener map, let `modify` change the copy and publish it.
+    template <typename F>
+    void replaceListeners(F&& modify) {
+        auto snapshots = listenerSnapshots.lock();
+
+        auto map = std::make_unique<ListenerMap>(snapshots->empty() ? ListenerMap{} : *snapshots->back());
+        modify(*map);
+
+        listeners.store(map.get(), std::memory_order_release);
+        snapshots->push_back(std::move(map));
     }
 
     // adds a global listener, with same fairness as all other listeners
@@ -454,7 +459,9 @@ protected:
             .callback = std::move(callback),
         };
 
-        (*listeners.lock())[id] = std::move(listener);
+        this->replaceListeners([&](ListenerMap& map) {
+            map[id] = std::move(listener);
+        });
 #ifdef GLOBED_DEBUG
         log::debug("Registered internal listener (id = {})", id);
 #endif
@@ -482,12 +489,14 @@ protected:
     void setupGlobalListeners() {
         // Connection packets
 
-        addInternalListenerSync<CryptoHandshakeResponsePacket>([this](auto packet) {
+        // runs on the network thread, which is the only one that touches the session
+        addInternalListener<CryptoHandshakeResponsePacket>([this](auto packet) {
             this->onCryptoHandshakeResponse(std::move(packet));
         });
 
         addInternalListener<KeepaliveResponsePacket>([](auto packet) {
             GameServerManager::get().finishKeepalive(packet->playerCount);
+            ClockSync::get().addSample(packet->clientTime, packet->serverTime);
         });
 
         addInternalListener<KeepaliveTCPResponsePacket>([](auto) {});
@@ -572,6 +581,10 @@ protected:
             pcm.setOwnSpecialData(packet->specialUserData);
         });
 
+        addGlobalListener<LevelPlayerCountPacket>([this](auto packet) {
+            playerCounts.onCountsReceived(packet->levels);
+        });
+
         // Room packets
 
         addGlobalListener<RoomInvitePacket>([](auto packet) {
@@ -645,6 +658,23 @@ protected:
         auto key = packet->data.key;
 
         socket.cryptoBox->setPeerKey(key.data());
+
+        auto seed = socket.cryptoBox->decrypt(packet->sessionSeed.data(), packet->sessionSeed.size());
+        if (!seed || seed.unwrap().size() != SessionBox::SEED_LEN) {
+            log::warn("failed to decrypt the session seed: {}", seed ? "invalid size" : seed.unwrapErr());
+            this->disconnectWithMessage("handshake failed, invalid session seed");
+            return;
+        }
+
+        socket.createSession(seed.unwrap().data());
+
+        // the profile and settings are only safe to use on the main thread
+        Loader::get()->queueInMainThread([this] {
+            this->sendLogin();
+        });
+    }
+
+    void sendLogin() {
         auto& am = GlobedAccountManager::get();
         std::string authtoken;
 
@@ -691,6 +721,7 @@ protected:
         serverTps = packet->tps;
         secretKey = packet->secretKey;
         serverProtocol = packet->serverProtocol;
+        deltaSync.resetConnection();
 
         state = ConnectionState::Established;
 
@@ -708,12 +739,15 @@ protected:
         flm.maybeLoad();
 
         // these are not thread-safe, so delay it
-        Loader::get()->queueInMainThread([specialUserData = std::move(packet->specialUserData), allRoles = std::move(packet->allRoles)] {
+        Loader::get()->queueInMainThread([this, specialUserData = std::move(packet->specialUserData), allRoles = std::move(packet->allRoles)] {
             auto& pcm = ProfileCacheManager::get();
             pcm.setOwnSpecialData(specialUserData);
 
             RoomManager::get().setGlobal();
             RoleManager::get().setAllRoles(allRoles);
+
+            // resubscribe to whatever is on screen
+            playerCounts.resetConnection();
         });
 
         // claim the tcp thread to allow udp packets through
@@ -803,29 +837,73 @@ protected:
         suspended = false;
     }
 
-    /* worker threads */
+    /* worker thread */
 
-    void threadRecvFunc(decltype(threadRecv)::StopToken&) {
-        if (this->suspended || state == ConnectionState::TcpConnecting) {
+    // The network thread is a single reactor loop: it waits on the TCP socket, the UDP socket and a wakeup handle at once.
+    // Any thread that queues a task (i.e. `send`) signals the wakeup handle, so queued packets go out immediately,
+    // and the thread sleeps for as long as there's nothing to do. See tools/net_latency for a comparison with the old two thread design.
+    void threadMainFunc(decltype(threadMain)::StopToken&) {
+        if (this->suspended) {
             std::this_thread::sleep_for(util::time::millis(100));
             return;
         }
 
-        auto packet_ = socket.recvPacket(100);
-        if (packet_.isErr()) {
-            auto error = std::move(packet_.unwrapErr());
-            if (error != "timed out") {
-                this->onConnectionError(error);
-            }
+        if (!this->updateConnectionState()) {
+            return;
+        }
 
+        if (this->established()) {
+            this->maybeSendKeepalive();
+        }
+
+        // send out everything that has been queued since the last iteration
+        this->processQueuedTasks();
+
+        // wait until we either receive data or get woken up
+        auto pollResult_ = socket.poll(IDLE_POLL_TIMEOUT_MS);
+        if (pollResult_.isErr()) {
+            this->onConnectionError(pollResult_.unwrapErr());
+            std::this_thread::sleep_for(util::time::millis(IDLE_POLL_TIMEOUT_MS));
             return;
         }
 
-        // this is awesome
-        auto packet__ = packet_.unwrap();
-        auto packet = std::move(packet__.packet);
-        bool fromServer = packet__.fromConnected;
+        auto pollResult = pollResult_.unwrap();
+
+        // prioritize TCP
+        // one read can bring in many packets (e.g. player lists after connecting), handle all of them before polling again
+        if (pollResult.tcp) {
+            do {
+                auto packet = socket.recvPacketTCP();
+                if (packet.isErr()) {
+                    this->onConnectionError(packet.unwrapErr());
+                } else if (packet.unwrap()) {
+                    this->handleReceivedPacket(std::move(packet.unwrap()), true);
+                }
+            } while (socket.hasBufferedPacketTCP());
+        }
+
+        if (pollResult.udp) {
+            auto packet = socket.recvPacketUDP();
+            if (packet.isErr()) {
+                this->onConnectionError(packet.unwrapErr());
+            } else if (packet.unwrap().packet) {
+                auto received = std::move(packet.unwrap());
+                this->handleReceivedPacket(std::move(received.packet), received.fromConnected);
+            }
+        }
 
+        // encrypted packets come back from the crypto worker, which wakes us up whenever it finishes one
+        while (auto decrypted = socket.popDecrypted()) {
+            if (!decrypted->packet) {
+                this->onConnectionError(decrypted->error);
+                continue;
+            }
+
+            this->handleReceivedPacket(std::move(decrypted->packet), decrypted->fromConnected);
+        }
+    }
+
+    void handleReceivedPacket(std::shared_ptr<Packet>&& packet, bool fromServer) {
         packetid_t id = packet->getPacketId();
 
         if (id == PingResponsePacket::PACKET_ID) {
@@ -840,6 +918,11 @@ protected:
 
         lastReceivedPacket = util::time::now();
 
+        // listeners only ever see full player data
+        if (auto* delta = packet->tryDowncast<LevelDataDeltaPacket>()) {
+            packet = deltaSync.decode(*delta);
+        }
+
         this->callListener(std::move(packet));
     }
 
@@ -847,15 +930,14 @@ protected:
         packetid_t packetId = packet->getPacketId();
 
         // go through internal listeners
-        auto ls = listeners.lock();
-        if (ls->contains(packetId)) {
-            auto listener = ls->at(packetId);
+        const auto* ls = listeners.load(std::memory_order_acquire);
+        auto it = ls->find(packetId);
+        if (it != ls->end()) {
+            const auto& listener = it->second;
             listener.callback(packet);
             if (listener.isFinal) return;
         }
 
-        ls.unlock();
-
         // call other listeners
         PacketListenerPool::get().pushPacket(std::move(packet));
     }
@@ -866,12 +948,23 @@ protected:
         }
     }
 
-    void threadMainFunc(decltype(threadMain)::StopToken&) {
-        if (this->suspended) {
-            std::this_thread::sleep_for(util::time::millis(100));
-            return;
+    void processQueuedTasks() {
+        while (auto task_ = taskQueue.tryPop()) {
+            auto task = std::move(task_.value());
+
+            if (std::holds_alternative<TaskPingServers>(task)) {
+                this->handlePingTask();
+            } else if (std::holds_alternative<TaskSendPacket>(task)) {
+                this->handleSendPacketTask(std::move(std::get<TaskSendPacket>(task)));
+            } else if (std::holds_alternative<TaskPingActive>(task)) {
+                this->handlePingActive();
+            }
         }
+    }
 
+    // Handles connecting, connection recovery and detecting connection losses.
+    // Returns false if the rest of the loop iteration should be skipped.
+    bool updateConnectionState() {
         // Initial tcp connection.
         if (state == ConnectionState::TcpConnecting && !recovering) {
             // try to connect
@@ -884,7 +977,7 @@ protected:
                 log::warn("TCP connection failed: <cy>{}</c>", reason);
 
                 ErrorQueues::get().error(fmt::format("Failed to connect to the server.\n\nReason: <cy>{}</c>", reason));
-                return;
+                return false;
             } else {
                 log::debug("tcp connection successful, sending the handshake");
                 state = ConnectionState::Authenticating;
@@ -922,7 +1015,7 @@ protected:
                     failed = true;
                 } else {
                     // the rest is done in a global listener
-                    return;
+                    return false;
                 }
             }
 
@@ -933,7 +1026,7 @@ protected:
                 if (attemptNumber > 3) {
                     // give up
                     this->failedRecovery();
-                    return;
+                    return false;
                 }
 
                 auto sleepPeriod = util::time::millis(10000) * attemptNumber;
@@ -951,11 +1044,11 @@ protected:
                         recovering = false;
                         recoverAttempt = 0;
                         state = ConnectionState::Disconnected;
-                        return;
+                        return false;
                     }
                 }
 
-                return;
+                return false;
             }
         }
         // Detect if the tcp socket has unexpectedly disconnected and start recovering the connection
@@ -966,7 +1059,7 @@ protected:
             recovering = true;
             cancellingRecovery = false;
             recoverAttempt = 0;
-            return;
+            return false;
         }
         // Detect if we disconnected while authenticating, likely the server doesn't expect us
         else if (state == ConnectionState::Authenticating && !socket.isConnected()) {
@@ -976,7 +1069,7 @@ protected:
                 "Failed to connect to the server.\n\nReason: <cy>server abruptly disconnected during the {}</c>",
                 handshakeDone ? "login attempt" : "handshake"
             ));
-            return;
+            return false;
         }
         // Detect if authentication is taking too long
         else if (state == ConnectionState::Authenticating && !recovering && (util::time::now() - lastReceivedPacket) > util::time::seconds(5)) {
@@ -986,28 +1079,10 @@ protected:
                 "Failed to connect to the server.\n\nReason: <cy>server took too long to respond to the {}</c>",
                 handshakeDone ? "login attempt" : "handshake"
             ));
-            return;
+            return false;
         }
 
-        if (this->established()) {
-            this->maybeSendKeepalive();
-        }
-
-        // poll for any incoming packets
-
-        while (auto task_ = taskQueue.popTimeout(util::time::millis(50))) {
-            auto task = task_.value();
-
-            if (std::holds_alternative<TaskPingServers>(task)) {
-                this->handlePingTask();
-            } else if (std::holds_alternative<TaskSendPacket>(task)) {
-                this->handleSendPacketTask(std::move(std::get<TaskSendPacket>(task)));
-            } else if (std::holds_alternative<TaskPingActive>(task)) {
-                this->handlePingActive();
-            }
-        }
-
-        std::this_thread::yield();
+        return true;
     }
 
     void maybeSendKeepalive() {
@@ -1025,6 +1100,9 @@ protected:
             socket.disconnect();
         } else if (sinceLastPacket > util::time::seconds(10) && sinceLastKeepalive > util::time::seconds(3)) {
             this->sendKeepalive();
+        } else if (sinceLastKeepalive > (ClockSync::get().isSynced() ? CLOCK_SYNC_INTERVAL : CLOCK_SYNC_INITIAL_INTERVAL)) {
+            // keepalives are also clock samples, collect a few quickly after connecting and then keep the estimate fresh
+            this->sendKeepalive();
         }
 
         // send a tcp keepalive to keep the nat hole open
@@ -1035,7 +1113,7 @@ protected:
 
     void sendKeepalive() {
         // send a keepalive
-        this->send(KeepalivePacket::create());
+        this->send(KeepalivePacket::create(ClockSync::localMicros()));
         lastSentKeepalive = util::time::now();
         GameServerManager::get().startKeepalive();
     }
@@ -1073,6 +1151,15 @@ protected:
     }
 
     void handleSendPacketTask(TaskSendPacket task) {
+        packetid_t id = task.packet->getPacketId();
+
+        if (id == LevelJoinPacket::PACKET_ID || id == LevelLeavePacket::PACKET_ID) {
+            deltaSync.reset();
+        } else if (id == PlayerDataPacket::PACKET_ID) {
+            // every supported protocol uses delta encoded player data
+            task.packet = deltaSync.encode(static_cast<const PlayerDataPacket&>(*task.packet));
+        }
+
         if (task.packet->getUseTcp()) {
             lastTcpExchange = util::time::now();
         }
@@ -1085,6 +1172,10 @@ protected:
                 this->onConnectionError(error);
                 return;
             }
+
+#ifdef GLOBED_DEBUG_NET_LATENCY
+            sendLatency.record(util::time::as<util::time::micros>(util::time::now() - task.enqueuedAt));
+#endif
         } catch (const std::exception& e) {
             this->onConnectionError(e.what());
         }
@@ -1251,13 +1342,21 @@ void NetworkManager::unregisterPacketListener(packetid_t packet, PacketListener*
 
 MAKE_SENDER2(UpdatePlayerStatus, (const UserPrivacyFlags& flags), (flags))
 MAKE_SENDER2(RequestRoomPlayerList, (), ())
+MAKE_SENDER2(RequestRoomPlayerListDelta, (uint32_t version), (version))
+MAKE_SENDER2(RequestLevelListDelta, (uint32_t version), (version))
 MAKE_SENDER2(LeaveRoom, (), ())
 MAKE_SENDER2(CloseRoom, (), ())
 
-void NetworkManager::sendRequestPlayerCount(LevelId id) {
-    impl->send(RequestPlayerCountPacket::create(std::vector({id})));
+/* player counts */
+
+void NetworkManager::subscribePlayerCounts(cocos2d::CCNode* target, std::vector<LevelId> levelIds, std::function<void()>&& callback) {
+    impl->playerCounts.subscribe(target, std::move(levelIds), std::move(callback));
+}
+
+void NetworkManager::unsubscribePlayerCounts(cocos2d::CCNode* target) {
+    impl->playerCounts.unsubscribe(target);
 }
 
-void NetworkManager::sendRequestPlayerCount(std::vector<LevelId> ids) {
-    impl->send(RequestPlayerCountPacket::create(std::move(ids)));
+std::optional<uint16_t> NetworkManager::getPlayerCount(LevelId levelId) {
+    return impl->playerCounts.getCount(levelId);
 }
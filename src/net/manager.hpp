@@ -131,10 +131,19 @@ public:
     // Packet sending
     void sendUpdatePlayerStatus(const UserPrivacyFlags& flags);
     void sendRequestRoomPlayerList();
+    void sendRequestRoomPlayerListDelta(uint32_t version);
+    void sendRequestLevelListDelta(uint32_t version);
     void sendLeaveRoom();
     void sendCloseRoom();
-    void sendRequestPlayerCount(LevelId id);
-    void sendRequestPlayerCount(std::vector<LevelId> ids);
+
+    // Player count subscriptions, main thread only
+
+    // Subscribe `target` to the player counts on these levels, replacing its previous subscription. The server pushes counts
+    // as they change, and `callback` is called when any of these levels got a new count. Ends when `target` is destroyed.
+    void subscribePlayerCounts(cocos2d::CCNode* target, std::vector<LevelId> levelIds, std::function<void()>&& callback);
+    void unsubscribePlayerCounts(cocos2d::CCNode* target);
+    // Last known player count on the level, shared between all subscribers
+    std::optional<uint16_t> getPlayerCount(LevelId levelId);
 
 private:
     class Impl;
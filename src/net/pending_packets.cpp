@@ -0,0 +1,47 @@
+#include "pending_packets.hpp"
+
+void PendingPacketQueue::push(std::shared_ptr<Packet> packet) {
+    if (packet->getLatestWins()) {
+        auto& queued = latestWins[packet->getPacketId()];
+
+        if (queued.size() + 1 >= COALESCE_THRESHOLD) {
+            // newest first, so that the newer entry of a player wins
+            for (auto it = queued.rbegin(); it != queued.rend(); it++) {
+                auto& older = packets[*it - popped];
+                packet->mergeDropped(*older);
+                older.reset();
+            }
+
+            queued.clear();
+        }
+
+        queued.push_back(popped + packets.size());
+    }
+
+    packets.push_back(std::move(packet));
+}
+
+std::shared_ptr<Packet> PendingPacketQueue::pop() {
+    while (!packets.empty()) {
+        auto packet = std::move(packets.front());
+        packets.pop_front();
+        popped++;
+
+        // dropped in favor of a newer packet
+        if (!packet) continue;
+
+        if (packet->getLatestWins()) {
+            auto& queued = latestWins[packet->getPacketId()];
+            queued.erase(queued.begin());
+        }
+
+        return packet;
+    }
+
+    return nullptr;
+}
+
+void PendingPacketQueue::clear() {
+    packets.clear();
+    latestWins.clear();
+}
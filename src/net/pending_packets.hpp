@@ -0,0 +1,38 @@
+#pragma once
+
+#include <deque>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include <data/packets/packet.hpp>
+
+/*
+* PendingPacketQueue - received packets waiting to be delivered on the main thread.
+*
+* Packets come out in the order they were pushed. Latest-wins packets (see `Packet::getLatestWins`) are normally delivered as they are,
+* because the server splits a single tick across several of them and the interpolator wants every tick, even if a few arrive at once.
+* Only once `COALESCE_THRESHOLD` of them are queued up, which means the main thread has stalled for a while, they are collapsed into the newest one
+* with `Packet::mergeDropped`. The older ones are left in the queue as nullptr, so the sequence numbers of the rest stay valid.
+*
+* Not thread safe.
+*/
+class PendingPacketQueue {
+public:
+    // around half a second of level data at the default tickrate
+    static constexpr size_t COALESCE_THRESHOLD = 32;
+
+    void push(std::shared_ptr<Packet> packet);
+
+    // Pops the next packet, or returns nullptr if there are none left
+    std::shared_ptr<Packet> pop();
+
+    void clear();
+
+private:
+    std::deque<std::shared_ptr<Packet>> packets;
+    // how many packets were ever popped, so that sequence numbers can be turned into indices
+    size_t popped = 0;
+    // packet ID -> sequence numbers of the queued latest-wins packets with that ID, oldest first
+    std::unordered_map<packetid_t, std::vector<size_t>> latestWins;
+};
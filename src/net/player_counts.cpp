@@ -0,0 +1,127 @@
+#include "player_counts.hpp"
+
+#include <data/packets/client/general.hpp>
+#include <net/manager.hpp>
+
+using namespace geode::prelude;
+
+static constexpr auto SUBSCRIPTION_KEY = "player-count-subscription"_spr;
+
+PlayerCountSubscription::~PlayerCountSubscription() {
+    if (owner) {
+        owner->remove(this);
+    }
+}
+
+void PlayerCountSubscriptions::subscribe(CCNode* target, std::vector<LevelId> levelIds, std::function<void()>&& callback) {
+    auto subscription = new PlayerCountSubscription;
+    subscription->autorelease();
+    subscription->levelIds = std::move(levelIds);
+    subscription->callback = std::move(callback);
+    subscription->owner = this;
+
+    subscriptions.push_back(subscription);
+
+    // releases the previous subscription of this node, if there was one
+    target->setUserObject(SUBSCRIPTION_KEY, subscription);
+
+    this->queueUpdate();
+}
+
+void PlayerCountSubscriptions::unsubscribe(CCNode* target) {
+    target->setUserObject(SUBSCRIPTION_KEY, nullptr);
+}
+
+std::optional<uint16_t> PlayerCountSubscriptions::getCount(LevelId levelId) {
+    auto it = counts.find(levelId);
+    if (it == counts.end()) return std::nullopt;
+
+    return it->second;
+}
+
+void PlayerCountSubscriptions::onCountsReceived(const std::vector<std::pair<LevelId, uint16_t>>& levels) {
+    std::unordered_set<LevelId> changed;
+
+    for (const auto& [levelId, count] : levels) {
+        counts[levelId] = count;
+        changed.insert(levelId);
+    }
+
+    // callbacks may add or remove subscriptions, so don't iterate the vector itself
+    std::vector<PlayerCountSubscription*> toNotify;
+
+    for (auto* subscription : subscriptions) {
+        bool affected = std::any_of(subscription->levelIds.begin(), subscription->levelIds.end(), [&](LevelId id) {
+            return changed.contains(id);
+        });
+
+        if (affected) {
+            toNotify.push_back(subscription);
+        }
+    }
+
+    for (auto* subscription : toNotify) {
+        // skip the ones that were removed (and possibly destroyed along with their node) by an earlier callback
+        if (std::find(subscriptions.begin(), subscriptions.end(), subscription) == subscriptions.end()) continue;
+
+        if (subscription->callback) {
+            subscription->callback();
+        }
+    }
+
+    this->pruneCache();
+}
+
+void PlayerCountSubscriptions::resetConnection() {
+    sentLevelIds.clear();
+    this->queueUpdate();
+}
+
+void PlayerCountSubscriptions::remove(PlayerCountSubscription* subscription) {
+    std::erase(subscriptions, subscription);
+    subscription->owner = nullptr;
+
+    this->queueUpdate();
+}
+
+void PlayerCountSubscriptions::queueUpdate() {
+    if (updateQueued) return;
+    updateQueued = true;
+
+    Loader::get()->queueInMainThread([this] {
+        updateQueued = false;
+        this->sendUpdate();
+    });
+}
+
+void PlayerCountSubscriptions::sendUpdate() {
+    std::vector<LevelId> levelIds;
+
+    for (auto* subscription : subscriptions) {
+        levelIds.insert(levelIds.end(), subscription->levelIds.begin(), subscription->levelIds.end());
+    }
+
+    std::sort(levelIds.begin(), levelIds.end());
+    levelIds.erase(std::unique(levelIds.begin(), levelIds.end()), levelIds.end());
+
+    if (levelIds.size() > MAX_LEVELS) {
+        log::warn("subscribed to player counts on {} levels, only the first {} will be updated", levelIds.size(), MAX_LEVELS);
+        levelIds.resize(MAX_LEVELS);
+    }
+
+    if (levelIds == sentLevelIds) return;
+
+    auto& nm = NetworkManager::get();
+    if (!nm.established()) return;
+
+    sentLevelIds = levelIds;
+    nm.send(SubscribePlayerCountsPacket::create(std::move(levelIds)));
+}
+
+void PlayerCountSubscriptions::pruneCache() {
+    if (counts.size() <= MAX_CACHED) return;
+
+    std::erase_if(counts, [this](const auto& entry) {
+        return !std::binary_search(sentLevelIds.begin(), sentLevelIds.end(), entry.first);
+    });
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <defs/geode.hpp>
+
+class PlayerCountSubscriptions;
+
+// Keeps a node subscribed for as long as it's alive, stored as a user object of the node.
+class PlayerCountSubscription : public cocos2d::CCObject {
+public:
+    ~PlayerCountSubscription();
+
+    std::vector<LevelId> levelIds;
+    std::function<void()> callback;
+
+private:
+    friend class PlayerCountSubscriptions;
+    PlayerCountSubscriptions* owner = nullptr;
+};
+
+/*
+* PlayerCountSubscriptions - player counts of the levels currently shown on screen (protocol v18 and newer).
+*
+* Instead of every layer polling `RequestPlayerCountPacket` on its own timer, layers subscribe to the levels they show.
+* The union of all subscriptions is sent in a `SubscribePlayerCountsPacket` whenever it changes, and the server
+* pushes a `LevelPlayerCountPacket` with only the counts that changed.
+* Counts stay cached after a layer goes away, so reopening it shows them right away until the server sends fresh ones.
+*
+* Not thread safe, must only be used from the main thread.
+*/
+class PlayerCountSubscriptions {
+public:
+    // must match the server
+    static constexpr size_t MAX_LEVELS = 256;
+    // counts of levels nobody is subscribed to are dropped once the cache grows past this
+    static constexpr size_t MAX_CACHED = 1024;
+
+    // Subscribe `target` to these levels, replacing its previous subscription
+    void subscribe(cocos2d::CCNode* target, std::vector<LevelId> levelIds, std::function<void()>&& callback);
+    void unsubscribe(cocos2d::CCNode* target);
+
+    std::optional<uint16_t> getCount(LevelId levelId);
+
+    // Store the pushed counts and notify the subscribers of the changed levels
+    void onCountsReceived(const std::vector<std::pair<LevelId, uint16_t>>& levels);
+
+    // The server starts out with no subscriptions, called when connecting to a server
+    void resetConnection();
+
+private:
+    friend class PlayerCountSubscription;
+
+    // not owning, subscriptions remove themselves when destroyed
+    std::vector<PlayerCountSubscription*> subscriptions;
+    std::unordered_map<LevelId, uint16_t> counts;
+    // sorted, what the server currently thinks we are subscribed to
+    std::vector<LevelId> sentLevelIds;
+    bool updateQueued = false;
+
+    void remove(PlayerCountSubscription* subscription);
+
+    // Send the new set of levels to the server, deferred to the next frame so that layers being swapped only cause one packet
+    void queueUpdate();
+    void sendUpdate();
+    void pruneCache();
+};
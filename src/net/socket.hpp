@@ -8,6 +8,12 @@ struct RecvResult {
     int result;
 };
 
+// One of the buffers passed to a vectored (scatter-gather) send, which sends all of them as if they were contiguous
+struct SendSlice {
+    const char* data;
+    size_t size;
+};
+
 class Socket {
 public:
     virtual Result<> connect(const NetworkAddress& address) = 0;
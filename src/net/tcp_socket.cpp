@@ -6,6 +6,8 @@
 #ifdef GEODE_IS_WINDOWS
 # include <WinSock2.h>
 #else
+# include <sys/socket.h>
+# include <sys/uio.h>
 # include <netinet/in.h>
 # include <fcntl.h>
 # include <poll.h>
@@ -14,9 +16,33 @@
 
 using namespace geode::prelude;
 
+#ifdef GEODE_IS_WINDOWS
+static size_t sliceLength(const WSABUF& buf) {
+    return buf.len;
+}
+
+static void advanceSlice(WSABUF& buf, size_t bytes) {
+    buf.buf += bytes;
+    buf.len -= bytes;
+}
+#else
+static size_t sliceLength(const iovec& buf) {
+    return buf.iov_len;
+}
+
+static void advanceSlice(iovec& buf, size_t bytes) {
+    buf.iov_base = static_cast<char*>(buf.iov_base) + bytes;
+    buf.iov_len -= bytes;
+}
+#endif
+
+using util::data::byte;
+
 TcpSocket::TcpSocket() : socket_(0) {
     destAddr_ = std::make_unique<sockaddr_in>();
     std::memset(destAddr_.get(), 0, sizeof(sockaddr_in));
+
+    readBuffer = std::make_unique<byte[]>(READ_BUFFER_SIZE);
 }
 
 TcpSocket::~TcpSocket() {
@@ -28,6 +54,10 @@ Result<> TcpSocket::connect(const NetworkAddress& address) {
 
     GLOBED_UNWRAP_INTO(address.resolve(), *destAddr_)
 
+    // anything left over belongs to the previous connection
+    readStart = 0;
+    readEnd = 0;
+
     // create socket
     int sock = socket(AF_INET, SOCK_STREAM, 0);
     socket_ = sock;
@@ -80,6 +110,64 @@ Result<> TcpSocket::sendAll(const char* data, unsigned int dataSize) {
     return Ok();
 }
 
+Result<> TcpSocket::sendAll(std::span<const SendSlice> slices) {
+    GLOBED_REQUIRE_SAFE(slices.size() <= MAX_SEND_SLICES, "too many slices passed to TcpSocket::sendAll")
+
+#ifdef GEODE_IS_WINDOWS
+    WSABUF bufs[MAX_SEND_SLICES];
+#else
+    iovec bufs[MAX_SEND_SLICES];
+#endif
+
+    size_t count = 0;
+    for (const auto& slice : slices) {
+        if (slice.size == 0) continue;
+
+#ifdef GEODE_IS_WINDOWS
+        bufs[count].buf = const_cast<char*>(slice.data);
+        bufs[count].len = static_cast<ULONG>(slice.size);
+#else
+        bufs[count].iov_base = const_cast<char*>(slice.data);
+        bufs[count].iov_len = slice.size;
+#endif
+        count++;
+    }
+
+    size_t first = 0;
+    while (first < count) {
+#ifdef GEODE_IS_WINDOWS
+        DWORD sent = 0;
+        if (::WSASend(socket_, bufs + first, count - first, &sent, 0, nullptr, nullptr) == SOCKET_ERROR) {
+            this->maybeDisconnect();
+            return Err(util::net::lastErrorString());
+        }
+#else
+        msghdr msg = {};
+        msg.msg_iov = bufs + first;
+        msg.msg_iovlen = count - first;
+
+        auto sent = ::sendmsg(socket_, &msg, MSG_NOSIGNAL);
+        if (sent == -1) {
+            this->maybeDisconnect();
+            return Err(util::net::lastErrorString());
+        }
+#endif
+
+        // on a partial send, skip the slices that were fully sent and advance into the next one
+        size_t remaining = sent;
+        while (first < count && remaining >= sliceLength(bufs[first])) {
+            remaining -= sliceLength(bufs[first]);
+            first++;
+        }
+
+        if (first < count && remaining > 0) {
+            advanceSlice(bufs[first], remaining);
+        }
+    }
+
+    return Ok();
+}
+
 void TcpSocket::disconnect() {
     this->close();
 }
@@ -105,21 +193,74 @@ RecvResult TcpSocket::receive(char* buffer, int bufferSize) {
     };
 }
 
-Result<> TcpSocket::recvExact(char* buffer, int bufferSize) {
-    GLOBED_REQUIRE_SAFE(connected, "attempting to call TcpSocket::recvExact on a disconnected socket")
+Result<> TcpSocket::fillReadBuffer() {
+    GLOBED_REQUIRE_SAFE(connected, "attempting to call TcpSocket::fillReadBuffer on a disconnected socket")
 
-    unsigned int received = 0;
+    // move the partially received frame to the front, so that it can be handed out in one piece once it's complete
+    if (readStart != 0) {
+        std::memmove(readBuffer.get(), readBuffer.get() + readStart, readEnd - readStart);
+        readEnd -= readStart;
+        readStart = 0;
+    }
 
-    do {
-        int result = this->receive(buffer + received, bufferSize - received).result;
-        if (result < 0) return Err(util::net::lastErrorString());
-        if (result == 0) return Err("connection was closed by the server");
-        received += result;
-    } while (received < bufferSize);
+    // can't happen, the buffer only fills up if there's a complete frame in it, which has to be taken out first
+    GLOBED_REQUIRE_SAFE(readEnd < READ_BUFFER_SIZE, "tcp read buffer is full")
+
+    int result = this->receive(reinterpret_cast<char*>(readBuffer.get() + readEnd), READ_BUFFER_SIZE - readEnd).result;
+    if (result < 0) return Err(util::net::lastErrorString());
+    if (result == 0) return Err("connection was closed by the server");
+
+    readEnd += result;
 
     return Ok();
 }
 
+Result<std::optional<std::span<byte>>> TcpSocket::nextFrame() {
+    // whatever is still buffered after a disconnect is useless
+    size_t frameLength = connected ? this->peekFrameLength() : 0;
+    if (frameLength == 0) {
+        return Ok(std::nullopt);
+    }
+
+    size_t length = frameLength - FRAME_HEADER_SIZE;
+    if (length >= MAX_FRAME_SIZE) {
+        // there's no way to find where the next frame starts without reading this one
+        this->disconnect();
+        return Err("packet is too big, rejecting");
+    }
+
+    if (readEnd - readStart < frameLength) {
+        return Ok(std::nullopt);
+    }
+
+    std::span<byte> frame(readBuffer.get() + readStart + FRAME_HEADER_SIZE, length);
+    readStart += frameLength;
+
+    // nothing left, start from the front again without having to move anything
+    if (readStart == readEnd) {
+        readStart = 0;
+        readEnd = 0;
+    }
+
+    return Ok(std::make_optional(frame));
+}
+
+bool TcpSocket::hasFrame() const {
+    size_t length = connected ? this->peekFrameLength() : 0;
+    return length != 0 && readEnd - readStart >= length;
+}
+
+size_t TcpSocket::peekFrameLength() const {
+    if (readEnd - readStart < FRAME_HEADER_SIZE) {
+        return 0;
+    }
+
+    uint32_t length;
+    std::memcpy(&length, readBuffer.get() + readStart, FRAME_HEADER_SIZE);
+
+    return FRAME_HEADER_SIZE + util::data::maybeByteswap(length);
+}
+
 bool TcpSocket::close() {
     connected = false;
 
@@ -3,12 +3,23 @@
 
 #include <defs/platform.hpp>
 #include <defs/assert.hpp>
+#include <util/data.hpp>
 #include <asp/sync.hpp>
+#include <optional>
+#include <span>
 
 struct sockaddr_in;
 
 class TcpSocket : public Socket {
 public:
+    // the most slices that can be passed to a vectored `sendAll`
+    static constexpr size_t MAX_SEND_SLICES = 8;
+    // frames are prefixed with their length as a big endian u32, and must be smaller than this
+    static constexpr size_t MAX_FRAME_SIZE = 2 << 18;
+    static constexpr size_t FRAME_HEADER_SIZE = sizeof(uint32_t);
+    // big enough to always fit the biggest frame, so that every frame can be handed out as one contiguous view
+    static constexpr size_t READ_BUFFER_SIZE = MAX_FRAME_SIZE + FRAME_HEADER_SIZE;
+
     using Socket::send;
     TcpSocket();
     ~TcpSocket();
@@ -16,8 +27,20 @@ public:
     Result<> connect(const NetworkAddress& address) override;
     Result<int> send(const char* data, unsigned int dataSize) override;
     Result<> sendAll(const char* data, unsigned int dataSize);
+    // Send all the slices in order with as few syscalls as possible, without copying them into one buffer first
+    Result<> sendAll(std::span<const SendSlice> slices);
     RecvResult receive(char* buffer, int bufferSize) override;
-    Result<> recvExact(char* buffer, int bufferSize);
+
+    // Read as much as is available into the read-ahead buffer with a single `recv`. Blocks if nothing is available,
+    // so only call this after `poll` said the socket is readable, and `nextFrame` returned nothing.
+    Result<> fillReadBuffer();
+
+    // Take the next complete frame out of the read-ahead buffer, without the length prefix. Never reads from the socket.
+    // The view stays valid until the next `fillReadBuffer` or `connect` call.
+    Result<std::optional<std::span<util::data::byte>>> nextFrame();
+
+    // Whether the read-ahead buffer holds at least one complete frame
+    bool hasFrame() const;
 
     bool close() override;
     virtual void disconnect();
@@ -35,5 +58,13 @@ public:
 private:
     std::unique_ptr<sockaddr_in> destAddr_;
 
+    // read-ahead buffer, bytes in [readStart, readEnd) are received but not consumed yet
+    std::unique_ptr<util::data::byte[]> readBuffer;
+    size_t readStart = 0;
+    size_t readEnd = 0;
+
+    // length of the frame at the front of the read-ahead buffer, including the prefix. 0 if the prefix isn't fully received yet
+    size_t peekFrameLength() const;
+
     void maybeDisconnect();
 };
@@ -8,6 +8,7 @@
 # include <Ws2tcpip.h>
 #else
 # include <sys/socket.h>
+# include <sys/uio.h>
 # include <netinet/in.h>
 # include <unistd.h>
 # include <poll.h>
@@ -48,6 +49,51 @@ Result<int> UdpSocket::send(const char* data, unsigned int dataSize) {
     return Ok(retval);
 }
 
+Result<int> UdpSocket::send(std::span<const SendSlice> slices) {
+    GLOBED_REQUIRE_SAFE(connected, "attempting to call UdpSocket::send on a disconnected socket")
+    GLOBED_REQUIRE_SAFE(slices.size() <= MAX_SEND_SLICES, "too many slices passed to UdpSocket::send")
+
+#ifdef GEODE_IS_WINDOWS
+    WSABUF bufs[MAX_SEND_SLICES];
+    for (size_t i = 0; i < slices.size(); i++) {
+        bufs[i].buf = const_cast<char*>(slices[i].data);
+        bufs[i].len = static_cast<ULONG>(slices[i].size);
+    }
+
+    DWORD sent = 0;
+    int result = ::WSASendTo(
+        socket_, bufs, slices.size(), &sent, 0,
+        reinterpret_cast<struct sockaddr*>(destAddr_.get()), sizeof(sockaddr_in), nullptr, nullptr
+    );
+
+    if (result == SOCKET_ERROR) {
+        return Err(util::net::lastErrorString());
+    }
+
+    return Ok(static_cast<int>(sent));
+#else
+    iovec bufs[MAX_SEND_SLICES];
+    for (size_t i = 0; i < slices.size(); i++) {
+        bufs[i].iov_base = const_cast<char*>(slices[i].data);
+        bufs[i].iov_len = slices[i].size;
+    }
+
+    msghdr msg = {};
+    msg.msg_name = destAddr_.get();
+    msg.msg_namelen = sizeof(sockaddr_in);
+    msg.msg_iov = bufs;
+    msg.msg_iovlen = slices.size();
+
+    auto retval = ::sendmsg(socket_, &msg, 0);
+
+    if (retval == -1) {
+        return Err(util::net::lastErrorString());
+    }
+
+    return Ok(static_cast<int>(retval));
+#endif
+}
+
 Result<int> UdpSocket::sendTo(const char* data, unsigned int dataSize, const NetworkAddress& address) {
     // stinky windows returns wsa error 10014 if sockaddr is a stack pointer
     std::unique_ptr<sockaddr_in> addr = std::make_unique<sockaddr_in>();
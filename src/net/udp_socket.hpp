@@ -3,17 +3,23 @@
 
 #include <defs/platform.hpp>
 #include <asp/sync.hpp>
+#include <span>
 
 struct sockaddr_in;
 
 class UdpSocket : public Socket {
 public:
+    // the most slices that can be passed to a vectored `send`
+    static constexpr size_t MAX_SEND_SLICES = 8;
+
     using Socket::send;
     UdpSocket();
     ~UdpSocket();
 
     Result<> connect(const NetworkAddress& address) override;
     Result<int> send(const char* data, unsigned int dataSize) override;
+    // Send all the slices as a single datagram, without copying them into one buffer first
+    Result<int> send(std::span<const SendSlice> slices);
     Result<int> sendTo(const char* data, unsigned int dataSize, const NetworkAddress& address);
     RecvResult receive(char* buffer, int bufferSize) override;
     bool close() override;
@@ -0,0 +1,128 @@
+#include "wakeup_handle.hpp"
+
+#include <defs/assert.hpp>
+#include <util/net.hpp>
+
+#ifdef GEODE_IS_WINDOWS
+# include <WinSock2.h>
+# include <Ws2tcpip.h>
+#else
+# include <fcntl.h>
+# include <unistd.h>
+# ifdef GEODE_IS_ANDROID
+#  include <sys/eventfd.h>
+# endif
+#endif
+
+#ifdef GEODE_IS_WINDOWS
+
+WakeupHandle::WakeupHandle() {
+    SOCKET sock = ::socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    GLOBED_REQUIRE(sock != INVALID_SOCKET, "failed to create wakeup socket: " + util::net::lastErrorString());
+
+    sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = 0;
+
+    int addrLen = sizeof(addr);
+
+    // bind to a random loopback port and connect the socket to itself, so that `send` delivers to our own receive queue
+    bool ok = ::bind(sock, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == 0
+        && ::getsockname(sock, reinterpret_cast<sockaddr*>(&addr), &addrLen) == 0
+        && ::connect(sock, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == 0;
+
+    unsigned long nonBlocking = 1;
+    ok = ok && ioctlsocket(sock, FIONBIO, &nonBlocking) == 0;
+
+    if (!ok) {
+        auto err = util::net::lastErrorString();
+        ::closesocket(sock);
+        GLOBED_REQUIRE(false, "failed to set up wakeup socket: " + err);
+    }
+
+    readHandle = sock;
+    writeHandle = sock;
+}
+
+WakeupHandle::~WakeupHandle() {
+    ::closesocket(readHandle);
+}
+
+void WakeupHandle::wake() {
+    if (pending.exchange(true)) return;
+
+    char byte = 0;
+    ::send(writeHandle, &byte, 1, 0);
+}
+
+void WakeupHandle::drain() {
+    char buf[64];
+    while (::recv(readHandle, buf, sizeof(buf), 0) > 0) {}
+
+    // clear the flag only after reading, a `wake` that races with us either sees the flag still set
+    // (and its work gets picked up by the caller after draining), or writes a new byte that the next poll will see.
+    pending = false;
+}
+
+#else // GEODE_IS_WINDOWS
+
+WakeupHandle::WakeupHandle() {
+# ifdef GEODE_IS_ANDROID
+    int fd = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    GLOBED_REQUIRE(fd != -1, "failed to create wakeup eventfd: " + util::net::lastErrorString());
+
+    readHandle = fd;
+    writeHandle = fd;
+# else
+    int fds[2];
+    GLOBED_REQUIRE(::pipe(fds) == 0, "failed to create wakeup pipe: " + util::net::lastErrorString());
+
+    for (int fd : fds) {
+        ::fcntl(fd, F_SETFL, ::fcntl(fd, F_GETFL) | O_NONBLOCK);
+        ::fcntl(fd, F_SETFD, FD_CLOEXEC);
+    }
+
+    readHandle = fds[0];
+    writeHandle = fds[1];
+# endif
+}
+
+WakeupHandle::~WakeupHandle() {
+    ::close(readHandle);
+
+    if (writeHandle != readHandle) {
+        ::close(writeHandle);
+    }
+}
+
+void WakeupHandle::wake() {
+    if (pending.exchange(true)) return;
+
+# ifdef GEODE_IS_ANDROID
+    uint64_t value = 1;
+    (void) ::write(writeHandle, &value, sizeof(value));
+# else
+    char byte = 0;
+    (void) ::write(writeHandle, &byte, 1);
+# endif
+}
+
+void WakeupHandle::drain() {
+# ifdef GEODE_IS_ANDROID
+    uint64_t value;
+    (void) ::read(readHandle, &value, sizeof(value));
+# else
+    char buf[64];
+    while (::read(readHandle, buf, sizeof(buf)) > 0) {}
+# endif
+
+    // see the comment in the windows implementation
+    pending = false;
+}
+
+#endif // GEODE_IS_WINDOWS
+
+WakeupHandle::handle_t WakeupHandle::pollHandle() const {
+    return readHandle;
+}
@@ -0,0 +1,43 @@
+#pragma once
+#include <defs/minimal_geode.hpp>
+#include <defs/platform.hpp>
+
+#include <atomic>
+
+/*
+* WakeupHandle - a pollable handle that can be signaled from any thread.
+*
+* It is polled together with the game sockets so that the network thread can sleep until
+* either a socket has data or another thread has queued up work for it (i.e. a packet to send).
+*
+* Android uses an eventfd, Mac and iOS use a non-blocking pipe.
+* On Windows, WSAPoll only accepts sockets (not event objects), so a loopback UDP socket connected to itself is used instead.
+*/
+class WakeupHandle {
+public:
+#ifdef GLOBED_IS_UNIX
+    using handle_t = int;
+#else
+    using handle_t = size_t; // SOCKET
+#endif
+
+    WakeupHandle();
+    ~WakeupHandle();
+
+    WakeupHandle(const WakeupHandle&) = delete;
+    WakeupHandle& operator=(const WakeupHandle&) = delete;
+
+    // Signal the handle, waking up the thread that is polling it. Thread safe. Multiple wakeups before a `drain` are coalesced into one.
+    void wake();
+
+    // Consume all pending wakeups. Must be called by the polling thread after the handle was reported as readable.
+    void drain();
+
+    // Returns the handle that should be passed to `poll`
+    handle_t pollHandle() const;
+
+private:
+    handle_t readHandle;
+    handle_t writeHandle;
+    std::atomic_bool pending = false;
+};
@@ -32,4 +32,51 @@ float globed::simd::arm::pcmVolume(const float* pcm, std::size_t samples) {
 #endif
 }
 
+void globed::simd::arm::lerpTransforms(const util::simd::TransformLanes& lanes) {
+#ifdef GLOBED_ARM64
+    size_t alignedCount = lanes.count / 4 * 4;
+
+    const float32x4_t spiderThreshold = vdupq_n_f32(33.f);
+
+    for (size_t i = 0; i < alignedCount; i += 4) {
+        float32x4_t ratio = vld1q_f32(lanes.ratio + i);
+
+        float32x4_t ox = vld1q_f32(lanes.olderX + i);
+        float32x4_t nx = vld1q_f32(lanes.newerX + i);
+        vst1q_f32(lanes.outX + i, vfmaq_f32(ox, vsubq_f32(nx, ox), ratio));
+
+        float32x4_t oy = vld1q_f32(lanes.olderY + i);
+        float32x4_t dy = vsubq_f32(vld1q_f32(lanes.newerY + i), oy);
+        float32x4_t lerpedY = vfmaq_f32(oy, dy, ratio);
+
+        uint32x4_t isSpider = vmvnq_u32(vceqzq_f32(vld1q_f32(lanes.spider + i)));
+        uint32x4_t keepY = vandq_u32(isSpider, vcageq_f32(dy, spiderThreshold));
+        vst1q_f32(lanes.outY + i, vbslq_f32(keepY, oy, lerpedY));
+
+        float32x4_t orot = vld1q_f32(lanes.olderRotation + i);
+        float32x4_t nrot = vld1q_f32(lanes.newerRotation + i);
+        vst1q_f32(lanes.outRotation + i, vfmaq_f32(orot, vsubq_f32(nrot, orot), ratio));
+    }
+
+    if (alignedCount < lanes.count) {
+        util::misc::lerpTransformsSlow(util::simd::TransformLanes {
+            .olderX = lanes.olderX + alignedCount,
+            .olderY = lanes.olderY + alignedCount,
+            .olderRotation = lanes.olderRotation + alignedCount,
+            .newerX = lanes.newerX + alignedCount,
+            .newerY = lanes.newerY + alignedCount,
+            .newerRotation = lanes.newerRotation + alignedCount,
+            .ratio = lanes.ratio + alignedCount,
+            .spider = lanes.spider + alignedCount,
+            .outX = lanes.outX + alignedCount,
+            .outY = lanes.outY + alignedCount,
+            .outRotation = lanes.outRotation + alignedCount,
+            .count = lanes.count - alignedCount,
+        });
+    }
+#else
+    util::misc::lerpTransformsSlow(lanes);
+#endif
+}
+
 #endif
\ No newline at end of file
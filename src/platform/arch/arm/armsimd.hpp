@@ -5,9 +5,12 @@
 #ifdef GLOBED_ARM
 
 #include <cstddef>
+#include <util/simd.hpp>
 
 namespace globed::simd::arm {
     float pcmVolume(const float* pcm, std::size_t samples);
+
+    void lerpTransforms(const util::simd::TransformLanes& lanes);
 }
 
 #endif
\ No newline at end of file
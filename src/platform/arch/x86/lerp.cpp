@@ -0,0 +1,97 @@
+#include "x86simd.hpp"
+
+#ifdef GLOBED_X86
+
+#include <util/misc.hpp>
+
+using util::simd::TransformLanes;
+
+// the lanes starting at `start`, for finishing off the elements that don't fill a whole vector
+static TransformLanes laneTail(const TransformLanes& lanes, size_t start) {
+    return TransformLanes {
+        .olderX = lanes.olderX + start,
+        .olderY = lanes.olderY + start,
+        .olderRotation = lanes.olderRotation + start,
+        .newerX = lanes.newerX + start,
+        .newerY = lanes.newerY + start,
+        .newerRotation = lanes.newerRotation + start,
+        .ratio = lanes.ratio + start,
+        .spider = lanes.spider + start,
+        .outX = lanes.outX + start,
+        .outY = lanes.outY + start,
+        .outRotation = lanes.outRotation + start,
+        .count = lanes.count - start,
+    };
+}
+
+namespace globed::simd::x86 {
+    void lerpTransformsSSE(const TransformLanes& lanes) {
+        size_t alignedCount = lanes.count / 4 * 4;
+
+        const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+        const __m128 spiderThreshold = _mm_set1_ps(33.f);
+        const __m128 zero = _mm_setzero_ps();
+
+        for (size_t i = 0; i < alignedCount; i += 4) {
+            __m128 ratio = _mm_loadu_ps(lanes.ratio + i);
+
+            __m128 ox = _mm_loadu_ps(lanes.olderX + i);
+            __m128 nx = _mm_loadu_ps(lanes.newerX + i);
+            _mm_storeu_ps(lanes.outX + i, _mm_add_ps(ox, _mm_mul_ps(_mm_sub_ps(nx, ox), ratio)));
+
+            __m128 oy = _mm_loadu_ps(lanes.olderY + i);
+            __m128 dy = _mm_sub_ps(_mm_loadu_ps(lanes.newerY + i), oy);
+            __m128 lerpedY = _mm_add_ps(oy, _mm_mul_ps(dy, ratio));
+
+            __m128 keepY = _mm_and_ps(
+                _mm_cmpneq_ps(_mm_loadu_ps(lanes.spider + i), zero),
+                _mm_cmpge_ps(_mm_and_ps(dy, absMask), spiderThreshold)
+            );
+            _mm_storeu_ps(lanes.outY + i, _mm_or_ps(_mm_and_ps(keepY, oy), _mm_andnot_ps(keepY, lerpedY)));
+
+            __m128 orot = _mm_loadu_ps(lanes.olderRotation + i);
+            __m128 nrot = _mm_loadu_ps(lanes.newerRotation + i);
+            _mm_storeu_ps(lanes.outRotation + i, _mm_add_ps(orot, _mm_mul_ps(_mm_sub_ps(nrot, orot), ratio)));
+        }
+
+        if (alignedCount < lanes.count) {
+            util::misc::lerpTransformsSlow(laneTail(lanes, alignedCount));
+        }
+    }
+
+    void GLOBED_FEATURE_AVX2 lerpTransformsAVX2(const TransformLanes& lanes) {
+        size_t alignedCount = lanes.count / 8 * 8;
+
+        const __m256 absMask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7fffffff));
+        const __m256 spiderThreshold = _mm256_set1_ps(33.f);
+        const __m256 zero = _mm256_setzero_ps();
+
+        for (size_t i = 0; i < alignedCount; i += 8) {
+            __m256 ratio = _mm256_loadu_ps(lanes.ratio + i);
+
+            __m256 ox = _mm256_loadu_ps(lanes.olderX + i);
+            __m256 nx = _mm256_loadu_ps(lanes.newerX + i);
+            _mm256_storeu_ps(lanes.outX + i, _mm256_add_ps(ox, _mm256_mul_ps(_mm256_sub_ps(nx, ox), ratio)));
+
+            __m256 oy = _mm256_loadu_ps(lanes.olderY + i);
+            __m256 dy = _mm256_sub_ps(_mm256_loadu_ps(lanes.newerY + i), oy);
+            __m256 lerpedY = _mm256_add_ps(oy, _mm256_mul_ps(dy, ratio));
+
+            __m256 keepY = _mm256_and_ps(
+                _mm256_cmp_ps(_mm256_loadu_ps(lanes.spider + i), zero, _CMP_NEQ_OQ),
+                _mm256_cmp_ps(_mm256_and_ps(dy, absMask), spiderThreshold, _CMP_GE_OQ)
+            );
+            _mm256_storeu_ps(lanes.outY + i, _mm256_blendv_ps(lerpedY, oy, keepY));
+
+            __m256 orot = _mm256_loadu_ps(lanes.olderRotation + i);
+            __m256 nrot = _mm256_loadu_ps(lanes.newerRotation + i);
+            _mm256_storeu_ps(lanes.outRotation + i, _mm256_add_ps(orot, _mm256_mul_ps(_mm256_sub_ps(nrot, orot), ratio)));
+        }
+
+        if (alignedCount < lanes.count) {
+            lerpTransformsSSE(laneTail(lanes, alignedCount));
+        }
+    }
+}
+
+#endif
@@ -38,6 +38,16 @@ namespace globed::simd::x86 {
             return pcmVolumeSSE(pcm, samples);
         }
     }
+
+    void lerpTransforms(const util::simd::TransformLanes& lanes) {
+        const auto& features = asp::simd::getFeatures();
+
+        if (features.avx2) {
+            lerpTransformsAVX2(lanes);
+        } else {
+            lerpTransformsSSE(lanes);
+        }
+    }
 }
 
 #endif
\ No newline at end of file
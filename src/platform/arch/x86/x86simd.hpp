@@ -2,6 +2,7 @@
 
 #include <platform/basic.hpp>
 #include <asp/simd.hpp>
+#include <util/simd.hpp>
 
 #ifdef GLOBED_X86
 
@@ -38,6 +39,9 @@ namespace globed::simd::x86 {
     // Calculate the volume of pcm samples, picking the fastest possible implementation.
     float pcmVolume(const float* pcm, size_t samples);
 
+    // Lerp transforms (see `util::simd::lerpTransforms`), picking the fastest possible implementation.
+    void lerpTransforms(const util::simd::TransformLanes& lanes);
+
 
     /* Functions written with a specific algorithm */
 
@@ -45,6 +49,9 @@ namespace globed::simd::x86 {
     float pcmVolumeSSE(const float* pcm, size_t samples);
     float GLOBED_FEATURE_AVX2 pcmVolumeAVX2(const float* pcm, size_t samples);
     float GLOBED_FEATURE_AVX512DQ pcmVolumeAVX512(const float* pcm, size_t samples);
+
+    void lerpTransformsSSE(const util::simd::TransformLanes& lanes);
+    void GLOBED_FEATURE_AVX2 lerpTransformsAVX2(const util::simd::TransformLanes& lanes);
 }
 
 #endif
\ No newline at end of file
@@ -5,3 +5,7 @@
 float util::simd::calcPcmVolume(const float* pcm, size_t samples) {
     return globed::simd::arm::pcmVolume(pcm, samples);
 }
+
+void util::simd::lerpTransforms(const util::simd::TransformLanes& lanes) {
+    globed::simd::arm::lerpTransforms(lanes);
+}
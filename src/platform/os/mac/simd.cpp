@@ -16,3 +16,11 @@ float util::simd::calcPcmVolume(const float *pcm, size_t samples) {
     return globed::simd::x86::pcmVolume(pcm, samples);
 #endif
 }
+
+void util::simd::lerpTransforms(const util::simd::TransformLanes& lanes) {
+#ifdef GEODE_IS_ARM_MAC
+    globed::simd::arm::lerpTransforms(lanes);
+#else
+    globed::simd::x86::lerpTransforms(lanes);
+#endif
+}
@@ -6,3 +6,7 @@
 float util::simd::calcPcmVolume(const float *pcm, size_t samples) {
     return globed::simd::x86::pcmVolume(pcm, samples);
 }
+
+void util::simd::lerpTransforms(const util::simd::TransformLanes& lanes) {
+    globed::simd::x86::lerpTransforms(lanes);
+}
@@ -124,7 +124,6 @@ void ComplexVisualPlayer::updateIcons(const PlayerIconData& icons) {
 void ComplexVisualPlayer::updateData(
         const SpecificIconData& data,
         const VisualPlayerState& playerData,
-        const GameCameraState& camState,
         bool isSpeaking,
         float loudness
 ) {
@@ -132,7 +131,8 @@ void ComplexVisualPlayer::updateData(
 
     wasRotating = data.isRotating;
 
-    bool isNearby = this->isPlayerNearby(camState);
+    // always render them in editor (cause im lazy)
+    bool isNearby = this->isEditor || this->markedNearby;
     bool cameNearby = isNearby && !wasNearby;
     wasNearby = isNearby;
 
@@ -329,6 +329,9 @@ void ComplexVisualPlayer::updateData(
     if (!shouldBeVisible) {
         playerIcon->m_playEffects = false;
         if (playerIcon->m_regularTrail) playerIcon->m_regularTrail->setVisible(false);
+    } else if (!isNearby) {
+        // nobody is going to see the trail or particles of a far away player
+        playerIcon->m_playEffects = false;
     }
 }
 
@@ -442,6 +445,39 @@ void ComplexVisualPlayer::setForciblyHidden(bool state) {
     isForciblyHidden = state;
 }
 
+void ComplexVisualPlayer::setNearby(bool state) {
+    markedNearby = state;
+}
+
+void ComplexVisualPlayer::resetState() {
+    this->stopActionByTag(SPIDER_TELEPORT_COLOR_ACTION);
+    playerIcon->m_robotFire->stopActionByTag(ROBOT_FIRE_ACTION);
+    this->onAnimateRobotFireOut();
+
+    playerIcon->setColor(storedMainColor);
+    playerIcon->setSecondColor(storedSecondaryColor);
+    playerIcon->m_playEffects = false;
+
+    if (statusIcons) {
+        statusIcons->updateStatus(false, false, false, false, 0.f);
+    }
+
+    wasGrounded = false;
+    wasStationary = true;
+    wasFalling = false;
+    tpColorDelta = 0.f;
+    wasUpsideDown = false;
+    wasRotating = false;
+    didPerformPlatformerJump = false;
+    wasDashing = false;
+    // onEnter is called again once the player is added back to the object layer
+    wasPaused = false;
+    markedNearby = false;
+    wasNearby = false;
+    p1sticky = false;
+    p2sticky = false;
+}
+
 static inline ccColor3B lerpColor(ccColor3B from, ccColor3B to, float delta) {
     delta = std::clamp(delta, 0.f, 1.f);
 
@@ -783,34 +819,6 @@ void ComplexVisualPlayer::disableTrail() {
     // playerIcon->fadeOutStreak2(0.2f);
 }
 
-bool ComplexVisualPlayer::isPlayerNearby(const GameCameraState& camState) {
-    // always render them in editor (cause im lazy)
-    if (isEditor) return true;
-
-    // check if they are inside 3 screens
-    constexpr float fullScaleMult = 3.f;
-    constexpr float originMoveMult = (fullScaleMult - 1.f) / 2.f; // magic
-    CCSize origCoverage = camState.cameraCoverage();
-    CCSize cameraCoverage = origCoverage * fullScaleMult;
-    CCPoint cameraOrigin = camState.cameraOrigin - origCoverage * originMoveMult;
-
-    float cameraLeft = cameraOrigin.x;
-    float cameraRight = cameraOrigin.x + cameraCoverage.width;
-    float cameraBottom = cameraOrigin.y;
-    float cameraTop = cameraOrigin.y + cameraCoverage.height;
-
-    const auto& playerPosition = this->getPlayerPosition();
-
-    bool inCameraCoverage = (
-        playerPosition.x >= cameraLeft &&
-        playerPosition.x <= cameraRight &&
-        playerPosition.y >= cameraBottom &&
-        playerPosition.y <= cameraTop
-    );
-
-    return inCameraCoverage;
-}
-
 ComplexVisualPlayer* ComplexVisualPlayer::create(RemotePlayer* parent, bool isSecond) {
     auto ret = new ComplexVisualPlayer;
     if (ret->init(parent, isSecond)) {
@@ -21,7 +21,6 @@ public:
     void updateData(
         const SpecificIconData& data,
         const VisualPlayerState& playerData,
-        const GameCameraState& camState,
         bool isSpeaking,
         float loudness
     );
@@ -30,6 +29,10 @@ public:
     void playSpiderTeleport(const SpiderTeleportData& data);
     void playJump();
     void setForciblyHidden(bool state);
+    // set by the game layer from its spatial index, whether the player is within 3 screens of the camera
+    void setNearby(bool state);
+    // reset all the animation state, called when a pooled player is released
+    void resetState();
     const cocos2d::CCPoint& getPlayerPosition();
     cocos2d::CCNode* getPlayerObject();
     RemotePlayer* getRemotePlayer();
@@ -85,6 +88,7 @@ protected:
     bool wasPaused = false;
 
     // used for many anims
+    bool markedNearby = false;
     bool wasNearby = false;
 
     // uhh yeah forcibly hiding players
@@ -129,6 +133,4 @@ protected:
     void cancelPlatformerJumpAnim();
     void enableTrail();
     void disableTrail();
-
-    bool isPlayerNearby(const GameCameraState& camState);
 };
\ No newline at end of file
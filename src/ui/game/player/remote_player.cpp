@@ -55,16 +55,10 @@ void RemotePlayer::updateData(
         bool speaking,
         float loudness
 ) {
-    player1->updateData(data.player1, data, *gameCameraState, speaking, loudness);
-    player2->updateData(data.player2, data, *gameCameraState, speaking, loudness);
+    player1->updateData(data.player1, data, speaking, loudness);
+    player2->updateData(data.player2, data, speaking, loudness);
 
-    isEditorBuilding = data.isEditorBuilding;
-
-    lastPercentage = data.currentPercentage;
-    lastFrameFlags = frameFlags;
-    lastVisualState = data;
-
-    wasPracticing = data.isPracticing;
+    this->updateProgressData(data, frameFlags);
 
     // don't update any anims if hidden
     if (isForciblyHidden) return;
@@ -90,6 +84,16 @@ void RemotePlayer::updateData(
     }
 }
 
+void RemotePlayer::updateProgressData(const VisualPlayerState& data, FrameFlags frameFlags) {
+    isEditorBuilding = data.isEditorBuilding;
+
+    lastPercentage = data.currentPercentage;
+    lastFrameFlags = frameFlags;
+    lastVisualState = data;
+
+    wasPracticing = data.isPracticing;
+}
+
 void RemotePlayer::updateProgressIcon() {
     if (progressIcon) {
         progressIcon->updatePosition(lastPercentage, wasPracticing);
@@ -98,7 +102,7 @@ void RemotePlayer::updateProgressIcon() {
             progressIcon->setVisible(false);
         }
     } else if (progressArrow) {
-        progressArrow->updatePosition(*gameCameraState, player1->getPlayerPosition());
+        progressArrow->updatePosition(*gameCameraState, lastVisualState.player1.position);
 
         if (isForciblyHidden || isEditorBuilding) {
             progressArrow->setVisible(false);
@@ -126,6 +130,10 @@ bool RemotePlayer::isValidPlayer() {
     return accountData.accountId != 0;
 }
 
+bool RemotePlayer::isNearby() {
+    return player1->markedNearby || player2->markedNearby;
+}
+
 void RemotePlayer::setForciblyHidden(bool state) {
     isForciblyHidden = state;
     player1->setForciblyHidden(state);
@@ -156,6 +164,30 @@ void RemotePlayer::removeProgressIndicators() {
     }
 }
 
+void RemotePlayer::detachProgressIndicators() {
+    if (progressIcon) {
+        progressIcon->removeFromParent();
+    }
+
+    if (progressArrow) {
+        progressArrow->removeFromParent();
+    }
+}
+
+void RemotePlayer::resetState() {
+    this->setForciblyHidden(false);
+
+    defaultTicks = 0;
+    lastPercentage = 0.f;
+    wasPracticing = false;
+    isEditorBuilding = false;
+    lastFrameFlags = FrameFlags{};
+    lastVisualState = VisualPlayerState{};
+
+    player1->resetState();
+    player2->resetState();
+}
+
 RemotePlayer* RemotePlayer::create(GameCameraState* gameCameraState, PlayerProgressIcon* progressIcon, PlayerProgressArrow* progressArrow, const PlayerAccountData& data) {
     auto ret = new RemotePlayer;
     if (ret->init(gameCameraState, progressIcon, progressArrow, data)) {
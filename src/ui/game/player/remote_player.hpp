@@ -20,6 +20,8 @@ public:
         bool speaking,
         float loudness
     );
+    // lightweight version of `updateData` for frames skipped by the LOD scheduler, only keeps the progress indicators moving
+    void updateProgressData(const VisualPlayerState& data, FrameFlags frameFlags);
     void updateProgressIcon();
     void updateProgressArrow(
         cocos2d::CCPoint cameraOrigin,
@@ -35,11 +37,17 @@ public:
     void setDefaultTicks(unsigned int ticks);
     void incDefaultTicks();
     void removeProgressIndicators();
+    // detach the progress indicators from their parents but keep them around, for pooling
+    void detachProgressIndicators();
+    // reset the per-player state, so that the node can be reused for another player
+    void resetState();
 
     void setForciblyHidden(bool state);
     bool getForciblyHidden();
 
     bool isValidPlayer();
+    // whether either of the icons is within 3 screens of the camera
+    bool isNearby();
 
     static RemotePlayer* create(GameCameraState* gameCameraState, PlayerProgressIcon* progressIcon, PlayerProgressArrow* progressArrow, const PlayerAccountData& data);
     static RemotePlayer* create(GameCameraState* gameCameraState, PlayerProgressIcon* progressIcon, PlayerProgressArrow* progressArrow);
@@ -1,6 +1,5 @@
 #include "daily_level_cell.hpp"
 
-#include <data/packets/server/general.hpp>
 #include <managers/daily_manager.hpp>
 #include <net/manager.hpp>
 #include <util/ui.hpp>
@@ -31,13 +30,6 @@ bool GlobedDailyLevelCell::init() {
 
     this->reload();
 
-    NetworkManager::get().addListener<LevelPlayerCountPacket>(this, [this](std::shared_ptr<LevelPlayerCountPacket> packet) {
-        if (packet->levels.empty()) return;
-        auto [levelId, playerCount] = packet->levels.front();
-
-        this->updatePlayerCount(playerCount);
-    });
-
     return true;
 }
 
@@ -72,8 +64,6 @@ GlobedDailyLevelCell::~GlobedDailyLevelCell() {
 }
 
 void GlobedDailyLevelCell::createCell(GJGameLevel* level) {
-    NetworkManager::get().sendRequestPlayerCount(level->m_levelID);
-
     loadingCircle->fadeAndRemove();
 
     Build<CCScale9Sprite>::create("GJ_square02.png")
@@ -195,6 +185,17 @@ void GlobedDailyLevelCell::createCell(GJGameLevel* level) {
     if (diff) {
         DailyManager::get().attachRatingSprite(rating, diff);
     }
+
+    auto& nm = NetworkManager::get();
+    LevelId levelId = level->m_levelID;
+
+    nm.subscribePlayerCounts(this, {levelId}, [this, levelId] {
+        this->updatePlayerCount(NetworkManager::get().getPlayerCount(levelId).value_or(0));
+    });
+
+    if (auto count = nm.getPlayerCount(levelId)) {
+        this->updatePlayerCount(*count);
+    }
 }
 
 void GlobedDailyLevelCell::updatePlayerCount(unsigned short playerCount) {
@@ -2,8 +2,6 @@
 
 #include <hooks/level_cell.hpp>
 #include <hooks/gjgamelevel.hpp>
-#include <data/packets/client/general.hpp>
-#include <data/packets/server/general.hpp>
 #include <managers/error_queues.hpp>
 #include <managers/daily_manager.hpp>
 #include <net/manager.hpp>
@@ -101,14 +99,6 @@ bool GlobedFeaturedListLayer::init() {
 
     util::ui::prepareLayer(this);
 
-    NetworkManager::get().addListener<LevelPlayerCountPacket>(this, [this](auto packet) {
-        this->playerCounts.clear();
-
-        for (auto& [id, count] : packet->levels) {
-            this->playerCounts[id] = count;
-        }
-    });
-
     this->refreshLevels();
     this->scheduleUpdate();
 
@@ -122,9 +112,13 @@ GlobedFeaturedListLayer::~GlobedFeaturedListLayer() {
 void GlobedFeaturedListLayer::update(float dt) {
     if (!listLayer || !listLayer->m_listView) return;
 
+    auto& nm = NetworkManager::get();
+
     for (auto entry : CCArrayExt<CCNode*>(listLayer->m_listView->m_tableView->m_cellArray)) {
         auto cell = typeinfo_cast<LevelCell*>(entry);
-        static_cast<GlobedLevelCell*>(cell)->updatePlayerCount(playerCounts.contains(cell->m_level->m_levelID) ? playerCounts.at(cell->m_level->m_levelID) : 0);
+        if (!cell) continue;
+
+        static_cast<GlobedLevelCell*>(cell)->updatePlayerCount(nm.getPlayerCount(cell->m_level->m_levelID).value_or(0));
     }
 }
 
@@ -226,7 +220,8 @@ void GlobedFeaturedListLayer::createLevelList(const DailyManager::Page& page) {
         btnPageNext->setVisible(true);
     }
 
-    NetworkManager::get().sendRequestPlayerCount(levelIds);
+    // cells are created as they scroll into view, so `update` reads the counts every frame instead of waiting for changes
+    NetworkManager::get().subscribePlayerCounts(this, std::move(levelIds), {});
 }
 
 void GlobedFeaturedListLayer::refreshLevels(bool force) {
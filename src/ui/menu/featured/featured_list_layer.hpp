@@ -20,7 +20,6 @@ private:
     GJListLayer* listLayer = nullptr;
     LoadingCircle* loadingCircle = nullptr;
     CCMenuItemSpriteExtra *btnPagePrev = nullptr, *btnPageNext = nullptr;
-    std::unordered_map<LevelId, unsigned short> playerCounts;
     std::vector<DailyManager::Page> levelPages;
     int currentPage = 0;
     int lastPage = -1;
@@ -2,7 +2,6 @@
 
 #include <hooks/level_cell.hpp>
 #include <hooks/gjgamelevel.hpp>
-#include <data/packets/client/general.hpp>
 #include <data/packets/server/general.hpp>
 #include <net/manager.hpp>
 #include <managers/error_queues.hpp>
@@ -80,28 +79,49 @@ bool GlobedLevelListLayer::init() {
 
     NetworkManager::get().addListener<LevelListPacket>(this, [this](std::shared_ptr<LevelListPacket> packet) {
         this->levelList.clear();
-        this->levelPages.clear();
-        this->sortedLevelIds.clear();
+        this->levelListVersion = 0;
 
         for (const auto& level : packet->levels) {
             this->levelList.emplace(level.levelId, level.playerCount);
-            this->sortedLevelIds.push_back(level.levelId);
         }
 
-        // sort the levels
-        auto comparator = [this](int a, int b) {
-            if (!this->levelList.contains(a) || !this->levelList.contains(b)) return false;
+        this->rebuildLevelList();
+    });
+
+    NetworkManager::get().addListener<LevelListDeltaPacket>(this, [this](std::shared_ptr<LevelListDeltaPacket> packet) {
+        if (packet->baseVersion != 0 && packet->baseVersion != this->levelListVersion) {
+            // changes on top of a list we don't have, ask for everything again
+            this->levelListVersion = 0;
+            this->loading = false;
+            this->refreshLevels();
+            return;
+        }
+
+        bool sameLevels = packet->baseVersion != 0;
+
+        if (!sameLevels) {
+            this->levelList.clear();
+        }
 
-            auto aVal = this->levelList.at(a);
-            auto bVal = this->levelList.at(b);
+        for (LevelId id : packet->removed) {
+            sameLevels = sameLevels && !this->levelList.contains(id);
+            this->levelList.erase(id);
+        }
 
-            return aVal > bVal;
-        };
+        for (const auto& level : packet->upserted) {
+            auto [it, inserted] = this->levelList.insert_or_assign(level.levelId, level.playerCount);
+            sameLevels = sameLevels && !inserted;
+        }
 
-        std::sort(sortedLevelIds.begin(), sortedLevelIds.end(), comparator);
+        this->levelListVersion = packet->version;
 
-        this->currentPage = 0;
-        this->reloadPage();
+        if (sameLevels) {
+            // only player counts changed, so the pages and the levels downloaded from the servers are still good.
+            // this shows the cached page again, sorted by the new counts
+            this->reloadPage();
+        } else {
+            this->rebuildLevelList();
+        }
     });
 
     this->refreshLevels();
@@ -113,6 +133,30 @@ GlobedLevelListLayer::~GlobedLevelListLayer() {
     GameLevelManager::sharedState()->m_levelManagerDelegate = nullptr;
 }
 
+void GlobedLevelListLayer::rebuildLevelList() {
+    this->levelPages.clear();
+    this->sortedLevelIds.clear();
+
+    for (const auto& [levelId, _] : levelList) {
+        this->sortedLevelIds.push_back(levelId);
+    }
+
+    // sort the levels
+    auto comparator = [this](LevelId a, LevelId b) {
+        if (!this->levelList.contains(a) || !this->levelList.contains(b)) return false;
+
+        auto aVal = this->levelList.at(a);
+        auto bVal = this->levelList.at(b);
+
+        return aVal > bVal;
+    };
+
+    std::sort(sortedLevelIds.begin(), sortedLevelIds.end(), comparator);
+
+    this->currentPage = 0;
+    this->reloadPage();
+}
+
 void GlobedLevelListLayer::reloadPage() {
     loading = true;
 
@@ -283,8 +327,8 @@ void GlobedLevelListLayer::refreshLevels() {
     auto& nm = NetworkManager::get();
     if (!nm.established()) return;
 
-    // request the level list from the server
-    nm.send(RequestLevelListPacket::create());
+    // request the changes to the level list from the server
+    nm.sendRequestLevelListDelta(levelListVersion);
 
     // remove existing listview and put a loading circle
     this->showLoadingUi();
@@ -21,6 +21,8 @@ private:
     std::unordered_map<LevelId, unsigned short> levelList;
     std::vector<LevelId> sortedLevelIds;
     std::vector<std::vector<Ref<GJGameLevel>>> levelPages;
+    // version of `levelList` as known by the server, 0 if it wasn't received through a `LevelListDeltaPacket`
+    uint32_t levelListVersion = 0;
     GlobedFeaturedLevel currentFeaturedLevel;
     int currentPage = 0;
     bool loading = false;
@@ -28,6 +30,7 @@ private:
     bool init() override;
     void keyBackClicked() override;
     void refreshLevels();
+    void rebuildLevelList();
     void reloadPage();
 
     void loadListCommon();
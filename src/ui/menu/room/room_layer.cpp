@@ -38,6 +38,22 @@ namespace {
         constexpr int Invite = 6;
         constexpr int Refresh = 100; // dead last
     }
+
+    // `filter` must be lowercase
+    bool passesFilter(const PlayerRoomPreviewAccountData& data, std::string_view filter) {
+        if (data.accountId <= 0) {
+            return false;
+        }
+
+        if (!filter.empty()) {
+            auto name = util::format::toLowercase(data.name);
+            if (name.find(filter) == std::string::npos) {
+                return false;
+            }
+        }
+
+        return true;
+    }
 }
 
 bool RoomLayer::init() {
@@ -227,6 +243,10 @@ bool RoomLayer::init() {
         this->onPlayerListReceived(*packet);
     });
 
+    nm.addListener<RoomPlayerListDeltaPacket>(this, [this](auto packet) {
+        this->onPlayerListDeltaReceived(*packet);
+    });
+
     nm.addListener<RoomCreatedPacket>(this, [this](auto packet) {
         this->onRoomCreatedReceived(*packet);
     });
@@ -314,7 +334,7 @@ void RoomLayer::requestPlayerList() {
 
     this->startLoading();
 
-    nm.sendRequestRoomPlayerList();
+    nm.sendRequestRoomPlayerListDelta(playerListVersion);
 }
 
 void RoomLayer::recreatePlayerList() {
@@ -330,18 +350,10 @@ void RoomLayer::recreatePlayerList() {
     auto filter = util::format::toLowercase(currentFilter);
 
     for (const auto& data : playerList) {
-        // filtering
-        if (data.accountId <= 0) {
+        if (!passesFilter(data, filter)) {
             continue;
         }
 
-        if (!filter.empty()) {
-            auto name = util::format::toLowercase(data.name);
-            if (name.find(filter) == std::string::npos) {
-                continue;
-            }
-        }
-
         listLayer->addCellFast(data, listSize.width, false, true);
     }
 
@@ -418,6 +430,74 @@ void RoomLayer::onPlayerListReceived(const RoomPlayerListPacket& packet) {
     this->reloadData(packet.info, packet.players);
 }
 
+void RoomLayer::onPlayerListDeltaReceived(const RoomPlayerListDeltaPacket& packet) {
+    auto& rm = RoomManager::get();
+
+    // a full list
+    if (packet.baseVersion == 0) {
+        this->reloadData(packet.info, packet.upserted);
+        playerListVersion = packet.version;
+        return;
+    }
+
+    // changes on top of a list we don't have, can only happen if the list got reloaded while the request was in flight.
+    // the upserted players are only a part of the list, so don't show them and ask for everything again
+    if (packet.baseVersion != playerListVersion || rm.getId() != packet.info.id) {
+        playerListVersion = 0;
+        this->requestPlayerList();
+        return;
+    }
+
+    this->stopLoading();
+
+    rm.setInfo(packet.info);
+    playerListVersion = packet.version;
+
+    if (packet.upserted.empty() && packet.removed.empty()) {
+        return;
+    }
+
+    // updated players are removed and added back, same as new ones
+    std::unordered_set<int> changed(packet.removed.begin(), packet.removed.end());
+    for (const auto& data : packet.upserted) {
+        changed.insert(data.accountId);
+    }
+
+    std::erase_if(playerList, [&](const auto& data) {
+        return changed.contains(data.accountId);
+    });
+
+    playerList.insert(playerList.end(), packet.upserted.begin(), packet.upserted.end());
+
+    // apply the same changes to the cells, leaving everyone else's cell (and loaded icon) alone
+    auto scrollPos = listLayer->getScrollPos();
+
+    std::vector<ListCellWrapper*> staleCells;
+    for (auto cell : *listLayer) {
+        if (cell->playerCell && changed.contains(cell->playerCell->playerData.accountId)) {
+            staleCells.push_back(cell);
+        }
+    }
+
+    for (auto cell : staleCells) {
+        listLayer->removeCell(cell, false);
+    }
+
+    auto filter = util::format::toLowercase(currentFilter);
+
+    for (const auto& data : packet.upserted) {
+        if (!passesFilter(data, filter)) {
+            continue;
+        }
+
+        listLayer->addCellFast(data, listSize.width, false, true);
+    }
+
+    this->sortPlayerList();
+
+    listLayer->scrollToPos(scrollPos);
+}
+
 void RoomLayer::onRoomCreatedReceived(const RoomCreatedPacket& packet) {
     this->reloadData(packet.info, {});
 }
@@ -461,6 +541,9 @@ void RoomLayer::reloadData(const RoomInfo& info, const std::vector<PlayerRoomPre
         this->playerList = players;
     }
 
+    // the server only knows the version if this came from a `RoomPlayerListDeltaPacket`, in which case the caller sets it
+    playerListVersion = 0;
+
     auto& rm = RoomManager::get();
 
     bool changedRoom = rm.getId() != info.id;
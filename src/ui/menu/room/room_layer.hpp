@@ -6,6 +6,7 @@
 #include <ui/general/list/list.hpp>
 
 class RoomPlayerListPacket;
+class RoomPlayerListDeltaPacket;
 class RoomCreatedPacket;
 class RoomJoinedPacket;
 class RoomInfoPacket;
@@ -25,6 +26,8 @@ protected:
     using PlayerList = GlobedListLayer<ListCellWrapper>;
 
     std::vector<PlayerRoomPreviewAccountData> playerList;
+    // version of `playerList` as known by the server, 0 if it wasn't received through a `RoomPlayerListDeltaPacket`
+    uint32_t playerListVersion = 0;
     std::string currentFilter;
 
     bool justEntered = true;
@@ -58,6 +61,7 @@ protected:
 
     // packet handlers
     void onPlayerListReceived(const RoomPlayerListPacket&);
+    void onPlayerListDeltaReceived(const RoomPlayerListDeltaPacket&);
     void onRoomCreatedReceived(const RoomCreatedPacket&);
     void onRoomJoinedReceived(const RoomJoinedPacket&);
     void reloadData(const RoomInfo& info, const std::vector<PlayerRoomPreviewAccountData>& players);
@@ -0,0 +1,600 @@
+#include "benchmark_popup.hpp"
+
+#ifdef GLOBED_DEBUG
+
+#include <thread>
+
+#include <asp/sync.hpp>
+
+#include <data/packets/all.hpp>
+#include <data/types/room.hpp>
+#include <crypto/box.hpp>
+#include <crypto/session_box.hpp>
+#include <game/collision_broadphase.hpp>
+#include <game/interpolator.hpp>
+#include <net/dispatch_table.hpp>
+#include <util/compress.hpp>
+#include <util/crypto.hpp>
+#include <util/debug.hpp>
+#include <util/format.hpp>
+#include <util/lockfree.hpp>
+#include <util/misc.hpp>
+#include <util/simd.hpp>
+#include <util/ui.hpp>
+
+using namespace geode::prelude;
+
+bool BenchmarkPopup::setup() {
+    auto rlayout = util::ui::getPopupLayout(m_size);
+    this->setTitle("Benchmarks");
+
+    auto* menu = Build<CCMenu>::create()
+        .layout(RowLayout::create()
+            ->setGap(5.f)
+            ->setGrowCrossAxis(true)
+            ->setCrossAxisOverflow(false)
+        )
+        .contentSize(POPUP_WIDTH - 20.f, POPUP_HEIGHT - 45.f)
+        .pos(rlayout.center - CCPoint{0.f, 10.f})
+        .parent(m_mainLayer)
+        .collect();
+
+    std::pair<const char*, void(BenchmarkPopup::*)()> benchmarks[] = {
+        {"Dispatch", &BenchmarkPopup::benchmarkDispatch},
+        {"Codec", &BenchmarkPopup::benchmarkCodec},
+        {"Pool", &BenchmarkPopup::benchmarkPacketPool},
+        {"Lerp", &BenchmarkPopup::benchmarkInterpolator},
+        {"Collision", &BenchmarkPopup::benchmarkCollision},
+        {"Queue", &BenchmarkPopup::benchmarkQueues},
+        {"Crypto", &BenchmarkPopup::benchmarkCrypto},
+        {"Compression", &BenchmarkPopup::benchmarkCompression},
+    };
+
+    for (auto [name, method] : benchmarks) {
+        Build<ButtonSprite>::create(name, "bigFont.fnt", "GJ_button_01.png", 0.75f)
+            .scale(0.6f)
+            .intoMenuItem([this, method = method](auto) {
+                (this->*method)();
+            })
+            .parent(menu);
+    }
+
+    menu->updateLayout();
+
+    return true;
+}
+
+void BenchmarkPopup::benchmarkDispatch() {
+    constexpr size_t PACKET_COUNT = 10000;
+
+    // uses a separate table, so that no real listeners get invoked
+    for (size_t listenerCount : {1, 5, 20}) {
+        PacketDispatchTable table;
+        std::vector<Ref<PacketListener>> listeners;
+        size_t calls = 0;
+
+        for (size_t i = 0; i < listenerCount; i++) {
+            auto* listener = PacketListener::create(LevelDataPacket::PACKET_ID, [&calls](auto) {
+                calls++;
+            }, this, static_cast<int>(listenerCount - i), false);
+
+            table.registerListener(LevelDataPacket::PACKET_ID, listener);
+            listeners.push_back(listener);
+        }
+
+        std::shared_ptr<Packet> packet = LevelDataPacket::create();
+
+        util::debug::Benchmarker bb;
+        auto took = bb.run([&] {
+            for (size_t i = 0; i < PACKET_COUNT; i++) {
+                table.dispatch(packet);
+            }
+        });
+
+        log::debug(
+            "Dispatched {} packets to {} listeners ({} calls) in {} ({}ns per packet)",
+            PACKET_COUNT, listenerCount, calls, util::format::duration(took), util::time::nanos(took).count() / PACKET_COUNT
+        );
+    }
+}
+
+template <typename T>
+static void benchmarkCodecFor(const char* name, const T& value) {
+    constexpr size_t ITERATIONS = 100000;
+
+    size_t expectedSize = EncodedSize<T>::of(value);
+
+    ByteBuffer encoded;
+    encoded.writeValue(value);
+    if (encoded.size() != expectedSize) {
+        log::warn("{}: calculated encoded size {} does not match the actual size {}", name, expectedSize, encoded.size());
+    }
+
+    util::debug::Benchmarker bb;
+
+    auto encodeTook = bb.run([&] {
+        for (size_t i = 0; i < ITERATIONS; i++) {
+            ByteBuffer buf;
+            buf.reserve(EncodedSize<T>::of(value));
+            buf.writeValue(value);
+        }
+    });
+
+    size_t failures = 0;
+    auto decodeTook = bb.run([&] {
+        for (size_t i = 0; i < ITERATIONS; i++) {
+            ByteBuffer buf(encoded.data().data(), encoded.size(), ByteBuffer::borrow);
+            if (buf.readValue<T>().isErr()) failures++;
+        }
+    });
+
+    log::debug(
+        "{} ({} bytes, fixed: {}, flat: {}): encode {}ns, decode {}ns ({} failures)",
+        name, expectedSize, EncodedSize<T>::FIXED, EncodedSize<T>::FLAT,
+        util::time::nanos(encodeTook).count() / ITERATIONS, util::time::nanos(decodeTook).count() / ITERATIONS, failures
+    );
+}
+
+void BenchmarkPopup::benchmarkCodec() {
+    PlayerData playerData{};
+    playerData.timestamp = 12.5f;
+    playerData.player1.position = {1234.5f, 345.f};
+    playerData.player1.iconType = PlayerIconType::Cube;
+    playerData.player2 = playerData.player1;
+    playerData.currentPercentage = 42.f;
+
+    PlayerAccountData accountData = PlayerAccountData::DEFAULT_DATA;
+    accountData.specialUserData.roles = std::vector<uint8_t>{1, 2};
+
+    RoomInfo roomInfo{};
+    roomInfo.id = 123456;
+    roomInfo.owner = PlayerPreviewAccountData(1, 2, "Player", PlayerIconDataSimple{}, 0);
+    roomInfo.name = "benchmark room";
+    roomInfo.settings.playerLimit = 50;
+
+    benchmarkCodecFor("PlayerData", playerData);
+    benchmarkCodecFor("PlayerAccountData", accountData);
+    benchmarkCodecFor("RoomInfo", roomInfo);
+    benchmarkCodecFor("PlayerIconData", PlayerIconData::DEFAULT_ICONS);
+}
+
+void BenchmarkPopup::benchmarkPacketPool() {
+    constexpr size_t PACKET_COUNT = 10000;
+
+    for (const auto& stats : getPacketPoolStats()) {
+        log::debug("{}: {} allocations, {} reuses, {} pooled", stats.packetName, stats.allocations, stats.reuses, stats.pooled);
+    }
+
+    LevelDataPacket source;
+    for (int i = 0; i < 20; i++) {
+        source.players.emplace_back(i, PlayerData{});
+    }
+
+    ByteBuffer encoded;
+    source.encode(encoded);
+
+    auto& pool = PacketPool<LevelDataPacket>::get();
+    size_t allocationsBefore = pool.stats().allocations;
+
+    // if the pool works, the same instance is reused every time and its vector never has to grow again
+    const AssociatedPlayerData* lastStorage = nullptr;
+    size_t reallocations = 0;
+    size_t failures = 0;
+
+    util::debug::Benchmarker bb;
+    auto took = bb.run([&] {
+        for (size_t i = 0; i < PACKET_COUNT; i++) {
+            auto packet = pool.acquire();
+
+            ByteBuffer buf(encoded.data().data(), encoded.size(), ByteBuffer::borrow);
+            if (packet->decode(buf).isErr()) failures++;
+
+            if (lastStorage && packet->players.data() != lastStorage) reallocations++;
+            lastStorage = packet->players.data();
+        }
+    });
+
+    log::debug(
+        "Decoded {} pooled packets in {} ({}ns per packet): {} packet allocations, {} vector reallocations, {} failures",
+        PACKET_COUNT, util::format::duration(took), util::time::nanos(took).count() / PACKET_COUNT,
+        pool.stats().allocations - allocationsBefore, reallocations, failures
+    );
+}
+
+void BenchmarkPopup::benchmarkInterpolator() {
+    constexpr size_t FRAMES = 600;
+    constexpr float FRAME_DELTA = 1.f / 240.f;
+    constexpr float PACKET_DELTA = 1.f / 30.f;
+
+    for (size_t playerCount : {10, 100, 1000}) {
+        PlayerInterpolator interpolator(InterpolatorSettings {
+            .realtime = false,
+            .isPlatformer = false,
+            .extrapolate = true,
+            .expectedDelta = PACKET_DELTA,
+        });
+
+        for (size_t i = 0; i < playerCount; i++) {
+            interpolator.addPlayer(static_cast<int>(i));
+        }
+
+        PlayerData data{};
+        data.player1.iconType = PlayerIconType::Cube;
+        data.player2.iconType = PlayerIconType::Ship;
+
+        float time = 0.f;
+        float nextPacket = 0.f;
+
+        util::debug::Benchmarker bb;
+        auto took = bb.run([&] {
+            for (size_t frame = 0; frame < FRAMES; frame++) {
+                time += FRAME_DELTA;
+
+                if (time >= nextPacket) {
+                    nextPacket += PACKET_DELTA;
+
+                    for (size_t i = 0; i < playerCount; i++) {
+                        data.timestamp = nextPacket;
+                        data.player1.position = CCPoint{nextPacket * 300.f + i, 100.f + i};
+                        data.player1.rotation = nextPacket * 90.f;
+                        data.player2.position = CCPoint{nextPacket * 300.f + i, 200.f + i};
+                        data.player2.rotation = -nextPacket * 90.f;
+
+                        interpolator.updatePlayer(static_cast<int>(i), data, time);
+                    }
+                }
+
+                interpolator.tick(FRAME_DELTA);
+            }
+        });
+
+        log::debug(
+            "Interpolated {} players for {} frames in {} ({}ns per frame, {}ns per player)",
+            playerCount, FRAMES, util::format::duration(took),
+            util::time::nanos(took).count() / FRAMES, util::time::nanos(took).count() / FRAMES / playerCount
+        );
+    }
+
+    // the transform kernel alone, against the scalar version
+    constexpr size_t LANES = 2000;
+    constexpr size_t ITERATIONS = 1000;
+
+    std::vector<float> input[8], simdOut[3], scalarOut[3];
+    for (auto& vec : input) vec.resize(LANES);
+    for (auto& vec : simdOut) vec.resize(LANES);
+    for (auto& vec : scalarOut) vec.resize(LANES);
+
+    for (size_t i = 0; i < LANES; i++) {
+        input[0][i] = i * 3.f;
+        input[1][i] = i * 0.5f;
+        input[2][i] = i * 7.f;
+        input[3][i] = i * 3.f + 10.f;
+        input[4][i] = i * 0.5f + (i % 5 == 0 ? 60.f : 1.f);
+        input[5][i] = i * 7.f + 200.f;
+        input[6][i] = (i % 100) / 100.f;
+        input[7][i] = i % 3 == 0 ? 1.f : 0.f;
+    }
+
+    auto makeLanes = [&](std::vector<float>* out) {
+        return util::simd::TransformLanes {
+            .olderX = input[0].data(),
+            .olderY = input[1].data(),
+            .olderRotation = input[2].data(),
+            .newerX = input[3].data(),
+            .newerY = input[4].data(),
+            .newerRotation = input[5].data(),
+            .ratio = input[6].data(),
+            .spider = input[7].data(),
+            .outX = out[0].data(),
+            .outY = out[1].data(),
+            .outRotation = out[2].data(),
+            .count = LANES,
+        };
+    };
+
+    auto simdLanes = makeLanes(simdOut);
+    auto scalarLanes = makeLanes(scalarOut);
+
+    util::debug::Benchmarker bb;
+    auto simdTook = bb.run([&] {
+        for (size_t i = 0; i < ITERATIONS; i++) {
+            util::simd::lerpTransforms(simdLanes);
+        }
+    });
+
+    auto scalarTook = bb.run([&] {
+        for (size_t i = 0; i < ITERATIONS; i++) {
+            util::misc::lerpTransformsSlow(scalarLanes);
+        }
+    });
+
+    float maxError = 0.f;
+    for (size_t i = 0; i < 3; i++) {
+        for (size_t j = 0; j < LANES; j++) {
+            maxError = std::max(maxError, std::abs(simdOut[i][j] - scalarOut[i][j]));
+        }
+    }
+
+    log::debug(
+        "Transform lerp of {} lanes: simd {}ns, scalar {}ns, max difference {}",
+        LANES, util::time::nanos(simdTook).count() / ITERATIONS, util::time::nanos(scalarTook).count() / ITERATIONS, maxError
+    );
+}
+
+void BenchmarkPopup::benchmarkCollision() {
+    constexpr size_t FRAMES = 600;
+    // 240hz physics at 60fps, for both of our icons
+    constexpr size_t QUERIES_PER_FRAME = 4 * 2;
+    constexpr float ICON_SIZE = 30.f;
+
+    for (size_t playerCount : {50, 200}) {
+        // a platformer room, everyone crowded around the spawn on a couple of floors, some people wandering off
+        std::vector<CCRect> rects(playerCount * 2);
+        std::vector<CCRect> ours(QUERIES_PER_FRAME);
+
+        auto moveEveryone = [&](size_t frame) {
+            for (size_t i = 0; i < rects.size(); i++) {
+                float x = (i % 7 == 0) ? i * 400.f : (i * 37 % 900) + frame * 0.5f;
+                float y = 105.f + (i % 4) * 120.f;
+                rects[i] = CCRect{x, y, ICON_SIZE, ICON_SIZE};
+            }
+
+            for (size_t i = 0; i < ours.size(); i++) {
+                ours[i] = CCRect{300.f + frame * 0.5f + i, 105.f + (i % 2) * 120.f, ICON_SIZE, ICON_SIZE};
+            }
+        };
+
+        size_t bruteHits = 0, broadHits = 0;
+
+        util::debug::Benchmarker bb;
+        auto bruteTook = bb.run([&] {
+            for (size_t frame = 0; frame < FRAMES; frame++) {
+                moveEveryone(frame);
+
+                for (const auto& our : ours) {
+                    for (const auto& rect : rects) {
+                        if (our.intersectsRect(rect)) bruteHits++;
+                    }
+                }
+            }
+        });
+
+        CollisionBroadphase broadphase;
+        auto broadTook = bb.run([&] {
+            for (size_t frame = 0; frame < FRAMES; frame++) {
+                moveEveryone(frame);
+
+                broadphase.clear();
+                for (size_t i = 0; i < rects.size(); i++) {
+                    broadphase.add(static_cast<int>(i / 2), i % 2 == 1, rects[i]);
+                }
+                broadphase.build();
+
+                for (const auto& our : ours) {
+                    broadphase.query(our, [&](const CollisionBroadphase::Body& body) {
+                        if (our.intersectsRect(body.rect)) broadHits++;
+                    });
+                }
+            }
+        });
+
+        log::debug(
+            "Collision checks with {} players over {} frames: brute force {}ns per frame ({} hits), broadphase {}ns per frame ({} hits)",
+            playerCount, FRAMES,
+            util::time::nanos(bruteTook).count() / FRAMES, bruteHits,
+            util::time::nanos(broadTook).count() / FRAMES, broadHits
+        );
+    }
+}
+
+void BenchmarkPopup::benchmarkQueues() {
+    // voice (audio thread) and player data (main thread) being sent at the same time, drained by the network thread.
+    // way more packets than real traffic, so that the producers actually run into each other
+    constexpr size_t VOICE_PACKETS = 100000;
+    constexpr size_t DATA_PACKETS = 200000;
+    constexpr size_t TOTAL = VOICE_PACKETS + DATA_PACKETS;
+
+    auto voicePacket = VoiceBroadcastPacket::create();
+    auto dataPacket = PlayerDataPacket::create();
+
+    auto run = [&](auto&& push, auto&& pop) {
+        util::debug::Benchmarker bb;
+
+        return bb.run([&] {
+            std::thread voiceThread([&] {
+                for (size_t i = 0; i < VOICE_PACKETS; i++) push(voicePacket);
+            });
+
+            std::thread dataThread([&] {
+                for (size_t i = 0; i < DATA_PACKETS; i++) push(dataPacket);
+            });
+
+            size_t received = 0;
+            while (received < TOTAL) {
+                if (pop()) {
+                    received++;
+                } else {
+                    std::this_thread::yield();
+                }
+            }
+
+            voiceThread.join();
+            dataThread.join();
+        });
+    };
+
+    asp::Channel<std::shared_ptr<Packet>> channel;
+    auto channelTook = run(
+        [&](std::shared_ptr<Packet> packet) { channel.push(std::move(packet)); },
+        [&] { return channel.tryPop().has_value(); }
+    );
+
+    auto queue = std::make_unique<util::lockfree::MpscQueue<std::shared_ptr<Packet>, 1024>>();
+    auto queueTook = run(
+        [&](std::shared_ptr<Packet> packet) {
+            while (!queue->tryPush(std::move(packet))) {
+                std::this_thread::yield();
+            }
+        },
+        [&] { return queue->tryPop().has_value(); }
+    );
+
+    log::debug(
+        "Queued {} voice and {} player data packets from 2 threads: asp::Channel {} ({}ns per packet), MpscQueue {} ({}ns per packet)",
+        VOICE_PACKETS, DATA_PACKETS,
+        util::format::duration(channelTook), util::time::nanos(channelTook).count() / TOTAL,
+        util::format::duration(queueTook), util::time::nanos(queueTook).count() / TOTAL
+    );
+}
+
+void BenchmarkPopup::benchmarkCrypto() {
+    constexpr size_t ITERATIONS = 20000;
+
+    CryptoBox clientBox, serverBox;
+    clientBox.setPeerKey(serverBox.getPublicKey());
+    serverBox.setPeerKey(clientBox.getPublicKey());
+
+    auto seed = util::crypto::secureRandom(SessionBox::SEED_LEN);
+    SessionBox clientSession(seed.data()), serverSession(seed.data(), true);
+
+    // roughly player data, a room list and a voice frame
+    for (size_t size : {64, 512, 4096}) {
+        util::data::bytevector buffer(size + CryptoBox::PREFIX_LEN);
+        util::crypto::secureRandom(buffer.data(), size);
+
+        size_t failed = 0;
+
+        util::debug::Benchmarker bb;
+        auto boxTook = bb.run([&] {
+            for (size_t i = 0; i < ITERATIONS; i++) {
+                size_t len = clientBox.encryptInPlace(buffer.data(), size);
+                if (!serverBox.decryptInPlace(buffer.data(), len)) failed++;
+            }
+        });
+
+        auto sessionTook = bb.run([&] {
+            for (size_t i = 0; i < ITERATIONS; i++) {
+                auto len = clientSession.encryptInPlace(SessionBox::Channel::Udp, buffer.data(), size);
+                if (!len || !serverSession.decryptInPlace(SessionBox::Channel::Udp, buffer.data(), len.unwrap())) failed++;
+            }
+        });
+
+        auto throughput = [&](util::time::micros took) {
+            return static_cast<double>(size * ITERATIONS) / std::max<double>(took.count(), 1.0);
+        };
+
+        log::debug(
+            "Encrypt + decrypt of {} byte packets: CryptoBox {}ns ({:.1f} MB/s, +{} bytes), SessionBox {}ns ({:.1f} MB/s, +{} bytes), {} failed",
+            size,
+            util::time::nanos(boxTook).count() / ITERATIONS, throughput(boxTook), CryptoBox::PREFIX_LEN,
+            util::time::nanos(sessionTook).count() / ITERATIONS, throughput(sessionTook), SessionBox::PREFIX_LEN,
+            failed
+        );
+    }
+}
+
+void BenchmarkPopup::benchmarkCompression() {
+    constexpr size_t ITERATIONS = 200;
+    constexpr std::array LIST_PACKETS = std::to_array<packetid_t>({
+        GlobalPlayerListPacket::PACKET_ID, LevelListPacket::PACKET_ID, RoomJoinedPacket::PACKET_ID,
+        RoomPlayerListPacket::PACKET_ID, RoomListPacket::PACKET_ID,
+    });
+
+    std::vector<std::pair<std::string, util::data::bytevector>> payloads;
+
+    // lists captured with packet logging enabled, see `GameSocket::dumpPacket`
+    std::error_code ec;
+    for (const auto& entry : std::filesystem::directory_iterator(Mod::get()->getSaveDir() / "packets", ec)) {
+        auto filename = entry.path().filename().string();
+
+        auto dash = filename.find('-');
+        if (dash == std::string::npos || dash == 0) continue;
+
+        auto id = util::format::parse<packetid_t>(filename.substr(0, dash));
+        if (!id || std::find(LIST_PACKETS.begin(), LIST_PACKETS.end(), *id) == LIST_PACKETS.end()) continue;
+
+        auto data = geode::utils::file::readBinary(entry.path());
+        if (!data || data.unwrap().size() < PacketHeader::SIZE) continue;
+
+        // the packet log stores packets the way they were received, compressed ones have to be decompressed first
+        auto& raw = data.unwrap();
+        util::data::bytevector body(raw.begin() + PacketHeader::SIZE, raw.end());
+        if (raw[sizeof(packetid_t)] & PacketHeader::FLAG_COMPRESSED) {
+            util::data::bytevector out;
+            auto len = util::compress::decompress(body.data(), body.size(), out);
+            if (!len) continue;
+
+            out.resize(len.unwrap());
+            body = std::move(out);
+        }
+
+        payloads.emplace_back(filename, std::move(body));
+    }
+
+    // nothing captured, fall back to a made up global player list
+    if (payloads.empty()) {
+        constexpr std::array NAMES = std::to_array<std::string_view>({"Player", "xX_Gamer_Xx", "Cool", "Dash", "Wave", "Robtop", "Globed"});
+
+        std::vector<PlayerPreviewAccountData> players;
+        for (int i = 0; i < 2000; i++) {
+            PlayerPreviewAccountData player;
+            player.accountId = 1000000 + i * 37;
+            player.userId = 2000000 + i * 53;
+            player.name = fmt::format("{}{}", NAMES[i % NAMES.size()], i % 1000);
+            player.icons = PlayerIconDataSimple(i % 150, i % 20, (i * 7) % 20, i % 3 == 0 ? 12 : NO_GLOW);
+            players.push_back(std::move(player));
+        }
+
+        ByteBuffer bb;
+        bb.writeValue(players);
+        payloads.emplace_back("synthetic global player list", bb.data());
+    }
+
+    for (const auto& [name, payload] : payloads) {
+        if (payload.size() > util::compress::MAX_DECOMPRESSED_SIZE) continue;
+
+        util::data::bytevector compressed, decompressed;
+        size_t decompressedLength = 0;
+
+        util::debug::Benchmarker bb;
+        auto compressTook = bb.run([&] {
+            for (size_t i = 0; i < ITERATIONS; i++) {
+                compressed.clear();
+                util::compress::compress(payload.data(), payload.size(), compressed);
+            }
+        });
+
+        auto decompressTook = bb.run([&] {
+            for (size_t i = 0; i < ITERATIONS; i++) {
+                decompressedLength = util::compress::decompress(compressed.data(), compressed.size(), decompressed).unwrapOr(0);
+            }
+        });
+
+        bool matches = decompressedLength == payload.size() && std::equal(payload.begin(), payload.end(), decompressed.begin());
+
+        auto throughput = [&](util::time::micros took) {
+            return static_cast<double>(payload.size() * ITERATIONS) / std::max<double>(took.count(), 1.0);
+        };
+
+        log::debug(
+            "{}: {} -> {} bytes ({:.1f}%), compress {} ({:.1f} MB/s), decompress {} ({:.1f} MB/s), round trip {}",
+            name, payload.size(), compressed.size(), compressed.size() * 100.0 / std::max<size_t>(payload.size(), 1),
+            util::format::duration(compressTook / ITERATIONS), throughput(compressTook),
+            util::format::duration(decompressTook / ITERATIONS), throughput(decompressTook),
+            matches ? "ok" : "MISMATCH"
+        );
+    }
+}
+
+BenchmarkPopup* BenchmarkPopup::create() {
+    auto ret = new BenchmarkPopup;
+    if (ret->init(POPUP_WIDTH, POPUP_HEIGHT)) {
+        ret->autorelease();
+        return ret;
+    }
+
+    delete ret;
+    return nullptr;
+}
+
+#endif // GLOBED_DEBUG
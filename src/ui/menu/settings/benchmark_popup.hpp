@@ -0,0 +1,27 @@
+#pragma once
+#include <defs/geode.hpp>
+
+#ifdef GLOBED_DEBUG
+
+// Microbenchmarks of the networking and interpolation code, only available in debug builds. Results are written to the log.
+class BenchmarkPopup : public geode::Popup<> {
+public:
+    static constexpr float POPUP_WIDTH = 300.f;
+    static constexpr float POPUP_HEIGHT = 180.f;
+
+    static BenchmarkPopup* create();
+
+private:
+    bool setup() override;
+
+    void benchmarkDispatch();
+    void benchmarkCodec();
+    void benchmarkPacketPool();
+    void benchmarkInterpolator();
+    void benchmarkCollision();
+    void benchmarkQueues();
+    void benchmarkCrypto();
+    void benchmarkCompression();
+};
+
+#endif // GLOBED_DEBUG
@@ -6,6 +6,7 @@
 #include "frag_calibration_popup.hpp"
 #include "string_input_popup.hpp"
 #include "advanced_settings_popup.hpp"
+#include "benchmark_popup.hpp"
 #include <managers/settings.hpp>
 #include <net/manager.hpp>
 #include <ui/general/ask_input_popup.hpp>
@@ -121,11 +122,12 @@ bool GlobedSettingCell::init(void* settingStorage, Type settingType, const char*
         case Type::String: [[fallthrough]];
         case Type::PacketFragmentation: [[fallthrough]];
         case Type::AdvancedSettings: [[fallthrough]];
+        case Type::Benchmarks: [[fallthrough]];
         case Type::AudioDevice: {
             const char* text;
             if (settingType == Type::PacketFragmentation) {
                 text = "Auto";
-            } else if (settingType == Type::AdvancedSettings) {
+            } else if (settingType == Type::AdvancedSettings || settingType == Type::Benchmarks) {
                 text = "View";
             } else if (settingType == Type::AudioDevice) {
                 text = "Set";
@@ -260,6 +262,10 @@ void GlobedSettingCell::onInteractiveButton(cocos2d::CCObject*) {
         }
     } else if (settingType == Type::AdvancedSettings) {
         AdvancedSettingsPopup::create()->show();
+    } else if (settingType == Type::Benchmarks) {
+#ifdef GLOBED_DEBUG
+        BenchmarkPopup::create()->show();
+#endif
     } else {
         StringInputPopup::create([this](const std::string_view text) {
             this->onStringChanged(text);
@@ -368,7 +374,8 @@ void GlobedSettingCell::storeAndSave(std::any&& value) {
         case Type::InvitesFrom: [[fallthrough]];
         case Type::Int:
             *(int*)(settingStorage) = std::any_cast<int>(value); break;
-        case Type::AdvancedSettings:
+        case Type::AdvancedSettings: [[fallthrough]];
+        case Type::Benchmarks:
             break;
     }
 
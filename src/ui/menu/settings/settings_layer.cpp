@@ -232,6 +232,7 @@ void GlobedSettingsLayer::createSettingsCells(int category) {
 #ifdef GLOBED_DEBUG
             // advanced settings button
             registerSetting(cat, settings.globed.autoconnect, "Advanced", "Advanced settings", Type::AdvancedSettings);
+            registerSetting(cat, settings.globed.autoconnect, "Benchmarks", "Runs the networking and interpolation benchmarks, results are written to the log.", Type::Benchmarks);
 #endif
         } break;
 
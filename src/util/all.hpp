@@ -4,6 +4,7 @@
 
 #include "cocos.hpp"
 #include "collections.hpp"
+#include "compress.hpp"
 #include "crypto.hpp"
 #include "data.hpp"
 #include "debug.hpp"
@@ -0,0 +1,62 @@
+#include "compress.hpp"
+
+#include <lz4.h>
+#include <cstring>
+
+#include <defs/assert.hpp>
+
+using namespace util::data;
+
+namespace util::compress {
+
+constexpr static size_t SIZE_PREFIX = sizeof(uint32_t);
+
+void compress(const byte* src, size_t size, bytevector& out) {
+    GLOBED_REQUIRE(size <= MAX_DECOMPRESSED_SIZE, "attempting to compress too much data")
+
+    size_t start = out.size();
+    size_t blockStart = start + SIZE_PREFIX;
+
+    out.resize(blockStart + LZ4_compressBound(size));
+
+    uint32_t beSize = maybeByteswap(static_cast<uint32_t>(size));
+    std::memcpy(out.data() + start, &beSize, SIZE_PREFIX);
+
+    int written = LZ4_compress_default(
+        reinterpret_cast<const char*>(src),
+        reinterpret_cast<char*>(out.data() + blockStart),
+        size,
+        out.size() - blockStart
+    );
+
+    GLOBED_REQUIRE(written > 0, "LZ4_compress_default failed")
+
+    out.resize(blockStart + written);
+}
+
+Result<size_t> decompress(const byte* src, size_t size, bytevector& out) {
+    GLOBED_REQUIRE_SAFE(size >= SIZE_PREFIX, "compressed data is too short")
+
+    uint32_t decompressedSize;
+    std::memcpy(&decompressedSize, src, SIZE_PREFIX);
+    decompressedSize = maybeByteswap(decompressedSize);
+
+    GLOBED_REQUIRE_SAFE(decompressedSize <= MAX_DECOMPRESSED_SIZE, "compressed data is too big")
+
+    if (out.size() < decompressedSize) {
+        out.resize(decompressedSize);
+    }
+
+    int written = LZ4_decompress_safe(
+        reinterpret_cast<const char*>(src + SIZE_PREFIX),
+        reinterpret_cast<char*>(out.data()),
+        size - SIZE_PREFIX,
+        decompressedSize
+    );
+
+    GLOBED_REQUIRE_SAFE(written >= 0 && static_cast<size_t>(written) == decompressedSize, "LZ4_decompress_safe failed, the data is malformed")
+
+    return Ok(decompressedSize);
+}
+
+}
@@ -0,0 +1,15 @@
+#pragma once
+#include <defs/minimal_geode.hpp>
+#include <util/data.hpp>
+
+namespace util::compress {
+    // Data that claims to decompress into more than this is rejected, must match `MAX_DECOMPRESSED_SIZE` on the server
+    constexpr size_t MAX_DECOMPRESSED_SIZE = 2 << 20;
+
+    // Compress `size` bytes from `src` with LZ4 and append them to `out`, prefixed with the uncompressed size (u32, big endian)
+    void compress(const data::byte* src, size_t size, data::bytevector& out);
+
+    // Decompress data made by `compress` into `out`. `out` is only ever grown, so that it can be reused for multiple calls.
+    // Returns the length of the decompressed data.
+    Result<size_t> decompress(const data::byte* src, size_t size, data::bytevector& out);
+}
@@ -45,6 +45,29 @@ namespace util::debug {
         log::debug("{} took {} to run", identifier, util::format::formatDuration(took));
     }
 
+    LatencyRecorder::LatencyRecorder(const std::string_view name, size_t reportEvery) : name(name), reportEvery(reportEvery) {}
+
+    void LatencyRecorder::record(time::micros sample) {
+        count++;
+        total += sample;
+        max = std::max(max, sample);
+
+        if (count >= reportEvery) {
+            log::debug(
+                "[{}] {} samples, avg: {}, max: {}",
+                name, count, util::format::formatDuration(total / count), util::format::formatDuration(max)
+            );
+
+            this->reset();
+        }
+    }
+
+    void LatencyRecorder::reset() {
+        count = 0;
+        total = time::micros{0};
+        max = time::micros{0};
+    }
+
     std::vector<size_t> DataWatcher::updateLastData(DataWatcher::WatcherEntry& entry) {
         std::vector<size_t> changedBytes;
 
@@ -22,6 +22,21 @@ namespace util::debug {
         std::unordered_map<std::string, time::time_point> _entries;
     };
 
+    // Collects duration samples and periodically logs a summary of them
+    class LatencyRecorder {
+    public:
+        LatencyRecorder(const std::string_view name, size_t reportEvery = 1000);
+
+        void record(time::micros sample);
+        void reset();
+
+    private:
+        std::string name;
+        size_t reportEvery;
+        size_t count = 0;
+        time::micros total{0}, max{0};
+    };
+
     class DataWatcher : public SingletonBase<DataWatcher> {
     public:
         struct WatcherEntry {
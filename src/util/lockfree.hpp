@@ -0,0 +1,153 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <optional>
+#include <type_traits>
+
+namespace util::lockfree {
+
+// separates atomics written by different threads, so that they don't bounce the same cache line around
+inline constexpr size_t CACHE_LINE_SIZE = 64;
+
+/*
+* SpscQueue - bounded ring queue for exactly one producer thread and one consumer thread.
+*
+* Each side only ever writes its own index, and caches the other side's one so that it rarely has to be loaded.
+* Capacity must be a power of two, `tryPush` fails instead of blocking when the queue is full.
+*/
+template <typename T, size_t Capacity>
+requires (Capacity >= 2 && (Capacity & (Capacity - 1)) == 0 && std::is_default_constructible_v<T> && std::is_move_assignable_v<T>)
+class SpscQueue {
+public:
+    SpscQueue() = default;
+    SpscQueue(const SpscQueue&) = delete;
+    SpscQueue& operator=(const SpscQueue&) = delete;
+
+    // Producer only. Returns false (and leaves `value` untouched) if the queue is full.
+    bool tryPush(T&& value) {
+        size_t head = this->head.load(std::memory_order_relaxed);
+
+        if (head - cachedTail >= Capacity) {
+            cachedTail = this->tail.load(std::memory_order_acquire);
+            if (head - cachedTail >= Capacity) return false;
+        }
+
+        slots[head & MASK] = std::move(value);
+        this->head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer only.
+    std::optional<T> tryPop() {
+        size_t tail = this->tail.load(std::memory_order_relaxed);
+
+        if (tail == cachedHead) {
+            cachedHead = this->head.load(std::memory_order_acquire);
+            if (tail == cachedHead) return std::nullopt;
+        }
+
+        std::optional<T> out = std::move(slots[tail & MASK]);
+        // don't keep the moved-from value (i.e. a packet) alive until the slot gets overwritten
+        slots[tail & MASK] = T{};
+        this->tail.store(tail + 1, std::memory_order_release);
+        return out;
+    }
+
+    // Approximate if called while the other thread is active.
+    size_t size() const {
+        return this->head.load(std::memory_order_acquire) - this->tail.load(std::memory_order_acquire);
+    }
+
+    static constexpr size_t capacity() {
+        return Capacity;
+    }
+
+private:
+    static constexpr size_t MASK = Capacity - 1;
+
+    alignas(CACHE_LINE_SIZE) std::atomic<size_t> head = 0;
+    size_t cachedTail = 0; // producer's view of `tail`
+    alignas(CACHE_LINE_SIZE) std::atomic<size_t> tail = 0;
+    size_t cachedHead = 0; // consumer's view of `head`
+    alignas(CACHE_LINE_SIZE) std::array<T, Capacity> slots{};
+};
+
+/*
+* MpscQueue - bounded ring queue for any number of producer threads and one consumer thread.
+*
+* Every slot carries a sequence number (Dmitry Vyukov's bounded queue), producers claim a slot with a CAS on the head
+* and publish it by bumping its sequence, so they never wait on each other except to retry a lost CAS.
+* Capacity must be a power of two, `tryPush` fails instead of blocking when the queue is full.
+*/
+template <typename T, size_t Capacity>
+requires (Capacity >= 2 && (Capacity & (Capacity - 1)) == 0 && std::is_default_constructible_v<T> && std::is_move_assignable_v<T>)
+class MpscQueue {
+public:
+    MpscQueue() {
+        for (size_t i = 0; i < Capacity; i++) {
+            slots[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    MpscQueue(const MpscQueue&) = delete;
+    MpscQueue& operator=(const MpscQueue&) = delete;
+
+    // Any thread. Returns false (and leaves `value` untouched) if the queue is full.
+    bool tryPush(T&& value) {
+        size_t pos = head.load(std::memory_order_relaxed);
+
+        while (true) {
+            auto& slot = slots[pos & MASK];
+            size_t seq = slot.sequence.load(std::memory_order_acquire);
+            auto diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+
+            if (diff == 0) {
+                if (head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    slot.value = std::move(value);
+                    slot.sequence.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                // the consumer hasn't freed this slot yet
+                return false;
+            } else {
+                pos = head.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // Consumer only.
+    std::optional<T> tryPop() {
+        auto& slot = slots[tail & MASK];
+        size_t seq = slot.sequence.load(std::memory_order_acquire);
+
+        // empty, or a producer claimed the slot but is still writing to it
+        if (seq != tail + 1) return std::nullopt;
+
+        std::optional<T> out = std::move(slot.value);
+        slot.value = T{};
+        slot.sequence.store(tail + Capacity, std::memory_order_release);
+        tail++;
+
+        return out;
+    }
+
+    static constexpr size_t capacity() {
+        return Capacity;
+    }
+
+private:
+    static constexpr size_t MASK = Capacity - 1;
+
+    struct Slot {
+        std::atomic<size_t> sequence;
+        T value{};
+    };
+
+    alignas(CACHE_LINE_SIZE) std::atomic<size_t> head = 0;
+    alignas(CACHE_LINE_SIZE) size_t tail = 0;
+    std::array<Slot, Capacity> slots;
+};
+
+}
@@ -8,12 +8,6 @@
 #include <util/crypto.hpp>
 
 namespace util::misc {
-    bool swapFlag(bool& target) {
-        bool state = target;
-        target = false;
-        return state;
-    }
-
     void callOnce(const char* key, std::function<void()> func) {
         static std::unordered_set<const char*> called;
 
@@ -36,15 +30,6 @@ namespace util::misc {
         return simd::calcPcmVolume(pcm, samples);
     }
 
-    float pcmVolumeSlow(const float* pcm, size_t samples) {
-        double sum = 0.0f;
-        for (size_t i = 0; i < samples; i++) {
-            sum += static_cast<double>(std::abs(pcm[i]));
-        }
-
-        return static_cast<float>(sum / static_cast<double>(samples));
-    }
-
     bool compareName(const std::string_view nv1, const std::string_view nv2) {
         std::string name1(nv1);
         std::string name2(nv2);
@@ -2,6 +2,7 @@
 #include <defs/essential.hpp>
 #include <defs/geode.hpp>
 #include <data/types/basic/either.hpp>
+#include <util/simd.hpp>
 
 #include <functional>
 #include <string_view>
@@ -46,7 +47,11 @@ namespace util::misc {
     struct is_either<Either<T, Y>> : std::true_type {};
 
     // If `target` is false, returns false. If `target` is true, modifies `target` to false and returns true.
-    bool swapFlag(bool& target);
+    inline bool swapFlag(bool& target) {
+        bool state = target;
+        target = false;
+        return state;
+    }
 
     // Like `swapFlag` but for optional types
     template <typename T>
@@ -79,6 +84,8 @@ namespace util::misc {
 
     float pcmVolumeSlow(const float* pcm, size_t samples);
 
+    void lerpTransformsSlow(const simd::TransformLanes& lanes);
+
     bool compareName(const std::string_view name1, const std::string_view name2);
 
     bool isEditorCollabLevel(LevelId levelId);
@@ -0,0 +1,34 @@
+#include "simd.hpp"
+#include "misc.hpp"
+
+#include <cmath>
+
+// Scalar versions of the simd kernels, used for the elements that don't fill a whole vector and by the host tools.
+// Kept out of misc.cpp so that they can be built without the rest of the mod.
+
+namespace util::misc {
+    float pcmVolumeSlow(const float* pcm, size_t samples) {
+        double sum = 0.0f;
+        for (size_t i = 0; i < samples; i++) {
+            sum += static_cast<double>(std::abs(pcm[i]));
+        }
+
+        return static_cast<float>(sum / static_cast<double>(samples));
+    }
+
+    void lerpTransformsSlow(const simd::TransformLanes& lanes) {
+        for (size_t i = 0; i < lanes.count; i++) {
+            float r = lanes.ratio[i];
+
+            lanes.outX[i] = lanes.olderX[i] + (lanes.newerX[i] - lanes.olderX[i]) * r;
+
+            if (lanes.spider[i] != 0.f && std::abs(lanes.newerY[i] - lanes.olderY[i]) >= 33.f) {
+                lanes.outY[i] = lanes.olderY[i];
+            } else {
+                lanes.outY[i] = lanes.olderY[i] + (lanes.newerY[i] - lanes.olderY[i]) * r;
+            }
+
+            lanes.outRotation[i] = lanes.olderRotation[i] + (lanes.newerRotation[i] - lanes.olderRotation[i]) * r;
+        }
+    }
+}
@@ -5,5 +5,19 @@
 namespace util::simd {
     float calcPcmVolume(const float* pcm, size_t samples);
 
+    // Structure of arrays input for `lerpTransforms`, every array has `count` elements
+    struct TransformLanes {
+        const float *olderX, *olderY, *olderRotation;
+        const float *newerX, *newerY, *newerRotation;
+        const float* ratio;
+        // nonzero for spiders, which keep the older y when the two positions are 33 units or more apart vertically (gravity flip)
+        const float* spider;
+        float *outX, *outY, *outRotation;
+        size_t count;
+    };
+
+    // Lerp positions and rotations of many icons at once
+    void lerpTransforms(const TransformLanes& lanes);
+
     uint32_t adler32(const uint8_t* data, size_t len);
 }
\ No newline at end of file
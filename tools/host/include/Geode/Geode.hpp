@@ -0,0 +1,26 @@
+#pragma once
+
+#include <cocos2d.h>
+#include "utils/Result.hpp"
+#include "loader/Log.hpp"
+#include "loader/Mod.hpp"
+
+namespace geode {
+    template <typename T>
+    class Ref;
+
+    namespace cocos {
+        template <typename T>
+        class CCArrayExt;
+    }
+
+    namespace cast {
+        template <typename T, typename U>
+        T typeinfo_cast(U);
+    }
+
+    namespace prelude {
+        using namespace ::geode;
+        using namespace ::cocos2d;
+    }
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstdio>
+#include <fmt/format.h>
+#include <fmt/std.h>
+
+// Logging goes straight to stderr in host builds
+
+namespace geode::log {
+    namespace impl {
+        template <typename... Args>
+        void log(const char* level, fmt::format_string<Args...> str, Args&&... args) {
+            fmt::print(stderr, "[{}] {}\n", level, fmt::format(str, std::forward<Args>(args)...));
+        }
+    }
+
+    template <typename... Args>
+    void debug(fmt::format_string<Args...> str, Args&&... args) {
+        impl::log("DEBUG", str, std::forward<Args>(args)...);
+    }
+
+    template <typename... Args>
+    void info(fmt::format_string<Args...> str, Args&&... args) {
+        impl::log("INFO", str, std::forward<Args>(args)...);
+    }
+
+    template <typename... Args>
+    void warn(fmt::format_string<Args...> str, Args&&... args) {
+        impl::log("WARN", str, std::forward<Args>(args)...);
+    }
+
+    template <typename... Args>
+    void error(fmt::format_string<Args...> str, Args&&... args) {
+        impl::log("ERROR", str, std::forward<Args>(args)...);
+    }
+}
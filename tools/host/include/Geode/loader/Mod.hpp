@@ -0,0 +1,9 @@
+#pragma once
+
+// Only declared, anything that needs a loaded mod can't be used in host builds
+
+namespace geode {
+    class Mod;
+    class Patch;
+    class Loader;
+}
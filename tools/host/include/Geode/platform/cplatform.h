@@ -0,0 +1,6 @@
+#pragma once
+
+// None of the GEODE_IS_* platform macros are defined in host builds, see GLOBED_HOST_BUILD in defs/platform.hpp
+
+#define GEODE_CONCAT_(x, y) x##y
+#define GEODE_CONCAT(x, y) GEODE_CONCAT_(x, y)
@@ -0,0 +1,115 @@
+#pragma once
+
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <variant>
+
+#include "../platform/cplatform.h"
+
+// The part of Geode's Result that is used by the code shared with the host tools
+
+namespace geode {
+    namespace impl {
+        template <typename T>
+        struct OkValue {
+            T value;
+        };
+
+        template <>
+        struct OkValue<void> {};
+
+        template <typename E>
+        struct ErrValue {
+            E value;
+        };
+    }
+
+    template <typename T>
+    impl::OkValue<std::decay_t<T>> Ok(T&& value) {
+        return {std::forward<T>(value)};
+    }
+
+    inline impl::OkValue<void> Ok() {
+        return {};
+    }
+
+    template <typename E>
+    impl::ErrValue<std::decay_t<E>> Err(E&& value) {
+        return {std::forward<E>(value)};
+    }
+
+    template <typename T = void, typename E = std::string>
+    class [[nodiscard]] Result {
+        using Stored = std::conditional_t<std::is_void_v<T>, std::monostate, T>;
+
+    public:
+        Result(impl::OkValue<void>&&) requires (std::is_void_v<T> || std::is_default_constructible_v<T>) : value(std::in_place_index<0>) {}
+
+        template <typename U> requires (!std::is_void_v<T> && std::is_constructible_v<Stored, U&&>)
+        Result(impl::OkValue<U>&& ok) : value(std::in_place_index<0>, std::move(ok.value)) {}
+
+        template <typename U> requires std::is_constructible_v<E, U&&>
+        Result(impl::ErrValue<U>&& err) : value(std::in_place_index<1>, std::move(err.value)) {}
+
+        bool isOk() const { return value.index() == 0; }
+        bool isErr() const { return value.index() == 1; }
+        explicit operator bool() const { return this->isOk(); }
+
+        decltype(auto) unwrap() & {
+            this->ensure(true);
+            if constexpr (!std::is_void_v<T>) return std::get<0>(value);
+        }
+
+        decltype(auto) unwrap() const& {
+            this->ensure(true);
+            if constexpr (!std::is_void_v<T>) return std::get<0>(value);
+        }
+
+        decltype(auto) unwrap() && {
+            this->ensure(true);
+            if constexpr (!std::is_void_v<T>) return Stored(std::move(std::get<0>(value)));
+        }
+
+        E& unwrapErr() & {
+            this->ensure(false);
+            return std::get<1>(value);
+        }
+
+        const E& unwrapErr() const& {
+            this->ensure(false);
+            return std::get<1>(value);
+        }
+
+        E unwrapErr() && {
+            this->ensure(false);
+            return std::move(std::get<1>(value));
+        }
+
+        template <typename U = T> requires (!std::is_void_v<U>)
+        U unwrapOr(U fallback) const {
+            return this->isOk() ? std::get<0>(value) : std::move(fallback);
+        }
+
+        std::optional<Stored> ok() const {
+            if (this->isOk()) return std::get<0>(value);
+            return std::nullopt;
+        }
+
+        std::optional<E> err() const {
+            if (this->isErr()) return std::get<1>(value);
+            return std::nullopt;
+        }
+
+    private:
+        std::variant<Stored, E> value;
+
+        void ensure(bool ok) const {
+            if (this->isOk() != ok) {
+                throw std::runtime_error(ok ? "called unwrap on an Err result" : "called unwrapErr on an Ok result");
+            }
+        }
+    };
+}
@@ -0,0 +1,20 @@
+#pragma once
+
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "Result.hpp"
+
+namespace geode::utils::file {
+    inline Result<std::vector<uint8_t>> readBinary(const std::filesystem::path& path) {
+        std::ifstream file(path, std::ios::in | std::ios::binary);
+        if (!file) {
+            return Err("Unable to open file");
+        }
+
+        return Ok(std::vector<uint8_t>(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()));
+    }
+}
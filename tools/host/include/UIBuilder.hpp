@@ -0,0 +1,3 @@
+#pragma once
+
+// UI code is not built for the host, this only satisfies the include in defs/geode.hpp
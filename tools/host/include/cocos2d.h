@@ -0,0 +1,78 @@
+#pragma once
+
+// The few cocos2d value types that the data structures shared with the mod use.
+// Member names and operators match cocos2d-x, anything else from cocos is not available in host builds.
+
+#include <cmath>
+#include <stdint.h>
+
+namespace cocos2d {
+    class CCPoint {
+    public:
+        float x = 0.f, y = 0.f;
+
+        constexpr CCPoint() = default;
+        constexpr CCPoint(float x, float y) : x(x), y(y) {}
+
+        constexpr CCPoint operator+(const CCPoint& other) const { return CCPoint(x + other.x, y + other.y); }
+        constexpr CCPoint operator-(const CCPoint& other) const { return CCPoint(x - other.x, y - other.y); }
+        constexpr CCPoint operator-() const { return CCPoint(-x, -y); }
+        constexpr CCPoint operator*(float a) const { return CCPoint(x * a, y * a); }
+        constexpr CCPoint operator/(float a) const { return CCPoint(x / a, y / a); }
+
+        CCPoint& operator+=(const CCPoint& other) { x += other.x; y += other.y; return *this; }
+        CCPoint& operator-=(const CCPoint& other) { x -= other.x; y -= other.y; return *this; }
+        CCPoint& operator*=(float a) { x *= a; y *= a; return *this; }
+        CCPoint& operator/=(float a) { x /= a; y /= a; return *this; }
+
+        constexpr bool operator==(const CCPoint& other) const { return x == other.x && y == other.y; }
+
+        float getLength() const { return std::sqrt(x * x + y * y); }
+        float getDistance(const CCPoint& other) const { return (*this - other).getLength(); }
+        CCPoint lerp(const CCPoint& other, float alpha) const { return *this * (1.f - alpha) + other * alpha; }
+    };
+
+    class CCSize {
+    public:
+        float width = 0.f, height = 0.f;
+
+        constexpr CCSize() = default;
+        constexpr CCSize(float width, float height) : width(width), height(height) {}
+
+        constexpr bool operator==(const CCSize& other) const { return width == other.width && height == other.height; }
+    };
+
+    class CCRect {
+    public:
+        CCPoint origin;
+        CCSize size;
+
+        constexpr CCRect() = default;
+        constexpr CCRect(float x, float y, float width, float height) : origin(x, y), size(width, height) {}
+
+        float getMinX() const { return origin.x; }
+        float getMaxX() const { return origin.x + size.width; }
+        float getMinY() const { return origin.y; }
+        float getMaxY() const { return origin.y + size.height; }
+
+        bool intersectsRect(const CCRect& rect) const {
+            return !(getMaxX() < rect.getMinX() || rect.getMaxX() < getMinX() || getMaxY() < rect.getMinY() || rect.getMaxY() < getMinY());
+        }
+    };
+
+    struct ccColor3B {
+        uint8_t r, g, b;
+    };
+
+    struct ccColor4B {
+        uint8_t r, g, b, a;
+    };
+
+    constexpr ccColor3B ccc3(uint8_t r, uint8_t g, uint8_t b) {
+        return ccColor3B{r, g, b};
+    }
+
+    constexpr ccColor4B ccc4(uint8_t r, uint8_t g, uint8_t b, uint8_t a) {
+        return ccColor4B{r, g, b, a};
+    }
+}
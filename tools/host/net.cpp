@@ -0,0 +1,23 @@
+#include <util/net.hpp>
+
+#include <cerrno>
+#include <cstring>
+#include <netdb.h>
+
+// the unix parts of util/net, for the host tools (only unix hosts are supported)
+
+void util::net::initialize() {}
+void util::net::cleanup() {}
+
+int util::net::lastErrorCode() {
+    return errno;
+}
+
+std::string util::net::lastErrorString(bool gai) {
+    return lastErrorString(lastErrorCode(), gai);
+}
+
+std::string util::net::lastErrorString(int code, bool gai) {
+    if (gai) return fmt::format("[Unix gai error {}]: {}", code, gai_strerror(code));
+    return fmt::format("[Unix error {}]: {}", code, strerror(code));
+}
@@ -0,0 +1,12 @@
+#include <util/simd.hpp>
+#include <util/misc.hpp>
+
+// host builds don't pick an instruction set at runtime, the scalar kernels give the same results
+
+float util::simd::calcPcmVolume(const float* pcm, size_t samples) {
+    return util::misc::pcmVolumeSlow(pcm, samples);
+}
+
+void util::simd::lerpTransforms(const util::simd::TransformLanes& lanes) {
+    util::misc::lerpTransformsSlow(lanes);
+}
@@ -0,0 +1,130 @@
+#include "lerp_replay.hpp"
+
+#include <util/time.hpp>
+
+using namespace geode::prelude;
+
+// kept apart from real account IDs, as the replay also goes through `LerpLogger`
+static constexpr int REPLAY_PLAYER_ID = -1;
+
+// Position of the player at `time`, from frames sorted by their timestamp. Empty if `time` is outside of the recording.
+static std::optional<CCPoint> groundTruth(const std::vector<PlayerLogData>& frames, float time) {
+    if (frames.empty() || time < frames.front().timestamp || time > frames.back().timestamp) {
+        return std::nullopt;
+    }
+
+    auto it = std::upper_bound(frames.begin(), frames.end(), time, [](float time, const PlayerLogData& frame) {
+        return time < frame.timestamp;
+    });
+
+    if (it == frames.end()) {
+        return frames.back().position;
+    }
+
+    const auto& newer = *it;
+    const auto& older = *(it - 1);
+
+    float ratio = (time - older.timestamp) / (newer.timestamp - older.timestamp);
+    return older.position + (newer.position - older.position) * ratio;
+}
+
+LerpReplayResult replayLerpLog(const PlayerLog& log, const InterpolatorSettings& settings, float tickDelta) {
+    LerpReplayResult result{};
+
+    if (log.realFrames.empty() || tickDelta <= 0.f) {
+        return result;
+    }
+
+    auto arrivals = log.realFrames;
+    std::stable_sort(arrivals.begin(), arrivals.end(), [](const auto& a, const auto& b) {
+        return a.localTimestamp < b.localTimestamp;
+    });
+
+    auto truth = log.realFrames;
+    std::stable_sort(truth.begin(), truth.end(), [](const auto& a, const auto& b) {
+        return a.timestamp < b.timestamp;
+    });
+
+    // the fastest transit is the best latency possible, anything above it was added by the network or by buffering
+    float minTransit = std::numeric_limits<float>::max();
+    for (const auto& frame : arrivals) {
+        minTransit = std::min(minTransit, frame.localTimestamp - frame.timestamp);
+    }
+
+    PlayerInterpolator interpolator(settings);
+    interpolator.addPlayer(REPLAY_PLAYER_ID);
+
+    PlayerData data{};
+    data.player1.iconType = PlayerIconType::Cube;
+    data.player1.isVisible = true;
+    data.player2 = data.player1;
+
+    // the interpolator's clock starts at zero, so arrival times are made relative to the first one
+    float startTime = arrivals.front().localTimestamp;
+    float endTime = arrivals.back().localTimestamp - startTime;
+    float time = 0.f;
+    float newestDelivered = arrivals.front().timestamp;
+    size_t next = 0;
+
+    std::vector<float> errors;
+    errors.reserve(static_cast<size_t>(endTime / tickDelta) + 1);
+
+    double totalLatency = 0.0;
+    util::time::nanos tickTime{0};
+
+    while (time <= endTime) {
+        for (; next < arrivals.size() && arrivals[next].localTimestamp - startTime <= time; next++) {
+            const auto& frame = arrivals[next];
+
+            data.timestamp = frame.timestamp;
+            data.player1.position = frame.position;
+            data.player1.rotation = frame.rotation;
+            newestDelivered = std::max(newestDelivered, frame.timestamp);
+
+            interpolator.updatePlayer(REPLAY_PLAYER_ID, data, time);
+        }
+
+        auto tickStart = util::time::now();
+        interpolator.tick(tickDelta);
+        tickTime += util::time::as<util::time::nanos>(util::time::now() - tickStart);
+
+        time += tickDelta;
+        result.ticks++;
+
+        // in realtime mode the newest frame is shown as is
+        float shownTime = settings.realtime ? newestDelivered : interpolator.getJitterStats(REPLAY_PLAYER_ID).playbackTime;
+
+        auto real = groundTruth(truth, shownTime);
+        if (!real) continue;
+
+        const auto& shown = interpolator.getPlayerState(REPLAY_PLAYER_ID).player1;
+        errors.push_back((shown.position - *real).getLength());
+
+        float latency = (time + startTime - minTransit) - shownTime;
+        totalLatency += latency;
+        result.maxLatency = std::max(result.maxLatency, latency);
+    }
+
+    result.samples = errors.size();
+    result.nanosPerTick = static_cast<double>(tickTime.count()) / result.ticks;
+    result.jitterStats = interpolator.getJitterStats(REPLAY_PLAYER_ID);
+
+    if (errors.empty()) {
+        return result;
+    }
+
+    double totalError = 0.0;
+    for (float error : errors) {
+        totalError += error;
+        result.maxError = std::max(result.maxError, error);
+    }
+
+    result.meanError = static_cast<float>(totalError / errors.size());
+    result.meanLatency = static_cast<float>(totalLatency / errors.size());
+
+    auto p95 = errors.begin() + (errors.size() - 1) * 95 / 100;
+    std::nth_element(errors.begin(), p95, errors.end());
+    result.p95Error = *p95;
+
+    return result;
+}
@@ -0,0 +1,20 @@
+#pragma once
+#include <game/interpolator.hpp>
+#include <game/lerp_logger.hpp>
+
+struct LerpReplayResult {
+    size_t ticks;        // ticks that were simulated
+    size_t samples;      // ticks that could be compared against the real frames
+    float meanError;     // distance between the shown and the real position at the shown time, in units
+    float p95Error;
+    float maxError;
+    float meanLatency;   // how far the shown time is behind the newest time that could have arrived, in seconds
+    float maxLatency;
+    double nanosPerTick; // CPU time spent in `PlayerInterpolator::tick`
+    PlayerInterpolator::JitterStats jitterStats; // at the end of the replay
+};
+
+// Replays the real frames of a `PlayerLog` through a fresh `PlayerInterpolator`. Frames are delivered at their original
+// arrival times (`localTimestamp`) and the interpolator is ticked every `tickDelta` seconds, without needing a level.
+// The shown positions are then scored against the real frames, linearly interpolated between each other.
+LerpReplayResult replayLerpLog(const PlayerLog& log, const InterpolatorSettings& settings, float tickDelta);
@@ -0,0 +1,72 @@
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+
+#include "lerp_replay.hpp"
+
+// Replays an interpolation dump (`lerp-dump.bin` in the mod save directory, written with GLOBED_DEBUG_INTERPOLATION enabled)
+// through the interpolator with a few different settings, and prints how far the shown positions were from the real ones.
+//
+// usage: lerp_replay <dump file> [tick rate, default 240]
+
+int main(int argc, const char** argv) {
+    if (argc < 2) {
+        fmt::print(stderr, "usage: {} <dump file> [tick rate]\n", argv[0]);
+        return 1;
+    }
+
+    float tickRate = 240.f;
+    if (argc >= 3) {
+        const char* end = argv[2] + std::strlen(argv[2]);
+        auto [ptr, ec] = std::from_chars(argv[2], end, tickRate);
+
+        if (ec != std::errc{} || ptr != end || tickRate <= 0.f) {
+            fmt::print(stderr, "invalid tick rate: {}\n", argv[2]);
+            return 1;
+        }
+    }
+
+    auto dumpR = LerpLogger::loadDump(argv[1]);
+    if (!dumpR) {
+        fmt::print(stderr, "failed to load interpolation dump from {}: {}\n", argv[1], dumpR.unwrapErr());
+        return 1;
+    }
+
+    auto dump = std::move(dumpR.unwrap());
+
+    std::pair<const char*, InterpolatorSettings> configs[] = {
+        {"realtime", {.realtime = true, .isPlatformer = false, .extrapolate = false, .expectedDelta = 1.f / 30.f}},
+        {"buffered", {.realtime = false, .isPlatformer = false, .extrapolate = false, .expectedDelta = 1.f / 30.f}},
+        {"extrapolated", {.realtime = false, .isPlatformer = false, .extrapolate = true, .expectedDelta = 1.f / 30.f}},
+    };
+
+    fmt::print(
+        "{:>10} {:>13} {:>7} {:>10} {:>10} {:>10} {:>13} {:>13} {:>9} {:>9} {:>6}\n",
+        "player", "config", "frames", "mean err", "p95 err", "max err", "mean latency", "max latency", "ns/tick", "underruns", "late"
+    );
+
+    std::vector<uint32_t> playerIds;
+    for (const auto& [playerId, _] : dump) {
+        playerIds.push_back(playerId);
+    }
+
+    std::sort(playerIds.begin(), playerIds.end());
+
+    for (uint32_t playerId : playerIds) {
+        const auto& plog = dump.at(playerId);
+
+        for (const auto& [name, settings] : configs) {
+            auto result = replayLerpLog(plog, settings, 1.f / tickRate);
+
+            fmt::print(
+                "{:>10} {:>13} {:>7} {:>10.3f} {:>10.3f} {:>10.3f} {:>11.2f}ms {:>11.2f}ms {:>9.0f} {:>9} {:>6}\n",
+                playerId, name, plog.realFrames.size(),
+                result.meanError, result.p95Error, result.maxError,
+                result.meanLatency * 1000.f, result.maxLatency * 1000.f, result.nanosPerTick,
+                result.jitterStats.underruns, result.jitterStats.lateFrames
+            );
+        }
+    }
+
+    return 0;
+}
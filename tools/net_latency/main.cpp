@@ -0,0 +1,262 @@
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <asp/sync.hpp>
+#include <net/wakeup_handle.hpp>
+#include <util/net.hpp>
+#include <util/time.hpp>
+
+// Measures how long an outgoing packet waits between being queued (`NetworkManager::send`) and being handed to `send`,
+// for the two network thread designs:
+//
+// baseline - the network thread blocks on the task queue with `popTimeout(50ms)` and yields in between,
+//            a second thread polls the socket for incoming data with a 100ms timeout.
+// reactor  - a single thread polls the socket and a `WakeupHandle` at once, `send` signals the handle after queueing.
+//
+// Packets go to a loopback UDP socket. The cost of the wakeup is what's being measured, so packets are spaced out
+// and the network thread is idle (blocked) whenever a new one is queued, like it is in game.
+//
+// usage: net_latency [packets, default 2000] [interval in microseconds, default 4166 (240 per second)]
+
+using util::time::micros;
+
+namespace {
+
+constexpr int BASELINE_QUEUE_TIMEOUT_MS = 50;
+constexpr int BASELINE_RECV_TIMEOUT_MS = 100;
+constexpr int REACTOR_IDLE_TIMEOUT_MS = 250;
+constexpr auto IDLE_WINDOW = util::time::seconds(2);
+
+struct Task {
+    uint32_t index;
+    util::time::time_point enqueuedAt;
+};
+
+struct Sockets {
+    int receiver = -1;
+    int sender = -1;
+
+    Sockets() {
+        sockaddr_in addr = {};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        addr.sin_port = 0;
+        socklen_t addrLen = sizeof(addr);
+
+        receiver = ::socket(AF_INET, SOCK_DGRAM, 0);
+        sender = ::socket(AF_INET, SOCK_DGRAM, 0);
+
+        bool ok = receiver != -1 && sender != -1
+            && ::bind(receiver, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == 0
+            && ::getsockname(receiver, reinterpret_cast<sockaddr*>(&addr), &addrLen) == 0
+            && ::connect(sender, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == 0;
+
+        if (!ok) {
+            throw std::runtime_error("failed to set up loopback sockets: " + util::net::lastErrorString());
+        }
+    }
+
+    ~Sockets() {
+        ::close(receiver);
+        ::close(sender);
+    }
+
+    void send(const Task& task) {
+        uint8_t payload[64] = {};
+        std::memcpy(payload, &task.index, sizeof(task.index));
+        (void) ::send(sender, payload, sizeof(payload), 0);
+    }
+
+    void drain() {
+        uint8_t buf[256];
+        while (::recv(receiver, buf, sizeof(buf), MSG_DONTWAIT) > 0) {}
+    }
+};
+
+struct RunResult {
+    std::vector<micros> latencies;
+    // CPU time used by the whole process and loop iterations of the network thread(s), while nothing was being sent
+    double idleCpuPercent;
+    size_t idleWakeupsPerSecond;
+};
+
+double processCpuSeconds() {
+    timespec ts;
+    ::clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// Queue `count` packets `interval` apart from this thread, then stay idle for a while to measure the idle cost.
+// `push` queues a task, the network thread(s) must record the latency of every sent packet and count their loop iterations.
+template <typename Push>
+RunResult produce(size_t count, micros interval, Push&& push, std::vector<micros>& latencies, std::atomic_size_t& sent, std::atomic_size_t& iterations) {
+    auto next = util::time::now();
+
+    for (uint32_t i = 0; i < count; i++) {
+        next += interval;
+        std::this_thread::sleep_until(next);
+        push(Task { .index = i, .enqueuedAt = util::time::now() });
+    }
+
+    while (sent < count) {
+        std::this_thread::sleep_for(util::time::millis(1));
+    }
+
+    size_t iterationsBefore = iterations;
+    double cpuBefore = processCpuSeconds();
+    std::this_thread::sleep_for(IDLE_WINDOW);
+    double cpuUsed = processCpuSeconds() - cpuBefore;
+    size_t idleIterations = iterations - iterationsBefore;
+
+    double windowSecs = util::time::as<util::time::millis>(IDLE_WINDOW).count() / 1000.0;
+
+    return RunResult {
+        .latencies = std::move(latencies),
+        .idleCpuPercent = cpuUsed / windowSecs * 100.0,
+        .idleWakeupsPerSecond = static_cast<size_t>(idleIterations / windowSecs),
+    };
+}
+
+RunResult runBaseline(size_t count, micros interval) {
+    Sockets sockets;
+    asp::Channel<Task> queue;
+    std::vector<micros> latencies;
+    latencies.reserve(count);
+
+    std::atomic_bool stop = false;
+    std::atomic_size_t sent = 0, iterations = 0;
+
+    // the old "Network Thread (out)" loop
+    std::thread out([&] {
+        while (!stop) {
+            while (auto task = queue.popTimeout(util::time::millis(BASELINE_QUEUE_TIMEOUT_MS))) {
+                sockets.send(*task);
+                latencies.push_back(util::time::as<micros>(util::time::now() - task->enqueuedAt));
+                sent++;
+            }
+
+            iterations++;
+            std::this_thread::yield();
+        }
+    });
+
+    // the old "Network Thread (in)" loop
+    std::thread in([&] {
+        while (!stop) {
+            pollfd fd = { .fd = sockets.receiver, .events = POLLIN };
+            if (::poll(&fd, 1, BASELINE_RECV_TIMEOUT_MS) > 0) {
+                sockets.drain();
+            }
+
+            iterations++;
+        }
+    });
+
+    auto result = produce(count, interval, [&](Task&& task) {
+        queue.push(std::move(task));
+    }, latencies, sent, iterations);
+
+    stop = true;
+    out.join();
+    in.join();
+
+    return result;
+}
+
+RunResult runReactor(size_t count, micros interval) {
+    Sockets sockets;
+    WakeupHandle wakeup;
+    asp::Channel<Task> queue;
+    std::vector<micros> latencies;
+    latencies.reserve(count);
+
+    std::atomic_bool stop = false;
+    std::atomic_size_t sent = 0, iterations = 0;
+
+    // same order as `NetworkManager::Impl::threadMainFunc`: send everything queued, then wait for the socket or a wakeup
+    std::thread thread([&] {
+        while (!stop) {
+            while (auto task = queue.tryPop()) {
+                sockets.send(*task);
+                latencies.push_back(util::time::as<micros>(util::time::now() - task->enqueuedAt));
+                sent++;
+            }
+
+            pollfd fds[2] = {
+                { .fd = wakeup.pollHandle(), .events = POLLIN },
+                { .fd = sockets.receiver, .events = POLLIN },
+            };
+
+            if (::poll(fds, 2, REACTOR_IDLE_TIMEOUT_MS) > 0) {
+                if (fds[0].revents & POLLIN) wakeup.drain();
+                if (fds[1].revents & POLLIN) sockets.drain();
+            }
+
+            iterations++;
+        }
+    });
+
+    auto result = produce(count, interval, [&](Task&& task) {
+        queue.push(std::move(task));
+        wakeup.wake();
+    }, latencies, sent, iterations);
+
+    stop = true;
+    wakeup.wake();
+    thread.join();
+
+    return result;
+}
+
+void printResult(const char* name, RunResult& result) {
+    auto& lat = result.latencies;
+    std::sort(lat.begin(), lat.end());
+
+    auto percentile = [&](double p) {
+        return lat[std::min(lat.size() - 1, static_cast<size_t>(p * lat.size()))].count();
+    };
+
+    long long sum = 0;
+    for (auto l : lat) sum += l.count();
+
+    fmt::print(
+        "{:>9} {:>9.1f} {:>9} {:>9} {:>9} {:>11.2f}% {:>14}\n",
+        name, static_cast<double>(sum) / lat.size(), percentile(0.5), percentile(0.99), lat.back().count(),
+        result.idleCpuPercent, result.idleWakeupsPerSecond
+    );
+}
+
+}
+
+int main(int argc, const char** argv) {
+    size_t count = argc >= 2 ? std::strtoull(argv[1], nullptr, 10) : 2000;
+    micros interval{argc >= 3 ? std::strtoll(argv[2], nullptr, 10) : 4166};
+
+    if (count == 0 || interval.count() <= 0) {
+        fmt::print(stderr, "usage: {} [packets] [interval in microseconds]\n", argv[0]);
+        return 1;
+    }
+
+    fmt::print("{} packets, {}us apart, enqueue to send latency in microseconds\n", count, interval.count());
+    fmt::print("{:>9} {:>9} {:>9} {:>9} {:>9} {:>12} {:>14}\n", "design", "mean", "p50", "p99", "max", "idle cpu", "idle wakeups/s");
+
+    auto baseline = runBaseline(count, interval);
+    printResult("baseline", baseline);
+
+    auto reactor = runReactor(count, interval);
+    printResult("reactor", reactor);
+
+    return 0;
+}
@@ -0,0 +1,71 @@
+#include <cstdlib>
+
+#include <fmt/format.h>
+
+#include <game/interpolator.hpp>
+
+// Checks that the events of a snapshot are raised even if it arrives after playback ran past the newest snapshot
+// and got clamped back to it (an underrun following a long gap).
+
+namespace {
+
+constexpr int PLAYER_ID = 1;
+constexpr float TICK = 1.f / 240.f;
+
+int failures = 0;
+
+#define CHECK(cond) \
+    if (!(cond)) { \
+        fmt::print(stderr, "{}:{}: check failed: {}\n", __FILE__, __LINE__, #cond); \
+        failures++; \
+    }
+
+PlayerData snapshot(float timestamp, bool jumped) {
+    PlayerData data{};
+    data.timestamp = timestamp;
+    data.player1.isVisible = true;
+    data.player1.didJustJump = jumped;
+    return data;
+}
+
+void advance(PlayerInterpolator& interpolator, float seconds) {
+    for (float t = 0.f; t < seconds; t += TICK) {
+        interpolator.tick(TICK);
+    }
+}
+
+void eventsAfterUnderrun() {
+    PlayerInterpolator interpolator(InterpolatorSettings {
+        .realtime = false,
+        .isPlatformer = false,
+        .extrapolate = false,
+        .expectedDelta = 1.f / 30.f,
+    });
+
+    interpolator.addPlayer(PLAYER_ID);
+    interpolator.updatePlayer(PLAYER_ID, snapshot(0.f, false), 0.f);
+
+    // nothing arrives for a while, playback jumps ahead and gets clamped to the only snapshot
+    advance(interpolator, 1.f);
+    interpolator.swapFrameFlags(PLAYER_ID);
+
+    // a snapshot from within the gap, still ahead of the clamped playback
+    interpolator.updatePlayer(PLAYER_ID, snapshot(0.5f, true), 0.f);
+    advance(interpolator, 0.1f);
+
+    CHECK(interpolator.swapFrameFlags(PLAYER_ID).pendingP1Jump);
+}
+
+}
+
+int main() {
+    eventsAfterUnderrun();
+
+    if (failures) {
+        fmt::print(stderr, "{} checks failed\n", failures);
+        return EXIT_FAILURE;
+    }
+
+    fmt::print("all checks passed\n");
+    return EXIT_SUCCESS;
+}
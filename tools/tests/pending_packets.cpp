@@ -0,0 +1,170 @@
+#include <algorithm>
+#include <cstdlib>
+#include <vector>
+
+#include <fmt/format.h>
+
+#include <data/types/game.hpp>
+#include <net/pending_packets.hpp>
+
+// Checks how `PendingPacketQueue` treats level data: fragments of a tick and a few bunched ticks are all delivered,
+// and a backlog from a stalled main thread is collapsed without losing any player or event.
+
+namespace {
+
+// the same merging as `LevelDataPacket`, without the cocos types that its header pulls in
+class FakeLevelDataPacket : public Packet {
+public:
+    static constexpr packetid_t PACKET_ID = 22001;
+
+    void encode(ByteBuffer& buf) const override {}
+    ByteBuffer::DecodeResult<> decode(ByteBuffer& buf) override { return Ok(); }
+    size_t encodedSize() const override { return 0; }
+    packetid_t getPacketId() const override { return PACKET_ID; }
+    bool getUseTcp() const override { return false; }
+    bool getEncrypted() const override { return false; }
+    const char* getPacketName() const override { return "FakeLevelDataPacket"; }
+
+    bool getLatestWins() const override {
+        return true;
+    }
+
+    void mergeDropped(const Packet& older) override {
+        AssociatedPlayerData::mergeDropped(players, static_cast<const FakeLevelDataPacket&>(older).players);
+    }
+
+    std::vector<AssociatedPlayerData> players;
+};
+
+class FakeChatPacket : public Packet {
+public:
+    void encode(ByteBuffer& buf) const override {}
+    ByteBuffer::DecodeResult<> decode(ByteBuffer& buf) override { return Ok(); }
+    size_t encodedSize() const override { return 0; }
+    packetid_t getPacketId() const override { return 22010; }
+    bool getUseTcp() const override { return false; }
+    bool getEncrypted() const override { return false; }
+    const char* getPacketName() const override { return "FakeChatPacket"; }
+};
+
+int failures = 0;
+
+#define CHECK(cond) \
+    if (!(cond)) { \
+        fmt::print(stderr, "{}:{}: check failed: {}\n", __FILE__, __LINE__, #cond); \
+        failures++; \
+    }
+
+// one fragment of a tick, with the given players
+std::shared_ptr<FakeLevelDataPacket> fragment(float timestamp, std::vector<int> accountIds, bool jumped = false) {
+    auto packet = std::make_shared<FakeLevelDataPacket>();
+
+    for (int id : accountIds) {
+        PlayerData data{};
+        data.timestamp = timestamp;
+        data.player1.didJustJump = jumped;
+        packet->players.emplace_back(id, data);
+    }
+
+    return packet;
+}
+
+const AssociatedPlayerData* findPlayer(const FakeLevelDataPacket& packet, int accountId) {
+    auto it = std::find_if(packet.players.begin(), packet.players.end(), [&](const auto& p) { return p.accountId == accountId; });
+    return it == packet.players.end() ? nullptr : &*it;
+}
+
+std::vector<std::shared_ptr<Packet>> drain(PendingPacketQueue& queue) {
+    std::vector<std::shared_ptr<Packet>> out;
+
+    while (auto packet = queue.pop()) {
+        out.push_back(std::move(packet));
+    }
+
+    return out;
+}
+
+void fragmentedTick() {
+    PendingPacketQueue queue;
+    queue.push(fragment(1.f, {1, 2}));
+    queue.push(fragment(1.f, {3, 4}));
+
+    auto out = drain(queue);
+    CHECK(out.size() == 2);
+    if (out.size() != 2) return;
+
+    auto& first = static_cast<FakeLevelDataPacket&>(*out[0]);
+    auto& second = static_cast<FakeLevelDataPacket&>(*out[1]);
+    CHECK(findPlayer(first, 1) && findPlayer(first, 2));
+    CHECK(findPlayer(second, 3) && findPlayer(second, 4));
+}
+
+void bunchedTicks() {
+    PendingPacketQueue queue;
+
+    for (int tick = 0; tick < 5; tick++) {
+        queue.push(fragment(static_cast<float>(tick), {1}));
+        queue.push(fragment(static_cast<float>(tick), {2}));
+    }
+
+    auto out = drain(queue);
+    CHECK(out.size() == 10);
+
+    // in order, so the interpolator sees every tick
+    for (size_t i = 0; i < out.size(); i++) {
+        auto& packet = static_cast<FakeLevelDataPacket&>(*out[i]);
+        CHECK(packet.players.size() == 1 && packet.players[0].data.timestamp == static_cast<float>(i / 2));
+    }
+}
+
+void stalledMainThread() {
+    PendingPacketQueue queue;
+    size_t ticks = PendingPacketQueue::COALESCE_THRESHOLD / 2;
+
+    queue.push(std::make_shared<FakeChatPacket>());
+
+    for (size_t tick = 0; tick < ticks; tick++) {
+        float ts = static_cast<float>(tick);
+        // player 1 jumps in the first tick, player 3 stops being sent after it
+        queue.push(fragment(ts, tick == 0 ? std::vector{1, 3} : std::vector{1}, tick == 0));
+        queue.push(fragment(ts, {2}));
+    }
+
+    auto out = drain(queue);
+    CHECK(out.size() == 2);
+    if (out.size() != 2) return;
+
+    CHECK(out[0]->getPacketId() == 22010);
+
+    auto& merged = static_cast<FakeLevelDataPacket&>(*out[1]);
+    float last = static_cast<float>(ticks - 1);
+    CHECK(merged.players.size() == 3);
+
+    auto p1 = findPlayer(merged, 1);
+    auto p2 = findPlayer(merged, 2);
+    auto p3 = findPlayer(merged, 3);
+    CHECK(p1 && p1->data.timestamp == last && p1->data.player1.didJustJump);
+    CHECK(p2 && p2->data.timestamp == last);
+    CHECK(p3 && p3->data.timestamp == 0.f);
+
+    // the queue keeps working after a collapse
+    queue.push(fragment(100.f, {1}));
+    queue.push(fragment(100.f, {2}));
+    CHECK(drain(queue).size() == 2);
+}
+
+}
+
+int main() {
+    fragmentedTick();
+    bunchedTicks();
+    stalledMainThread();
+
+    if (failures) {
+        fmt::print(stderr, "{} checks failed\n", failures);
+        return EXIT_FAILURE;
+    }
+
+    fmt::print("all checks passed\n");
+    return EXIT_SUCCESS;
+}